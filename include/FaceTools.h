@@ -37,16 +37,35 @@ FaceTools_EXPORT Vec3f findNormal( const r3d::KDTree&,
 // Return the point closest to v on the surface of the model.
 FaceTools_EXPORT Vec3f toSurface( const r3d::KDTree&, const Vec3f& v);
 
+// Batched version of toSurface setting in spts the points closest to pts on the surface of the model.
+// If fids is not null, it is set with the ids of the faces the surface points are in. A single surface
+// point finder is shared for the batch and large batches are split across threads. The vectors pts
+// and spts can be the same vector.
+FaceTools_EXPORT void toSurface( const r3d::KDTree&, const std::vector<Vec3f> &pts,
+                                 std::vector<Vec3f> &spts, std::vector<int> *fids=nullptr);
+
 // Sets dv on the model surface of dst to be the barycentrically mapped position of sv through
 // model src via their underlying coregistration masks which MUST EXIST AND BE THE SAME!
 // Returns the squared difference between sv and it's closest position on the source mask.
 FaceTools_EXPORT float barycentricMapSrcToDst( const FM *src, Vec3f sv, const FM *dst, Vec3f &dv);
 
+// Batched version of barycentricMapSrcToDst setting the mapped positions of svs in dvs.
+FaceTools_EXPORT void barycentricMapSrcToDst( const FM *src, const std::vector<Vec3f> &svs,
+                                              const FM *dst, std::vector<Vec3f> &dvs);
+
+// Call fn over the index range [0,n) split into contiguous blocks of at least minBlock indices
+// with the blocks executed concurrently on the WorkerPool and the calling thread (which also
+// takes blocks so it's safe to call from work running on the pool). Blocks until all have finished.
+// Function fn is passed the beginning and one past the end index of the block to process.
+FaceTools_EXPORT void parallelFor( size_t n, const std::function<void( size_t, size_t)> &fn, size_t minBlock=1);
+
 // Starting at the point on the surface closest to s, return the point on the surface closest to t.
 FaceTools_EXPORT Vec3f toTarget( const r3d::KDTree&, const Vec3f& s, const Vec3f& t);
 
-FaceTools_EXPORT bool findPath( const r3d::KDTree&, const Vec3f& p0, const Vec3f& p1, std::list<Vec3f>& pts);
-FaceTools_EXPORT bool findSlicedPath( const r3d::KDTree&, const Vec3f& p0, const Vec3f& p1, const Vec3f& u, std::list<Vec3f>&);
+// Find a curve over the surface between p0 and p1. The forward and reverse searches are
+// run concurrently and the shorter path is set in pts (always ordered from p0 to p1).
+FaceTools_EXPORT bool findPath( const r3d::KDTree&, const Vec3f& p0, const Vec3f& p1, std::vector<Vec3f>& pts);
+FaceTools_EXPORT bool findSlicedPath( const r3d::KDTree&, const Vec3f& p0, const Vec3f& p1, const Vec3f& u, std::vector<Vec3f>&);
 
 // Calculate cropping radius for a face as G times the distance from the face centre to the point halfway between the eyes.
 FaceTools_EXPORT float calcFaceCropRadius( const Vec3f& faceCentre, const Vec3f& leye, const Vec3f& reye, float G);
@@ -35,8 +35,12 @@ protected:
     void doAction( Event) override;
     Event doAfterAction( Event) override;
 
+private slots:
+    void _closeWhenFinished();
+
 private:
     Event _ev;
+    FM *_closing;   // Model waiting on its cancelled jobs to finish before closing
 };  // end class
 
 }}   // end namespaces
@@ -34,6 +34,12 @@ protected:
     bool doBeforeAction( Event) override;
     void doAction( Event) override;
     Event doAfterAction( Event) override;
+
+private slots:
+    void _closeWhenFinished();
+
+private:
+    bool _closing;  // True while waiting on cancelled jobs to finish before closing
 };  // end class
 
 }}   // end namespace
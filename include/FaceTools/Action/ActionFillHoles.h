@@ -29,6 +29,12 @@ public:
 
     QString toolTip() const override { return "Find and fill holes in the surface of the selected model.";}
 
+    // Return a copy of the given mesh with the holes in each of its manifolds filled. If parallel,
+    // the holes of each manifold are filled concurrently in separate meshes (re-parsing just the
+    // manifold between passes) before the added polygons are merged into the copy in manifold order.
+    // Otherwise, holes are filled one at a time in the copy with all manifolds re-parsed after each pass.
+    static r3d::Mesh::Ptr fillHoles( const r3d::Mesh&, const r3d::Manifolds&, bool parallel=true);
+
 protected:
     bool isAllowed( Event) override;
     bool doBeforeAction( Event) override;
@@ -33,6 +33,9 @@ public:
     // The absolute value of the returned value gives the number of faces fixed (vertex ordering reversed).
     // If the returned value is negative, then some manifold on the mesh was found to be twisted
     // (e.g. like a mobious strip) and a mesh wide consistent ordering of face normals was not possible.
+    // Manifolds are checked concurrently (see NormalConsistency for checking without fixing) with
+    // the model locked for reading, and the model is only locked for writing to set the fixed mesh
+    // (checking again if the model's mesh was replaced while checking).
     static int fixNormals( FM*);
 
 protected:
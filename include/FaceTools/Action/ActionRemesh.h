@@ -27,16 +27,27 @@ class FaceTools_EXPORT ActionRemesh : public FaceAction
 public:
     ActionRemesh( const QString&, const QIcon&);
 
-    float maxTriangleArea() const { return _maxtarea;}
+    QString toolTip() const override { return "Subdivide the surface so that no triangle is larger than a maximum area.";}
 
-protected slots:
+    void setMaxTriangleArea( float a) { _maxtarea = std::max( a, 0.01f);}
+    float maxTriangleArea() const { return _maxtarea;}  // Default is 2.0
+
+    // Return a copy of the given mesh with its triangles subdivided until none has an area greater
+    // than maxTriangleArea. Edges longer than the side of an equilateral triangle with this area are
+    // split at their midpoints so every face sharing an edge splits it the same way. If parallel,
+    // faces are partitioned spatially and the partitions subdivided concurrently before the new
+    // vertices along the seams are merged. Faces are output in the same order either way.
+    static r3d::Mesh::Ptr remesh( const r3d::Mesh&, float maxTriangleArea, bool parallel=true);
+
+protected:
     bool isAllowed( Event) override;
     bool doBeforeAction( Event) override;
     void doAction( Event) override;
-    Event doAfterAction() override;
+    Event doAfterAction( Event) override;
 
 private:
     float _maxtarea;
+    bool _swapped;
     Event _ev;
 };  // end class
 
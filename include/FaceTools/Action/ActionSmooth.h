@@ -29,12 +29,24 @@ public:
 
     QString toolTip() const override { return "Smooth surface geometry to reduce curvature at vertices.";}
 
+    // The curvature above which vertices are moved is the absolute mean curvature
+    // estimated from the positions of each vertex's neighbours (so vertices are moved
+    // where the surface bends more tightly than a sphere of radius 1/c). This is not
+    // the curvature held in FaceModelCurvatureStore (which isn't needed to smooth);
+    // test/testSmooth compares the results with those of r3d::Smoother given the
+    // same threshold. Clamped to [0,1].
     static void setMaxCurvature( double c);
     static double maxCurvature() { return s_maxc;}  // Default is 1.0
 
     static void setMaxIterations( size_t i);
     static size_t maxIterations() { return s_maxi;} // Default is 1
 
+    // Smooth the given mesh (having sequential ids) in place over multiple threads,
+    // stopping early if no vertex has curvature above maxc. Only vertices with curvature above
+    // maxc are moved, and curvature is recalculated for just these and their neighbours each
+    // iteration. Returns the number of iterations done.
+    static size_t smooth( r3d::Mesh&, double maxc, size_t maxi);
+
 protected:
     bool isAllowed( Event) override;
     bool doBeforeAction( Event) override;
@@ -47,6 +59,7 @@ private:
     static double s_maxc;
     static size_t s_maxi;
     Event _ev;
+    size_t _nits;
 };  // end class
 
 }}   // end namespaces
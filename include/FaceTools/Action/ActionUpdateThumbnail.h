@@ -41,6 +41,18 @@ public:
     // The mesh must have the same geometry (or at least the same face IDs) for assigning normals.
     static QImage generateImage( const FM*, const r3d::Mesh&, const QSize&, float fov=30, float dscale=1.0f);
 
+    // An image to generate of the given model's mesh or of another mesh (as above).
+    struct ImageRequest
+    {
+        const FM *fm;
+        const r3d::Mesh *mesh;
+        QSize size;
+    };  // end struct
+
+    // Generate the requested images (in order) as a single batch on the offscreen render thread.
+    // The models and meshes must not be changed until this returns.
+    static std::vector<QImage> generateImages( const std::vector<ImageRequest>&, float fov=30, float dscale=1.0f);
+
 signals:
     // Emitted whenever a new thumbnail generated for the given model.
     void updated( const FM*);
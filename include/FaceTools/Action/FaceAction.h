@@ -99,6 +99,14 @@ public:
      */
     bool isWorking() const { return _isWorking;}
 
+    /**
+     * Returns true if this action is currently working on the given model (the model
+     * that was selected when the action was executed). An action works on at most one
+     * model at a time since the state of a run is held by the action itself, so
+     * FaceActionManager defers triggering it for other models until it finishes.
+     */
+    bool isWorking( const FM *fm) const { return _isWorking && _workModel == fm;}
+
     /**
      * Some actions may need the mouse position at time of actioning. This may be different from the
      * mouse position during the call to doBeforeAction since the action can be executed by a variety
@@ -168,8 +176,9 @@ public slots:
     void refresh( Event e=Event::NONE);
 
     /**
-     * For asynchronous actions, this function is called if the action times out.
-     * The action should stop what it's doing and finish immediately.
+     * For asynchronous actions, this function is called (in the GUI thread) if the action is
+     * cancelled while doAction is running. The action should stop what it's doing and finish
+     * immediately.
      */
     virtual void endNow();
 
@@ -228,6 +237,13 @@ protected:
      */
     virtual void doAction( Event){}
 
+    /**
+     * Returns true if the running asynchronous job for this action has been cancelled.
+     * Long running implementations of doAction can poll this to finish early. It can
+     * also be checked in doAfterAction (which is still called) to report the cancellation.
+     */
+    bool isCancelled() const;
+
     /**
      * Called within the GUI thread immediately on the completion of doAction. This is where GUI
      * elements (dialogs etc) shown in doBeforeAction should be hidden or rendering updates made.
@@ -262,6 +278,7 @@ protected:
 
 private slots:
     void _endExecute( Event);
+    void _cancelExecute();
 
 private:
     QAction _action;
@@ -271,7 +288,8 @@ private:
     const QKeySequence _keys;
     bool _doasync;
     bool _isWorking;
-    int _key;
+    const FM *_workModel;   // The model being worked on if working
+    FaceActionWorker *_job;    // The running asynchronous job (if any)
     bool _unlocked; // If true, this action is enabled (true by default)
     Event _pevents; // Purge events
     Event _tevents; // Trigger events
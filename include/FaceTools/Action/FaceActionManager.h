@@ -19,6 +19,7 @@
 #define FACE_TOOLS_FACE_ACTION_MANAGER_H
 
 #include "FaceAction.h"
+#include <array>
 
 /**
  * IMPORTANT:
@@ -41,9 +42,21 @@ public:
     // Call after all actions have been registered.
     static void finalise();
 
-    // Raise the given event (always raised in the GUI thread).
+    // Raise the given event (always raised in the GUI thread). Events raised from the GUI thread
+    // are handled before this returns except for repeats of an event (from the same source and for the same model) that
+    // was already handled in the current iteration of the event loop. Such repeats are coalesced
+    // and handled once on the next iteration so that bursts of the same event are handled twice
+    // at most rather than every time. Events raised while handling another are never deferred.
     static void raise( Event);
 
+    // Dispatch statistics summed over the flags of the given event (pass Event::NONE for the
+    // count of events without flags). Raised counts are taken before coalescing and dispatched
+    // counts after. Dispatch times are in milliseconds and include the time of nested dispatches.
+    static size_t raisedCount( Event);
+    static size_t dispatchedCount( Event);
+    static double dispatchTime( Event);
+    static void resetDispatchStats();
+
     static Vis::FV* close( const FM*);
 
     static FaceActionManager* get();    // For connecting to signals
@@ -54,15 +67,55 @@ signals:
     void _selfRaise( Event);
 
 private slots:
-    void _doRaise( Event e=Event::NONE);
+    void _onRaise( Event);
+    void _flush();
 
 private:
     static FaceActionManager::Ptr s_singleton;
     std::vector<FaceAction*> _actions; // Actions in registered order
 
+    // Actions to purge and actions to respond (true if triggered else refreshed) to an event
+    // in registered order. Found from the actions' event masks the first time an event is raised.
+    struct Dispatch
+    {
+        std::vector<FaceAction*> purgers;
+        std::vector<std::pair<FaceAction*, bool> > responders;
+    };  // end struct
+    std::unordered_map<uint32_t, Dispatch> _dispatches;
+
+    struct Raised
+    {
+        FaceAction *sender;
+        FM *fm;     // Model selected (or bound) when raised
+        Event event;
+    };  // end struct
+    std::vector<Raised> _dispatched;   // Handled immediately since the last flush
+    std::vector<Raised> _pending;      // Repeats of those to handle on the next flush
+    bool _flushQueued;
+
+    struct Deferred
+    {
+        FaceAction *action;
+        FM *fm;     // Model the action was to be triggered for
+        Event event;
+    };  // end struct
+    std::vector<Deferred> _deferred;  // Triggers of actions busy on other models
+
+    static const size_t NSTATS = 33;    // Events without flags and one per flag
+    std::array<size_t, NSTATS> _nraised;
+    std::array<size_t, NSTATS> _ndispatched;
+    std::array<double, NSTATS> _msecs;
+
     int _lvl;
     std::unordered_map<FaceAction*, Event> _acted;
 
+    const Dispatch& _dispatch( Event);
+    void _dispatchFor( FaceAction*, FM*, Event);
+    void _doRaise( FaceAction*, Event);
+    void _defer( FaceAction*, FM*, Event);
+    void _runDeferred();
+    void _queueFlush();
+
     FaceActionManager();
     FaceActionManager( const FaceActionManager&) = delete;
     void operator=( const FaceActionManager&) = delete;
@@ -18,44 +18,79 @@
 #ifndef FACE_TOOLS_ACTION_FACE_ACTION_WORKER_H
 #define FACE_TOOLS_ACTION_FACE_ACTION_WORKER_H
 
-#include <FaceTools/FaceTypes.h>
+/**
+ * Runs an asynchronous FaceAction as a job on the shared WorkerPool. Jobs for user instigated
+ * actions have priority over jobs for actions triggered by other events. Each job is bound to
+ * the model selected when the job was created (see ModelSelect::bindSelected). Jobs on the
+ * same model run one at a time in the order they were started while jobs of different actions
+ * on different models run concurrently. An action keeps the state of its run (its work model
+ * and results) in its own members so it has at most one job at a time. Executing an action that
+ * is already working on another model is deferred until its job finishes (see FaceActionManager)
+ * so running one action on several models still runs it on each in turn. The progress of jobs
+ * is shown in the status bar alongside a button to cancel them. The times jobs spend queued on
+ * the pool are available from WorkerPool.
+ */
+
+#include <FaceTools/WorkerPool.h>
+#include <QToolButton>
 #include <QTimer>
-#include <QThread>
 #include <QMutex>
+#include <atomic>
+#include <list>
 
 namespace FaceTools { namespace Action {
 
 class FaceAction;
 
-class FaceTools_EXPORT FaceActionWorker : public QThread
+class FaceTools_EXPORT FaceActionWorker : public QObject
 { Q_OBJECT
 public:
     FaceActionWorker( FaceAction*, Event);
-    virtual ~FaceActionWorker();
+    ~FaceActionWorker() override;
 
-    // True if at least one user instigated worker is active
-    static bool isUserWorking() { return _s_userWorkCount > 0;}
+    // Schedule this job to run once all previously started jobs on its model have finished.
+    void start();
 
-signals:
-    void onWorkFinished( Event);
+    // Returns the model this job is bound to (may be null).
+    FM* model() const { return _fm;}
+
+    // Cancel this job. If not yet started, the action's doAction is never called and onWorkCancelled
+    // is emitted instead of onWorkFinished. If running, the action's endNow function is called and
+    // isCancelled returns true, but it's up to the action to finish early.
+    void cancel();
+    bool isCancelled() const { return _token->isCancelled();}
 
-protected:
-    void run() override;
+    // Cancel all jobs (or just those on the given model).
+    static void cancel( const FM*);
 
-private slots:
-    void _doOnTimerInterval();
+    // True if at least one user instigated job is scheduled or running.
+    static bool isUserWorking();
+
+    // True if any jobs are scheduled or running (on the given model if not null).
+    static bool isWorking( const FM *fm=nullptr);
+
+signals:
+    void onWorkFinished( Event);
+    void onWorkCancelled();
 
 private:
     FaceAction* _worker;
     Event _event;
-    QTimer *_timer;
-    int _tcount;
-    QString _status;
+    FM *_fm;
+    QString _name;
+    bool _started;  // Set when submitted to the pool
+    WorkerPool::Priority _priority;
+    WorkerPool::Token::Ptr _token;
+    std::atomic<qint64> _startTime; // Msecs since epoch when run started (zero if waiting, negative once finished)
 
-    static int _s_userWorkCount;
-    static QMutex _s_mutex;
+    static QMutex _s_mutex;  // Guards the below
+    static std::list<FaceActionWorker*> _s_jobs; // In the order started
+    static QTimer *_s_timer;
+    static QToolButton *_s_cancel;  // Status bar button to cancel all jobs
 
-    void _deleteTimer();
+    void _run();
+    void _submit();
+    static void _showStatus();
 };  // end class
 
 }}   // end namespace
@@ -32,6 +32,10 @@ public:
 
     void restore( const Event&) const;   // Called by UndoState
 
+    // Estimated memory retained by this state (data shared with the model and
+    // other states is divided between them).
+    size_t bytes() const;
+
 private:
     FM *_fm;
     bool _metaSaved;
@@ -28,7 +28,7 @@ class UndoStates;
  * Called by an action at the end of FaceAction::doBeforeAction if desiring undo functionality.
  */
 FaceTools_EXPORT void storeUndo( const FaceAction*, Event, bool autoRestore=true);
-FaceTools_EXPORT void scrapLastUndo( const FM*);
+FaceTools_EXPORT void scrapLastUndo( const FM*, const FaceAction *a=nullptr);
 
 
 class FaceTools_EXPORT UndoState
@@ -51,6 +51,10 @@ public:
     void setName( const QString& nm) { _name = nm;}
     inline const QString& name() const { return _name;}
 
+    // Estimated memory retained by the auto restore states (user data is not included).
+    // Estimated once on creation so the same value is always returned for running totals.
+    inline size_t bytes() const { return _nbytes;}
+
 private:
     FaceAction* _action;
     Event _egrp;
@@ -59,6 +63,7 @@ private:
     FM *_sfm;
     std::vector<FaceModelState::Ptr> _fstates;  // The auto restore states (if being used)
     QMap<QString, QVariant> _udata; // The manually set state (if being used)
+    size_t _nbytes;
 
     UndoState( const FaceAction*, Event, bool);
     UndoState( const UndoState&) = delete;
@@ -30,6 +30,15 @@ public:
     // Undo/redo states per model cannot exceeed MAX_RESTORES.
     static const size_t MAX_RESTORES = 30;
 
+    // Set/get the estimated memory ceiling (in bytes) for all undo/redo states.
+    // Oldest undos are discarded from the models using the most memory to keep
+    // under this ceiling, but the most recent undo for a model is always kept.
+    static void setMaxBytes( size_t);
+    static size_t maxBytes() { return s_maxBytes;}
+
+    // Return the estimated memory currently retained by all undo/redo states.
+    static size_t bytes();
+
     // Clear the undo/redo stacks for the given model (should happen on save/close).
     static void clear( const FM*);
     static void clear();    // Clear all undo/redos
@@ -39,8 +48,10 @@ public:
 
     // After storing an undo, scrap it (last one stored only) by specifying the associated model.
     // Can be helpful if needing to carry out a potential write action which doesn't end up
-    // changing the model (so don't want to undo to a non-modified state).
-    static void scrapLastUndo( const FM*);
+    // changing the model (so don't want to undo to a non-modified state). If an action is
+    // given, the last undo is only scrapped if stored by that action (asynchronous actions
+    // may have had their undo undone or followed by others by the time they finish).
+    static void scrapLastUndo( const FM*, const FaceAction *a=nullptr);
 
     static bool canUndo();
     static bool canRedo();
@@ -61,23 +72,29 @@ signals:
 
 private:
     static Ptr _singleton;
+    static size_t s_maxBytes;
 
     struct Stacks
     {
         std::deque<UndoState::Ptr> undos;
         std::deque<UndoState::Ptr> redos;
         std::deque<UndoState::Ptr> oldRedos;
+        size_t undoBytes = 0;   // Running totals of the states' bytes
+        size_t redoBytes = 0;
+        size_t oldRedoBytes = 0;
     };  // end struct
 
     // Undo stacks per model and also a null entry!
     std::unordered_map<const FM*, Stacks> _stacks;
 
     QReadWriteLock _mutex;
+    size_t _nbytes = 0; // Running total of bytes over all undo/redo stacks
 
     void _clear( const FM*);
     void _clear();
+    void _trimToMaxBytes();
     void _storeUndo( const FaceAction*, Event, bool);
-    void _scrapLastUndo( const FM*);
+    void _scrapLastUndo( const FM*, const FaceAction*);
     bool _canUndo( const FM*);
     bool _canRedo( const FM*);
     QString _undoActionName();
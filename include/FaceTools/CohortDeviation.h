@@ -0,0 +1,95 @@
+/************************************************************************
+ * Copyright (C) 2021 SIS Research Ltd & Richard Palmer
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ ************************************************************************/
+
+#ifndef FACE_TOOLS_COHORT_DEVIATION_H
+#define FACE_TOOLS_COHORT_DEVIATION_H
+
+/**
+ * Per vertex mean and variance of the registered masks of a cohort of models. Each mask is aligned
+ * to the first mask added by Procrustes superimposition and its vertices accumulated in a single
+ * streaming pass, so models (or 3DF files) only need to be held while being added. Masks can be
+ * added from multiple threads with only the accumulation itself serialised. Once finished, the
+ * deviation of any model with a matching mask is found per vertex as signed z-scores along the
+ * normals of the mean mask. Does not require a GUI.
+ */
+
+#include "FaceTypes.h"
+#include <r3d/Mesh.h>
+#include <QStringList>
+#include <QMutex>
+
+namespace FaceTools {
+
+class FaceTools_EXPORT CohortDeviation
+{
+public:
+    using Ptr = std::shared_ptr<CohortDeviation>;
+    static Ptr create();
+
+    // Add the mask of the given model returning false if the model has no mask or its
+    // mask doesn't match the masks already added. Can be called from multiple threads.
+    bool add( const FM&);
+
+    // Add the masks of the given models or the given 3DF files (concurrently if parallel) and
+    // return the number added. Files are read one per thread and discarded once added. Models or
+    // files are added in order until one is added before adding the rest, so the mask that the
+    // others are aligned to is always the first that can be added and doesn't depend on threading.
+    size_t add( const std::vector<const FM*>&, bool parallel=true);
+    size_t addFiles( const QStringList&, bool parallel=true);
+
+    // The number of masks added.
+    size_t count() const;
+
+    // Calculate the mean mask and the per vertex standard deviations along its normals from the
+    // masks added so far. Must be called after adding and before calling the functions below.
+    // Returns false if fewer than two masks have been added.
+    bool finish();
+
+    // The mean mask (in the frame of the first mask added).
+    inline const r3d::Mesh &meanMask() const { return *_mmask;}
+
+    // Standard deviation of the mask vertices along the normals of the mean mask.
+    inline const std::vector<float> &stddevs() const { return _sds;}
+
+    // Signed z-scores of the given model's mask vertices from the cohort mean along the normals
+    // of the mean mask. Positive values are outward. Returns an empty vector if the mask of the
+    // model doesn't match the cohort's. Vertices with no variance in the cohort are given zero.
+    std::vector<float> zscores( const FM&) const;
+
+private:
+    mutable QMutex _lock;
+    size_t _maskHash;
+    r3d::Mesh::Ptr _rmask;      // The first mask added
+    MatX3f _rvtxs;              // Vertex rows of the first mask added
+    size_t _n;
+    std::vector<Vec3d> _means;
+    std::vector<Eigen::Matrix3d> _comoments;
+    r3d::Mesh::Ptr _mmask;
+    MatX3f _mvtxs;              // Vertex rows of the mean mask
+    std::vector<Vec3f> _mnrms;  // Vertex normals of the mean mask
+    std::vector<float> _sds;
+
+    CohortDeviation();
+    bool _add( const r3d::Mesh&, size_t);
+    size_t _addAll( size_t, const std::function<bool( size_t)>&, bool);
+    CohortDeviation( const CohortDeviation&) = delete;
+    void operator=( const CohortDeviation&) = delete;
+};  // end class
+
+}   // end namespace
+
+#endif
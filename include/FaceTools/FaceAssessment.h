@@ -21,6 +21,7 @@
 #include "LndMrk/LandmarkSet.h"
 #include "Metric/MetricSet.h"
 #include "PathSet.h"
+#include <atomic>
 
 namespace FaceTools {
 
@@ -32,8 +33,16 @@ public:
 
     static Ptr create( int id);
 
+    // Landmarks, paths and metrics are shared copy-on-write so this copy is cheap.
+    // Both this assessment and the copy are marked as sharing their data, which is
+    // then copied by whichever of them first modifies it through editLandmarks,
+    // editPaths or metrics (only to be done while holding the model's write lock).
     Ptr deepCopy() const;
 
+    // Estimated memory used by this assessment's data. Data shared with other
+    // copies is split evenly between them so summing across copies is meaningful.
+    size_t bytes() const;
+
     void setId( int id) { _id = id;}
     int id() const { return _id;}
 
@@ -45,9 +54,9 @@ public:
     bool hasNotes() const { return !_notes.isEmpty();}
 
     bool setLandmarks( const Landmark::LandmarkSet&);
-    const Landmark::LandmarkSet& landmarks() const { return _landmarks;}
-    Landmark::LandmarkSet& landmarks() { return _landmarks;}
-    bool hasLandmarks() const { return !_landmarks.empty();}
+    const Landmark::LandmarkSet& landmarks() const { return *_landmarks;}
+    Landmark::LandmarkSet& editLandmarks();   // Copies the landmarks first if shared
+    bool hasLandmarks() const { return !_landmarks->empty();}
 
     // Add T onto the landmark and path sets, and provide the current inverse rotation matrix.
     void transform( const Mat4f &T, const Mat3f &iR);
@@ -55,12 +64,12 @@ public:
     // Resettle paths and landmarks so that they are incident with the given model's surface.
     void moveToSurface( const FM*);
 
-    const PathSet& paths() const { return _paths;}
-    PathSet& paths() { return _paths;}
+    const PathSet& paths() const { return *_paths;}
+    PathSet& editPaths();   // Copies the paths first if shared
     bool setPaths( const PathSet&);
-    bool hasPaths() const { return !_paths.empty();}
+    bool hasPaths() const { return !_paths->empty();}
 
-    Metric::MetricSet& metrics( FaceSide);
+    Metric::MetricSet& metrics( FaceSide);   // Copies the metric set first if shared
     const Metric::MetricSet& cmetrics( FaceSide) const; // Const versions (different name for use by Lua).
 
     // Is the metric with given ID recorded in this FaceAssessment?
@@ -75,15 +84,16 @@ private:
     int _id;
     QString _assessor;
     QString _notes;
-    Landmark::LandmarkSet _landmarks;
-    PathSet _paths;
-    Metric::MetricSet _metrics;
-    Metric::MetricSet _metricsL;
-    Metric::MetricSet _metricsR;
+    std::shared_ptr<Landmark::LandmarkSet> _landmarks;
+    std::shared_ptr<PathSet> _paths;
+    std::shared_ptr<Metric::MetricSet> _metrics;
+    std::shared_ptr<Metric::MetricSet> _metricsL;
+    std::shared_ptr<Metric::MetricSet> _metricsR;
+    mutable std::atomic<int> _shared;   // Flags for data possibly shared with copies
 
     explicit FaceAssessment( int);
-    FaceAssessment( const FaceAssessment&) = default;
-    FaceAssessment& operator=( const FaceAssessment&) = default;
+    FaceAssessment( const FaceAssessment&);
+    FaceAssessment& operator=( const FaceAssessment&) = delete;
 };  // end class
 
 }   // end namespace
@@ -56,6 +56,27 @@ public:
      */
     void update( r3d::Mesh::Ptr, bool updateConnectivity, bool settleLandmarks, int maxManifolds=-1);
 
+    /**
+     * Update with a new mesh having the same connectivity as the existing mesh (same vertex and
+     * face ids with faces joining the same vertices though possibly with reversed winding).
+     * Only vertex positions, the transform or face orientation may differ, so manifolds and
+     * their boundaries are kept and only the search tree and bounds are remade (concurrently).
+     * Debug builds assert that connectivity is unchanged. Calling update with updateConnectivity
+     * false is the same as calling this function.
+     * View actors should be rebuilt after calling this function.
+     */
+    void updateGeometry( r3d::Mesh::Ptr, bool settleLandmarks);
+
+    /**
+     * Keep only the manifolds with the given indices discarding all others. The faces of the kept
+     * manifolds are copied in a single pass (in manifold order) so the new mesh has no disconnected
+     * vertices and needs no repacking, and the number of manifolds it has is known in advance so
+     * none are reduced. The new mesh's manifolds are still parsed anew since r3d::Manifolds can only be
+     * made from a whole mesh. The transform is kept and landmarks and paths are moved to the remaining
+     * surface. View actors should be rebuilt after calling this function.
+     */
+    void keepManifolds( const IntSet&);
+
     /**
      * Convenience function for fixing the transform matrix and updating the internal mesh is changed.
      * Treat as update; view actors should be rebuilt after calling this function.
@@ -93,8 +114,11 @@ public:
     bool isAligned() const;
 
     r3d::Mesh::Ptr meshPtr() { return _mesh;}
+    std::shared_ptr<const r3d::Mesh> meshPtr() const { return _mesh;}
     const r3d::Mesh& mesh() const { return *_mesh;}
     const r3d::KDTree& kdtree() const { return *_kdtree;}
+    // The search tree can be shared for use without holding the model's lock (alongside meshPtr).
+    std::shared_ptr<const r3d::KDTree> kdtreePtr() const { return _kdtree;}
     const r3d::Manifolds& manifolds() const { return *_manifolds;}
     bool hasTexture() const { return _mesh->hasMaterials();}
 
@@ -307,6 +331,7 @@ private:
     r3d::KDTree::Ptr _kdtree;
 
     std::vector<r3d::Bounds::Ptr> _bnds;
+    bool _bndsShared;   // True if _bnds may be shared with saved undo states
 
     r3d::Mesh::Ptr _mask;
     r3d::KDTree::Ptr _mkdtree;
@@ -322,6 +347,7 @@ private:
     friend class Action::FaceModelState;
 
     bool _moveToSurface();
+    void _detachBounds();
     void _syncBoundsToAlignment();
     FaceModel( const FaceModel&) = delete;
     void operator=( const FaceModel&) = delete;
@@ -20,19 +20,30 @@
 
 #include "FaceModelCurvature.h"
 #include "FaceModel.h"
+#include "ModelCache.h"
 
 namespace FaceTools {
 
 class FaceTools_EXPORT FaceModelCurvatureStore
 {
 public:
-    using RPtr = std::shared_ptr<const FaceModelCurvature>;
-    using WPtr = std::shared_ptr<FaceModelCurvature>;
+    using Cache = ModelCache<FaceModelCurvature>;
+    using RPtr = Cache::RPtr;
+    using WPtr = Cache::WPtr;
 
     // Returns the curvature map for the given model or null if not available.
-    // Read lock is held while returned shared ptr is alive.
+    // Read lock is held while returned shared ptr is alive. Only models having
+    // their curvature written to at the time of calling will return null.
     static RPtr rvals( const FM&);
 
+    // Like rvals but if the curvature map is still being calculated for the
+    // given model, blocks until it is available.
+    static RPtr waitRvals( const FM&);
+
+    // Returns true iff the curvature map for the given model is available or
+    // is currently being calculated.
+    static bool has( const FM&);
+
     // Returns the curvature map for the given model or null if not available.
     // Write lock is held while returned shared ptr is alive.
     static WPtr wvals( const FM&);
@@ -44,8 +55,7 @@ public:
     static void add( const FM&);
 
 private:
-    static std::unordered_map<const FM*, FaceModelCurvature::Ptr> _metrics;
-    static QReadWriteLock _lock;
+    static Cache _cache;
 };  // end class
 
 }   // end namespace
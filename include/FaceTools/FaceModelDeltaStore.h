@@ -19,7 +19,7 @@
 #define FACE_TOOLS_FACE_MODEL_DELTA_STORE_H
 
 #include "FaceModelDelta.h"
-#include <QReadWriteLock>
+#include "ModelCache.h"
 
 namespace FaceTools {
 
@@ -28,22 +28,25 @@ using FMD = FaceModelDelta;
 class FaceTools_EXPORT FaceModelDeltaStore
 {
 public:
+    using Cache = ModelCache<FMD, ModelPair, ModelPairHash>;
+    using RPtr = Cache::RPtr;
+
     // Read lock is held while returned shared ptr is alive.
-    static std::shared_ptr<const FMD> vals( const FM *tgt, const FM *src);
+    static RPtr vals( const FM *tgt, const FM *src);
+
+    // Like vals but blocks until available if the delta is currently being calculated.
+    static RPtr waitVals( const FM *tgt, const FM *src);
 
     // Set the differences on tgt to be from src.
     static void add( const FM *tgt, const FM *src);
 
     static bool has( const FM *tgt, const FM *src);
 
-    // Purge associated deltas for the given model.
+    // Purge associated deltas for the given model (as either target or source).
     static void purge( const FM*);
 
 private:
-    static std::unordered_map<const FM*, std::unordered_map<const FM*, FMD::Ptr> > _t2s;
-    static std::unordered_map<const FM*, std::unordered_map<const FM*, FMD::Ptr> > _s2t;
-    static QReadWriteLock _lock;
-    static bool _has( const FM *tgt, const FM *src);
+    static Cache _cache;
 };  // end class
 
 }   // end namespace
@@ -19,22 +19,28 @@
 #define FACE_TOOLS_FACE_MODEL_SYMMETRY_STORE_H
 
 #include "FaceModelSymmetry.h"
-#include <QReadWriteLock>
+#include "ModelCache.h"
 
 namespace FaceTools {
 
 class FaceTools_EXPORT FaceModelSymmetryStore
 {
 public:
+    using Cache = ModelCache<FaceModelSymmetry>;
+    using RPtr = Cache::RPtr;
+
     // Read lock is held while returned shared ptr is alive.
-    static std::shared_ptr<const FaceModelSymmetry> vals( const FM*);
+    static RPtr vals( const FM*);
+
+    // Like vals but blocks until available if symmetry is currently being calculated.
+    static RPtr waitVals( const FM*);
+
     static bool isMapped( const FM*);
     static void add( const FM*);
     static void purge( const FM*);
 
 private:
-    static std::unordered_map<const FM*, FaceModelSymmetry::Ptr> _vtxSymm;
-    static QReadWriteLock _lock;
+    static Cache _cache;
 };  // end class
 
 }   // end namespace
@@ -25,6 +25,7 @@
 
 #include "ModelViewer.h"
 #include "FaceViewSet.h"
+#include <QElapsedTimer>
 
 namespace FaceTools {
 
@@ -32,6 +33,7 @@ class FaceTools_EXPORT FaceModelViewer : public ModelViewer
 { Q_OBJECT
 public:
     explicit FaceModelViewer( QWidget *parent=nullptr);
+    ~FaceModelViewer() override;
 
     bool attach( Vis::FV*); // Also makes the given view the selected one
     bool detach( Vis::FV*);
@@ -51,6 +53,20 @@ public:
     inline void setSelected( Vis::FV *fv) { _lastfv = fv;}
     inline Vis::FV *selected() const { return _lastfv;}
 
+    // Set the attached views to show their low detail proxies (e.g. while the camera
+    // is moving). Calls nest so the views show low detail until every call setting
+    // true has been matched by a call setting false. The proxies are only shown if
+    // the full detail frames timed since the attached views last changed were slow.
+    void setLowDetail( bool);
+    inline bool lowDetail() const { return _lowDetailCount > 0;}
+
+    // Frame rate telemetry: the number of frames and their mean render time (in
+    // milliseconds) with (true) or without (false) any view showing its proxy.
+    // Reset when views are attached or detached.
+    size_t frameCount( bool lowDetail) const;
+    double meanFrameTime( bool lowDetail) const;
+    void resetFrameTimes();
+
 signals:
     void toggleZeroArea( bool); // When going from positve to zero viewing area (true) and back (false).
     void onAttached( Vis::FV*);
@@ -63,6 +79,14 @@ private:
     FVS _attached;
     std::unordered_map<const FM*, Vis::FV*> _models;
     Vis::FV *_lastfv;
+    int _lowDetailCount;
+    bool _proxiesShown;
+    QElapsedTimer _frameTimer;
+    bool _frameLowDetail;
+    size_t _frameCounts[2];
+    double _frameTimes[2];
+    unsigned long _startTag, _endTag;
+    static void _onRender( vtkObject*, unsigned long, void*, void*);
 };  // end class
 
 }   // end namespace
@@ -54,6 +54,7 @@ private:
     bool doLeftButtonDown() override;
     bool doLeftButtonUp() override;
     bool doLeftDrag() override;
+    bool doMouseMove() override;
 
     Vis::LandmarksVisualisation _vis;
     int _hoverId;
@@ -20,6 +20,7 @@
 
 #include "GizmoHandler.h"
 #include <FaceTools/Vis/PathSetVisualisation.h>
+#include <FaceTools/WorkerPool.h>
 
 namespace FaceTools { namespace Interactor {
 
@@ -62,12 +63,57 @@ private:
 
     Vis::PathSetVisualisation _vis;
 
+    // Spatial hash of the positions a dragged handle can snap to (the handles of
+    // other paths and visible landmarks) so snapping doesn't scan them all.
+    class SnapIndex
+    {
+    public:
+        SnapIndex();
+        // Index the handles of all paths on the model except pid, and the visible landmarks if withLandmarks.
+        void build( const FM*, int pid, bool withLandmarks);
+        void clear();
+        bool isFor( const FM *fm, int pid, bool withLandmarks) const
+        {
+            return fm == _fm && pid == _pid && withLandmarks == _withLmks;
+        }   // end isFor
+
+        // Set v to the closest indexed path handle / landmark within the given squared
+        // distance (which must not exceed CELL_SIZE squared) returning true iff snapped.
+        bool snapToHandle( Vec3f &v, float sqRange) const { return _snap( _handles, v, sqRange);}
+        bool snapToLandmark( Vec3f &v, float sqRange) const { return _snap( _lmks, v, sqRange);}
+
+        static const float CELL_SIZE;
+
+    private:
+        using Grid = std::unordered_map<int64_t, std::vector<Vec3f> >;
+        const FM *_fm;
+        int _pid;
+        bool _withLmks;
+        Grid _handles;
+        Grid _lmks;
+        static int64_t _key( int, int, int);
+        static void _add( Grid&, const Vec3f&);
+        static bool _snap( const Grid&, Vec3f&, float);
+    };  // end class
+
     Vis::PathView::Handle *_handle;
     bool _dragging;
     bool _initPlacement;
+    mutable SnapIndex _snaps;
+    WorkerPool::Token::Ptr _pathTok;
+    int _pathGen;       // Incremented for every new surface path search
+    bool _pathPending;  // True while a surface path search is outstanding
+    bool _pathBusy;     // True while a search is queued on or running in the pool
+    std::pair<FM*, int> _pathNext;  // Model and path to search for when the running search finishes
+    Mat4f _pathTmat;    // Model transform when the running search started
 
     void _snapHandle( const Vis::FV*, Vec3f&) const;
     bool _execLeftDrag();
+    void _findPathAsync( FM*, int pid);
+    void _startSearch( FM*, int pid);
+    void _onPathFound( FM*, int gen, const Path&);
+    void _finishPath();
+    void _refreshPath( FM*, int pid);
     void _showPathInfo();
     void _updateCaption();
 
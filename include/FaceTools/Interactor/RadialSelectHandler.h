@@ -20,7 +20,7 @@
 
 #include "GizmoHandler.h"
 #include <FaceTools/Vis/RadialSelectVisualisation.h>
-#include <r3d/RegionSelector.h>
+#include <FaceTools/RadialRegion.h>
 #include <r3d/Boundaries.h>
 
 namespace FaceTools { namespace Interactor {
@@ -45,7 +45,7 @@ public:
     Vec3f centre() const;   // Returns transformed point
 
     // Size of selected face ID set will always be >= 1 if initialised.
-    const IntSet& selectedFaces() const { return _fids;}
+    const IntSet& selectedFaces() const;
     const std::list<int> &boundaryVertices() const;
 
 private:
@@ -64,9 +64,8 @@ private:
     bool _onReticule;
     bool _moving;
     float _radiusChange;
-    IntSet _fids;           // The currently selected facets
-    r3d::Boundaries _bnds;  // And corresponding boundary vertices
-    r3d::RegionSelector::Ptr _rsel;
+    r3d::Boundaries _bnds;  // Boundary vertices of the selected faces
+    RadialRegion::Ptr _rsel;
 
     void _update( Vec3f, float);
     void _showHover();
@@ -31,7 +31,7 @@ using PTree = boost::property_tree::ptree;
 class FaceTools_EXPORT LandmarkSet
 {
 public:
-    LandmarkSet(){}
+    LandmarkSet() : _size(0) {}
     LandmarkSet( const LandmarkSet&) = default;
     LandmarkSet& operator=( const LandmarkSet&) = default;
 
@@ -48,8 +48,8 @@ public:
     bool set( int id, const Vec3f&, FaceSide=MID);
     bool set( const QString& code, const Vec3f&, FaceSide=MID);
 
-    // Return the full set of landmarks for one lateral.
-    const std::unordered_map<int, Vec3f>& lateral( FaceSide) const;
+    // Return the full set of landmarks for one lateral keyed by landmark id.
+    std::unordered_map<int, Vec3f> lateral( FaceSide) const;
 
     // Return the position of the landmark for the given lateral.
     // The FACE_LATERAL_MEDIAL constant does not need to be specified if the
@@ -112,7 +112,7 @@ public:
     bool has( const SpecificLandmark&) const;
 
     // Set size tests
-    size_t size() const { return _lmksL.size() + _lmksM.size() + _lmksR.size();}
+    size_t size() const { return _size;}
     bool empty() const { return _ids.empty();}
 
     // Returns false if content could not be read in.
@@ -123,13 +123,21 @@ public:
 
 private:
     IntSet _ids;
+    size_t _size;
 
-    using LDMRKS = std::unordered_map<int, Vec3f>;
+    // Positions are stored densely with one entry per landmark slot (see LandmarksManager::slot)
+    // and a per slot bitmask of the FaceSide laterals present. Each lateral is contiguous in
+    // memory so it can be treated as a 3xN matrix for vectorised operations.
+    using LDMRKS = std::vector<Vec3f>;
+    std::vector<uint8_t> _lats;
     LDMRKS _lmksL;  // Subject's left side
     LDMRKS _lmksM;  // Middle
     LDMRKS _lmksR;  // Subject's right side
 
     LDMRKS& _lateral( FaceSide);
+    const LDMRKS& _clateral( FaceSide) const;
+    bool _has( int slot, FaceSide lat) const { return (_lats[size_t(slot)] & lat) != 0;}
+    void _reserveSlots( size_t);
     bool _readLateral( const PTree&, FaceSide);
     Vec3f _quarter0() const;
     Vec3f _quarter1() const;
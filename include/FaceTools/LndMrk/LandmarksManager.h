@@ -64,6 +64,17 @@ public:
     // Returns just the IDs of the medial landmarks.
     static const IntSet& medialIds() { return _mids;}
 
+    // Every landmark is assigned a fixed storage slot in [0,count()) on load so that
+    // per landmark data can be stored densely (see LandmarkSet). Returns the slot for
+    // the landmark with the given id or -1 if the landmark doesn't exist.
+    static int slot( int id) { return id >= 0 && size_t(id) < _slots.size() ? _slots[size_t(id)] : -1;}
+
+    // Returns the id of the landmark in the given slot.
+    static int slotId( int s) { return _slotIds[size_t(s)];}
+
+    // Returns true iff the landmark in the given slot is bilateral.
+    static bool isBilateralSlot( int s) { return _bslots[size_t(s)];}
+
     // Return reference to the landmark with given id or null if doesn't exist.
     static Landmark* landmark( int id) { return _lmks.count(id) > 0 ? &_lmks.at(id) : nullptr;}
 
@@ -94,6 +105,9 @@ private:
     static IntSet _mset;
     static IntSet _bset;
     static IntSet _tset;
+    static std::vector<int> _slots;                 // Landmark slots indexed by id
+    static std::vector<int> _slotIds;               // Landmark ids indexed by slot
+    static std::vector<bool> _bslots;               // Bilateral flags indexed by slot
     static void _initAlignmentSets();
 };  // end class
 
@@ -20,6 +20,7 @@
 
 #include "GrowthData.h"
 #include <FaceTools/FaceModel.h>
+#include <FaceTools/ModelCache.h>
 
 namespace FaceTools { namespace Metric {
 
@@ -31,7 +32,7 @@ public:
     static int load( const QString&);
 
     // Return the metric's stats for the given model or the default metric stats.
-    // Returned pointer holds a read lock on this class until destroyed.
+    // Returned pointer holds a read lock on the model's stats until destroyed.
     static RPtr stats( int mid, const FM*);
 
     // Update the stats to use for the given model - automatically choosing the best for it.
@@ -56,10 +57,9 @@ public:
 
 private:
     // Models to metric IDs and their associated growth data mappings.
-    static std::unordered_map<const FM*, std::unordered_map<int, const GrowthData*> > _modelGDs;
+    static ModelCache<std::unordered_map<int, const GrowthData*> > _modelGDs;
     static std::unordered_map<int, const GrowthData*> _metricGDs;
     static IntSet _metricDefaults;
-    static QReadWriteLock _lock;
 };  // end class
 
 }}   // end namespaces
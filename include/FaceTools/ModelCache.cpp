@@ -0,0 +1,221 @@
+/************************************************************************
+ * Copyright (C) 2022 SIS Research Ltd & Richard Palmer
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ ************************************************************************/
+
+template <typename T, typename K, typename H>
+ModelCache<T,K,H>::Entry::Entry() : future( promise.get_future().share()), isReady(false) {}
+
+
+template <typename T, typename K, typename H>
+void ModelCache<T,K,H>::Entry::makeReady()
+{
+    if ( !isReady.exchange(true))
+        promise.set_value();
+}   // end makeReady
+
+
+template <typename T, typename K, typename H>
+size_t ModelCache<T,K,H>::_shardIndex( const K &k)
+{
+    // Model pointers are aligned so discard the low bits before selecting the shard
+    const size_t h = H()(k);
+    return ((h >> 4) ^ (h >> 12)) % NSHARDS;
+}   // end _shardIndex
+
+
+template <typename T, typename K, typename H>
+typename ModelCache<T,K,H>::Shard &ModelCache<T,K,H>::_shard( const K &k)
+{
+    return _shards[_shardIndex(k)];
+}   // end _shard
+
+
+template <typename T, typename K, typename H>
+const typename ModelCache<T,K,H>::Shard &ModelCache<T,K,H>::_shard( const K &k) const
+{
+    return _shards[_shardIndex(k)];
+}   // end _shard
+
+
+template <typename T, typename K, typename H>
+typename ModelCache<T,K,H>::EntryPtr ModelCache<T,K,H>::_entry( const K &k) const
+{
+    const Shard &shard = _shard(k);
+    shard.lock.lockForRead();
+    const auto it = shard.entries.find(k);
+    EntryPtr entry = it != shard.entries.end() ? it->second : nullptr;
+    shard.lock.unlock();
+    return entry;
+}   // end _entry
+
+
+template <typename T, typename K, typename H>
+typename ModelCache<T,K,H>::EntryPtr ModelCache<T,K,H>::_getOrMakeEntry( const K &k)
+{
+    Shard &shard = _shard(k);
+    shard.lock.lockForWrite();
+    EntryPtr &entry = shard.entries[k];
+    if ( !entry)
+        entry = std::make_shared<Entry>();
+    EntryPtr rentry = entry;
+    shard.lock.unlock();
+    return rentry;
+}   // end _getOrMakeEntry
+
+
+template <typename T, typename K, typename H>
+typename ModelCache<T,K,H>::Ready ModelCache<T,K,H>::reserve( const K &k)
+{
+    return _getOrMakeEntry(k)->future;
+}   // end reserve
+
+
+template <typename T, typename K, typename H>
+void ModelCache<T,K,H>::set( const K &k, std::shared_ptr<T> data)
+{
+    EntryPtr entry = _getOrMakeEntry(k);
+    entry->lock.lockForWrite();
+    entry->data = data;
+    entry->lock.unlock();
+    entry->makeReady();
+}   // end set
+
+
+template <typename T, typename K, typename H>
+typename ModelCache<T,K,H>::RPtr ModelCache<T,K,H>::read( const K &k) const
+{
+    EntryPtr entry = _entry(k);
+    if ( !entry || !entry->isReady || !entry->lock.tryLockForRead())
+        return nullptr;
+    if ( !entry->data)
+    {
+        entry->lock.unlock();
+        return nullptr;
+    }   // end if
+    return RPtr( entry->data.get(), [entry]( const T*){ entry->lock.unlock();});
+}   // end read
+
+
+template <typename T, typename K, typename H>
+typename ModelCache<T,K,H>::RPtr ModelCache<T,K,H>::waitRead( const K &k) const
+{
+    EntryPtr entry = _entry(k);
+    if ( !entry)
+        return nullptr;
+    entry->future.wait();
+    entry->lock.lockForRead();
+    if ( !entry->data)
+    {
+        entry->lock.unlock();
+        return nullptr;
+    }   // end if
+    return RPtr( entry->data.get(), [entry]( const T*){ entry->lock.unlock();});
+}   // end waitRead
+
+
+template <typename T, typename K, typename H>
+typename ModelCache<T,K,H>::WPtr ModelCache<T,K,H>::write( const K &k)
+{
+    EntryPtr entry = _entry(k);
+    if ( !entry || !entry->isReady)
+        return nullptr;
+    entry->lock.lockForWrite();
+    if ( !entry->data)
+    {
+        entry->lock.unlock();
+        return nullptr;
+    }   // end if
+    return WPtr( entry->data.get(), [entry]( T*){ entry->lock.unlock();});
+}   // end write
+
+
+template <typename T, typename K, typename H>
+bool ModelCache<T,K,H>::has( const K &k) const { return _entry(k) != nullptr;}
+
+
+template <typename T, typename K, typename H>
+bool ModelCache<T,K,H>::isReady( const K &k) const
+{
+    EntryPtr entry = _entry(k);
+    return entry && entry->isReady;
+}   // end isReady
+
+
+template <typename T, typename K, typename H>
+typename ModelCache<T,K,H>::Ready ModelCache<T,K,H>::ready( const K &k) const
+{
+    EntryPtr entry = _entry(k);
+    return entry ? entry->future : Ready();
+}   // end ready
+
+
+template <typename T, typename K, typename H>
+std::shared_ptr<T> ModelCache<T,K,H>::purge( const K &k)
+{
+    Shard &shard = _shard(k);
+    shard.lock.lockForWrite();
+    EntryPtr entry;
+    const auto it = shard.entries.find(k);
+    if ( it != shard.entries.end())
+    {
+        entry = it->second;
+        shard.entries.erase(it);
+    }   // end if
+    shard.lock.unlock();
+
+    std::shared_ptr<T> data;
+    if ( entry)
+    {
+        entry->lock.lockForWrite();   // Wait for current readers and writers to finish
+        data = entry->data;
+        entry->lock.unlock();
+        entry->makeReady();
+    }   // end if
+    return data;
+}   // end purge
+
+
+template <typename T, typename K, typename H>
+void ModelCache<T,K,H>::purgeIf( const std::function<bool( const K&)> &pred)
+{
+    for ( Shard &shard : _shards)
+    {
+        std::vector<EntryPtr> purged;
+        shard.lock.lockForWrite();
+        for ( auto it = shard.entries.begin(); it != shard.entries.end();)
+        {
+            if ( pred( it->first))
+            {
+                purged.push_back( it->second);
+                it = shard.entries.erase(it);
+            }   // end if
+            else
+                ++it;
+        }   // end for
+        shard.lock.unlock();
+
+        for ( EntryPtr &entry : purged)
+        {
+            entry->lock.lockForWrite();
+            entry->lock.unlock();
+            entry->makeReady();
+        }   // end for
+    }   // end for
+}   // end purgeIf
+
+
+template <typename T, typename K, typename H>
+void ModelCache<T,K,H>::purgeAll() { purgeIf( []( const K&){ return true;});}
@@ -0,0 +1,143 @@
+/************************************************************************
+ * Copyright (C) 2022 SIS Research Ltd & Richard Palmer
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ ************************************************************************/
+
+#ifndef FACE_TOOLS_MODEL_CACHE_H
+#define FACE_TOOLS_MODEL_CACHE_H
+
+/**
+ * Concurrent cache of data keyed per model (or per pair of models).
+ * Keys are spread over a fixed number of shards, each with its own short-lived
+ * lock used only for lookup and insertion. Each entry has its own read/write
+ * lock so that reading or writing the data for one model never blocks access
+ * to the data of another model. Entries can be reserved before their data are
+ * ready so that callers can either poll (read returns null) or wait on the
+ * entry's readiness future.
+ */
+
+#include "FaceTypes.h"
+#include <QReadWriteLock>
+#include <future>
+#include <atomic>
+#include <array>
+
+namespace FaceTools {
+
+using ModelPair = std::pair<const FM*, const FM*>;
+
+struct ModelPairHash
+{
+    size_t operator()( const ModelPair &p) const
+    {
+        const size_t h0 = std::hash<const FM*>()( p.first);
+        return h0 ^ (std::hash<const FM*>()( p.second) + 0x9e3779b9 + (h0 << 6) + (h0 >> 2));
+    }   // end operator()
+};  // end struct
+
+
+template <typename T, typename K = const FM*, typename H = std::hash<K> >
+class ModelCache
+{
+public:
+    using RPtr = std::shared_ptr<const T>;
+    using WPtr = std::shared_ptr<T>;
+    using Ready = std::shared_future<void>;
+
+    ModelCache() = default;
+
+    // Reserve an entry for k to show that its data are being computed.
+    // Readers of the entry will get null until set is called, but can
+    // wait on the returned future. Reserving an existing entry does not
+    // affect it and its existing readiness future is returned.
+    Ready reserve( const K &k);
+
+    // Set the data for k, creating the entry if not already reserved and
+    // making the entry ready. Blocks while readers/writers of the entry's
+    // previous data are active but never blocks on other entries.
+    void set( const K &k, std::shared_ptr<T>);
+
+    // Returns the data for k or null if not present or not yet ready.
+    // Also returns null without blocking if the entry is being written to.
+    // The entry's read lock is held while the returned pointer is alive.
+    RPtr read( const K &k) const;
+
+    // Like read but if the entry is reserved, blocks until its data are
+    // ready and then blocks until no writers are active on the entry.
+    RPtr waitRead( const K &k) const;
+
+    // Returns the data for k or null if not present or not yet ready.
+    // Blocks until the entry's write lock is acquired and holds it while
+    // the returned pointer is alive.
+    WPtr write( const K &k);
+
+    // Returns true iff k has an entry (reserved or ready).
+    bool has( const K &k) const;
+
+    // Returns true iff k has an entry with its data ready.
+    bool isReady( const K &k) const;
+
+    // Returns the readiness future for k or an invalid future if no entry.
+    Ready ready( const K &k) const;
+
+    // Remove the entry for k returning its data (null if not present or not ready).
+    // Reserved entries are made ready (with null data) so that waiters are released.
+    // Readers holding the entry's data from before the purge keep it alive.
+    std::shared_ptr<T> purge( const K &k);
+
+    // Remove all entries for which the given predicate is true.
+    void purgeIf( const std::function<bool( const K&)>&);
+
+    // Remove all entries.
+    void purgeAll();
+
+private:
+    struct Entry
+    {
+        Entry();
+        void makeReady();
+        mutable QReadWriteLock lock;
+        std::shared_ptr<T> data;
+        std::promise<void> promise;
+        Ready future;
+        std::atomic<bool> isReady;
+    };  // end struct
+
+    using EntryPtr = std::shared_ptr<Entry>;
+
+    struct Shard
+    {
+        mutable QReadWriteLock lock;
+        std::unordered_map<K, EntryPtr, H> entries;
+    };  // end struct
+
+    static const size_t NSHARDS = 16;
+    std::array<Shard, NSHARDS> _shards;
+
+    static size_t _shardIndex( const K&);
+    Shard &_shard( const K&);
+    const Shard &_shard( const K&) const;
+    EntryPtr _entry( const K&) const;
+    EntryPtr _getOrMakeEntry( const K&);
+
+    ModelCache( const ModelCache&) = delete;
+    void operator=( const ModelCache&) = delete;
+};  // end class
+
+#include "ModelCache.cpp"
+
+}   // end namespace
+
+#endif
@@ -37,6 +37,7 @@ public:
 
     // Optionally set a statically accessible status bar for convenient access.
     static void setStatusBar( QStatusBar*);
+    static QStatusBar* statusBar();    // May be null
     static void showStatus( const QString&, int timeOutMilliSecs=0, bool repaintNow=false);    // No effect if status bar not set.
     static QString currentStatus();
     static void clearStatus();
@@ -87,6 +88,13 @@ public:
     // Set the view angle for all viewers.
     static void setViewAngle( double);
 
+    // For the calling thread only, the selected view is the selected view of the bound model
+    // if it is selected or its first view otherwise. Asynchronous actions bind the model that was
+    // selected when they were executed so they act upon it even if the user selects a different
+    // model while they're working. Returns the previously bound model. Pass null to unbind.
+    static FM* bindSelected( FM*);
+    static FM* boundModel();
+
     static Vis::FV* selectedView();
     static bool isViewSelected() { return selectedView() != nullptr;}
     static FM* selectedModel() { return selectedView() ? selectedView()->data() : nullptr;}
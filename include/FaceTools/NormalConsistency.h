@@ -0,0 +1,80 @@
+/************************************************************************
+ * Copyright (C) 2021 SIS Research Ltd & Richard Palmer
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ ************************************************************************/
+
+#ifndef FACE_TOOLS_NORMAL_CONSISTENCY_H
+#define FACE_TOOLS_NORMAL_CONSISTENCY_H
+
+/**
+ * Finds the faces of a mesh with vertex orderings (and so normals) inconsistent with the other
+ * faces on their manifold. The faces of each manifold are parsed outward from a starting face
+ * and the faces found to disagree with the smaller set are deemed inconsistent since there's no
+ * authoritative direction to start from. Manifolds are parsed concurrently. Does not require a
+ * GUI so can be used to screen meshes in batch.
+ */
+
+#include "FaceTypes.h"
+#include <vtkFloatArray.h>
+#include <r3d/Manifolds.h>
+
+namespace FaceTools {
+
+class FaceTools_EXPORT NormalConsistency
+{
+public:
+    // Per face values set in the cells array.
+    static const float CONSISTENT;      // 0
+    static const float INCONSISTENT;    // 1 (fixable by reversing the face)
+    static const float TWISTED;         // 2 (inconsistent but on a twisted manifold)
+
+    // Name of the cells array.
+    static const char *ARRAY_NAME;
+
+    // Check all manifolds of the mesh (concurrently if parallel). The boundaries
+    // of the manifolds should already have been calculated if parallel.
+    NormalConsistency( const r3d::Mesh&, const r3d::Manifolds&, bool parallel=true);
+
+    // Faces inconsistent with the other faces on their manifold where the manifold is
+    // not twisted, i.e. the faces to reverse to make the ordering consistent.
+    inline const IntSet &inconsistent() const { return _inconsistent;}
+
+    // Faces inconsistent with the other faces on twisted manifolds (e.g. like a mobius strip)
+    // for which no consistent ordering is possible. Shows where the twists are.
+    inline const IntSet &twistedFaces() const { return _twistedFaces;}
+
+    // Indices of the twisted manifolds.
+    inline const IntSet &twisted() const { return _twisted;}
+
+    // Returns true iff no inconsistencies were found.
+    inline bool isConsistent() const { return _inconsistent.empty() && _twistedFaces.empty();}
+
+    // Return a copy of the mesh with the inconsistent (but not twisted) faces reversed.
+    r3d::Mesh::Ptr fixed() const;
+
+    // Return the per face values (CONSISTENT, INCONSISTENT or TWISTED) indexed by
+    // face id for visualisation with scalar colour mapping. Requires sequential face ids.
+    vtkSmartPointer<vtkFloatArray> cellsArray() const;
+
+private:
+    const r3d::Mesh &_mesh;
+    IntSet _inconsistent;
+    IntSet _twistedFaces;
+    IntSet _twisted;
+};  // end class
+
+}   // end namespace
+
+#endif
@@ -26,6 +26,8 @@
 #include <boost/property_tree/ptree.hpp>
 using PTree = boost::property_tree::ptree;
 
+namespace r3d { class KDTree;}
+
 namespace FaceTools {
 
 class FaceTools_EXPORT Path
@@ -84,6 +86,13 @@ public:
     // Remember to call updateMeasures after calling this function and setting the depth handle!
     bool updatePath( const FM*);
 
+    // As above but finding the path over the given search tree (which mustn't change during the call).
+    bool updatePath( const r3d::KDTree&);
+
+    // Set the path to be the straight line between its endpoints. Cheap enough to use as
+    // a preview of the path while the surface path is being found with updatePath.
+    void setStraight();
+
     // After calling updatePath, or setting the depth handle, call this to update measurements.
     // The inverse rotation matrix is required to ensure angles are projected into the facial
     // planes irrespective of the model's current transform (rotation).
@@ -103,7 +112,7 @@ public:
     inline float depth() const { return _depth;}
 
     // Always at least of size 2.
-    inline const std::list<Vec3f>& pathVertices() const { return _vtxs;}
+    inline const std::vector<Vec3f>& pathVertices() const { return _vtxs;}
 
     void transform( const Mat4f&);
 
@@ -117,7 +126,7 @@ private:
     int _id;
     QString _name;          // Name of this path
     bool _validPath;        // True if path lies on surface
-    std::list<Vec3f> _vtxs; // The path vertices
+    std::vector<Vec3f> _vtxs;   // The path vertices
     float _elen;            // Euclidean distance
     float _slen;            // Surface distance
     float _area;            // Cross sectional area
@@ -0,0 +1,91 @@
+/************************************************************************
+ * Copyright (C) 2021 SIS Research Ltd & Richard Palmer
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ ************************************************************************/
+
+#ifndef FACE_TOOLS_RADIAL_REGION_H
+#define FACE_TOOLS_RADIAL_REGION_H
+
+/**
+ * Region of faces around a centre point on a mesh. A face is in the region if it's joined by edges
+ * to the centre face through faces having all their vertices within the radius of the centre point.
+ * Faces are found outward from the centre face in order of the furthest vertex distance seen along
+ * the way there, and this order is kept so that changing the radius only grows or shrinks the
+ * region by the faces that change membership. The region's boundary edges are kept in step with
+ * the faces added and removed. Moving the centre finds the region afresh.
+ */
+
+#include "FaceTypes.h"
+#include <queue>
+
+namespace FaceTools {
+
+class FaceTools_EXPORT RadialRegion
+{
+public:
+    using Ptr = std::shared_ptr<RadialRegion>;
+    static Ptr create( const r3d::Mesh&);
+
+    inline const r3d::Mesh &mesh() const { return _mesh;}
+
+    // Set the region around the given (transformed) point on the given face with the given radius.
+    // Only faces from the given set are parsed (all faces of the mesh if null) which must remain
+    // alive while this region uses it. If only the radius differs from the last update, the region
+    // is grown or shrunk incrementally. The centre face is always in the region.
+    void update( int cfid, const Vec3f &centre, float radius, const IntSet *fids=nullptr);
+
+    inline int centreFace() const { return _cfid;}
+    inline const Vec3f &centre() const { return _centre;}
+    inline float radius() const { return _radius;}
+
+    // The faces in the region.
+    inline const IntSet &faces() const { return _fids;}
+
+    // Ids of the edges on the boundary of the region.
+    inline const IntSet &boundaryEdges() const { return _bedges;}
+
+    // The number of faces added and removed by the last update.
+    inline size_t numChanged() const { return _nchanged;}
+
+private:
+    using Item = std::pair<float, int>;  // Distance to face and face id
+    const r3d::Mesh &_mesh;
+    const IntSet *_within;
+    int _cfid;
+    Vec3f _centre;
+    float _radius;
+    std::vector<Item> _order;   // Faces reached in nondecreasing order of distance
+    std::priority_queue<Item, std::vector<Item>, std::greater<Item> > _front;
+    IntSet _reached;            // Faces in _order
+    size_t _n;                  // Number of faces from the start of _order in the region
+    IntSet _fids;
+    std::unordered_map<int, int> _ecounts;  // Number of region faces on each edge
+    IntSet _bedges;
+    size_t _nchanged;
+
+    explicit RadialRegion( const r3d::Mesh&);
+    void _reset( int, const Vec3f&, const IntSet*);
+    bool _reachNext();
+    float _distance( int) const;
+    void _add( int);
+    void _remove( int);
+    void _countEdges( int, int);
+    RadialRegion( const RadialRegion&) = delete;
+    void operator=( const RadialRegion&) = delete;
+};  // end class
+
+}   // end namespace
+
+#endif
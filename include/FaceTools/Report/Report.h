@@ -32,6 +32,43 @@ public:
     using CPtr = std::shared_ptr<const Report>;
     static Ptr load( const QString& luascript);
 
+    // The Latex and the assets (images and U3D models) it refers to as set by setContent.
+    // Content is independent of the report so a report's content can be set for other
+    // models while previously set content is still being generated.
+    class FaceTools_EXPORT Content
+    {
+    public:
+        // Write the assets (concurrently) then make the PDF. Content instances
+        // can be generated concurrently. The models the content was set from
+        // must not be changed until this returns.
+        bool generate();
+
+        // Render and save the model images of the given contents as a single batch on the
+        // offscreen render thread rather than when each content is generated. Returns false
+        // if any image couldn't be saved (the content it's for then fails to generate).
+        static bool writeImages( const std::vector<Content*>&);
+
+        const QString &pdffile() const { return _pdffile;}
+        const QString &errorMsg() const { return _errMsg;}
+
+    private:
+        struct Image
+        {
+            const FM *fm;
+            std::shared_ptr<const r3d::Mesh> mesh;
+            QSize size;
+            QString path;
+        };  // end struct
+
+        std::unique_ptr<r3dio::LatexWriter> _ltxw;
+        std::vector<std::function<bool()> > _assets;
+        std::vector<Image> _images; // Model images still to be rendered
+        bool _imagesOk = true;
+        QString _pdffile;
+        QString _errMsg;
+        friend class Report;
+    };  // end class
+
     static void setLogoPath( const QString&);
     static void setHeaderAppName( const QString&);
     static void setVersionString( const QString&);
@@ -66,6 +103,13 @@ public:
     // If false is returned, the error message is retrieved using errorMsg().
     bool setContent();
 
+    // As setContent but for the given model(s) instead of the selected ones.
+    // The second model is ignored if this isn't a two model report.
+    bool setContent( const FM*, const FM *fm1=nullptr);
+
+    // Returns the content last set (null if not set).
+    std::shared_ptr<Content> content() const { return _content;}
+
     // Generate report returning true on success. If false is
     // returned, the error message is retrieved using errorMsg().
     bool generate();
@@ -87,7 +131,8 @@ private:
     sol::state _lua;
     sol::function _isAvailable;
     sol::function _setContent;
-    r3dio::LatexWriter *_ltxw;
+    std::shared_ptr<Content> _content;
+    r3dio::LatexWriter *_ltxw;  // The content's writer
     QString _pdffile;
     QString _errMsg;
     bool _validContent;
@@ -108,9 +153,9 @@ private:
     static bool _usingSVG();
     r3dio::Box _pageBox( const QRectF&) const;
     r3dio::Point _pagePoint( const Vec2f&) const;
-    std::string _writeModelBGImage( const QRectF&, const FM*, const r3d::Mesh&);
+    std::string _writeModelBGImage( const QRectF&, const FM*, std::shared_ptr<const r3d::Mesh>);
     std::string _writeModelBGImage( const QRectF&, const FM*);
-    bool _writeLatex();
+    bool _writeLatex( const FM*, const FM*);
     Report();
     ~Report() override;
     Report( const Report&) = delete;
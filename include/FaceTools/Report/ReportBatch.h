@@ -0,0 +1,68 @@
+/************************************************************************
+ * Copyright (C) 2021 SIS Research Ltd & Richard Palmer
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ ************************************************************************/
+
+#ifndef FACE_TOOLS_REPORT_REPORT_BATCH_H
+#define FACE_TOOLS_REPORT_REPORT_BATCH_H
+
+/**
+ * Generates many report PDFs with a bounded number generated at once. Report content is
+ * set in the GUI thread as reports are added. The model images of all the reports are
+ * then rendered as a single batch before the other assets (U3D models) and the PDF of
+ * each report are generated concurrently with those of other reports.
+ */
+
+#include "Report.h"
+
+namespace FaceTools { namespace Report {
+
+class FaceTools_EXPORT ReportBatch
+{
+public:
+    // At most maxJobs reports are generated at once (the number of cores if not positive).
+    explicit ReportBatch( int maxJobs=0);
+
+    // Set the content of the given report for the given model(s) and queue it for
+    // generation to the given PDF file. Must be called in the GUI thread. Returns false
+    // if the content couldn't be set (the reason is given by the report's errorMsg).
+    // The models must not be changed until generate returns.
+    bool add( Report::Ptr, const QString &pdffile, const FM*, const FM *fm1=nullptr);
+
+    // Return the number of queued reports.
+    size_t size() const { return _jobs.size();}
+
+    // Generate the queued reports and copy them to their PDF files blocking until all are
+    // finished. Returns the number of reports successfully generated and saved.
+    size_t generate();
+
+    // Returns the error message from generating the i-th report (empty if none).
+    const QString &errorMsg( size_t i) const { return _jobs.at(i).errMsg;}
+
+private:
+    struct Job
+    {
+        std::shared_ptr<Report::Content> content;
+        QString pdffile;
+        QString errMsg;
+    };  // end struct
+
+    const size_t _maxJobs;
+    std::vector<Job> _jobs;
+};  // end class
+
+}}  // end namespaces
+
+#endif
@@ -18,28 +18,38 @@
 #ifndef FACE_TOOLS_U3D_CACHE_H
 #define FACE_TOOLS_U3D_CACHE_H
 
+/**
+ * U3D exports of models for embedding in reports. Exports are content addressed, being
+ * stored under a hash of the exported mesh's geometry, texture coordinates, textures and
+ * transform, so an export is reused by any model (in this or a later session) having the
+ * same content. The total size of stored exports is capped with the least recently used
+ * exports (that aren't the current exports of models) removed first.
+ */
+
 #include "FaceTypes.h"
 #include "FaceModel.h"
+#include "ModelCache.h"
 #include <rimg/Colour.h>
-#include <QTemporaryDir>
-#include <QReadWriteLock>
+#include <QColor>
 
 namespace FaceTools {
 
 class FaceTools_EXPORT U3DCache
 {
 public:
-    using Filepath = std::shared_ptr<QString>;
+    using Filepath = std::shared_ptr<const QString>;
 
     // Returns the u3dfile for the given model if present or empty string if not found.
-    // While a filepath is held, no write updates can occur.
+    // While a filepath is held, no write updates can occur for the given model.
     static Filepath u3dfilepath( const FM&);
 
     // Returns true iff U3D model export is possible.
     static bool isAvailable();
 
     // Locks for write the export of the model to U3D and unlocks on return.
-    // Returns true iff model was updated in the cache successfully.
+    // Returns true iff model was updated in the cache successfully. Nothing is
+    // done if the model's mesh hasn't changed since last refreshed, and the mesh
+    // is only copied for export if no export of the same content is stored.
     static bool refresh( const FM&);
 
     static void purge( const FM&);
@@ -49,11 +59,21 @@ public:
     // generated copy of the model with the scalar texture on success.
     static r3d::Mesh::Ptr makeColourMappedU3D( const Vis::FV *fv, const QString &u3dfilepath);
 
+    // Set/get the directory exports are stored in. Defaults to the u3d
+    // subdirectory of the application's cache location.
+    static void setCacheDir( const QString&);
+    static QString cacheDir();
+
+    // Set/get the maximum total size in bytes of the stored exports (default 1 GB).
+    static void setMaxBytes( qint64);
+    static qint64 maxBytes();
+
 private:
-    static QTemporaryDir _tmpdir;
-    static QReadWriteLock _rwLock;
-    static std::unordered_map<const FM*, QString> _cache;
+    static ModelCache<QString> _cache;
     static bool _exportU3D( const r3d::Mesh&, const QString&, const rimg::Colour &ems);
+    static QString _stored( const QString&);
+    static QString _store( const QString&, const r3d::Mesh&, const QColor&);
+    static void _trim();
 };  // end class
 
 }   // end namespace
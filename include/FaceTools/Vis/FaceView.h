@@ -35,6 +35,8 @@
 namespace FaceTools { namespace Vis {
 
 class ColourVisualisation;
+class ModelGeometry;
+class PickBuffer;
 
 class FaceTools_EXPORT FaceView
 {
@@ -64,12 +66,24 @@ public:
 
     // Remove and purge all visualisations and rebuild the view models from data. For textured actors
     // only Meshes with a single material are accepted (for models having multiple materials, use
-    // Mesh::mergeMaterials beforehand).
+    // Mesh::mergeMaterials beforehand). After the first build, the VTK geometry is prepared on a
+    // worker thread with the existing actor remaining in place until the new one is swapped in.
     void rebuild();
 
+    // Returns true iff waiting on geometry to be prepared for the new actor.
+    inline bool isRebuilding() const { return _rebuilding;}
+
     // Reset just the normals from generated FaceModelCurvature.
     void resetNormals();
 
+    // Set whether to show the model's decimated proxy geometry in place of the main actor.
+    // Used while the camera is moving. The main actor is hidden (and so not pickable) while
+    // the proxy is shown. Nothing changes if the model has no proxy ready.
+    void setLowDetail( bool);
+
+    // Returns true iff the proxy is being shown in place of the main actor.
+    inline bool lowDetail() const { return _lodActor != nullptr;}
+
     // Return the main face actor.
     inline const vtkActor* actor() const { return _actor;}
     inline vtkActor* actor() { return _actor;}
@@ -104,7 +118,9 @@ public:
 
     // Project the given 2D point to the visible corresponding location on the 3D surface of
     // the main actor. Returns true iff the point projects to the surface. Ignores all other actors.
-    // Note that the position vector obtained is transformed.
+    // Note that the position vector obtained is transformed. Points are looked up in a pick buffer
+    // of the actor's faces made in the background after the camera, transform, viewport or mesh
+    // change. Until the buffer is ready, the point is found by ray casting against the actor.
     bool projectToSurface( const QPoint&, Vec3f&) const;
 
     // Returns true iff this view overlaps with any other FaceView in its viewer.
@@ -164,7 +180,11 @@ public:
 
 private:
     FM *_data;
+    bool _rebuilding;                       // True while waiting on new geometry.
+    std::shared_ptr<const ModelGeometry> _geom; // Geometry shared with the model's other views.
     vtkSmartPointer<vtkActor> _actor;       // The face actor.
+    vtkSmartPointer<vtkActor> _lodActor;    // The proxy actor shown in place of the face actor.
+    bool _lowDetail;                        // True if the proxy should be shown when available.
     vtkSmartPointer<vtkTexture> _texture;   // The texture map (if generated).
     vtkSmartPointer<vtkFloatArray> _nrms;   // Surface normals.
     FMV *_viewer;                           // The viewer this view is attached to.
@@ -174,11 +194,16 @@ private:
     float _minAllowedOpacity;
     float _maxAllowedOpacity;
     VisualisationLayers _vlayers;           // Visualisation layers.
+    struct PickState;
+    std::shared_ptr<PickState> _pick;       // Pick buffer (shared with the worker making it).
 
     static bool s_smoothLighting;
     static bool s_interpolateShading;
 
     BaseVisualisation* _layer( const vtkProp*) const;
+    void _setGeometry( std::shared_ptr<const ModelGeometry>);
+    void _syncLowDetail();
+    std::shared_ptr<const PickBuffer> _pickBuffer() const;
     void _updateSurfaceProperties();
     FaceView( const FaceView&) = delete;
     FaceView& operator=( const FaceView&) = delete;
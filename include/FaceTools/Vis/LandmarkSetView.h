@@ -18,7 +18,7 @@
 #ifndef FACE_TOOLS_LANDMARK_SET_VIEW_H
 #define FACE_TOOLS_LANDMARK_SET_VIEW_H
 
-#include "SphereView.h"
+#include "SphereGlyphView.h"
 #include <FaceTools/LndMrk/LandmarkSet.h>
 
 namespace FaceTools { namespace Vis {
@@ -47,10 +47,15 @@ public:
     void set( int, FaceSide, const Vec3f&);
     void remove( int);
 
-    // Returns ID of landmark for prop or -1 if not found.
-    // On return >= 0, out parameter FaceSide is set to the
-    // lateral on which the landmark appears.
+    // Returns ID of landmark for prop at the viewer's current mouse coordinates or -1 if not
+    // found. On return >= 0, out parameter FaceSide is set to the lateral on which the landmark
+    // appears. All landmarks are instances of a single prop so the landmark is resolved as the
+    // visible landmark projecting closest to the given display coordinates.
     int landmarkId( const vtkProp*, FaceSide&) const;
+    int landmarkId( const vtkProp*, const QPoint&, FaceSide&) const;
+
+    // Returns true iff the given prop is the prop of the landmarks.
+    bool belongs( const vtkProp*) const;
 
     void pokeTransform( const vtkMatrix4x4*);
 
@@ -59,13 +64,15 @@ private:
     ModelViewer *_viewer;
     bool _visible;
 
-    using SphereMap = std::unordered_map<int, SphereView*>;
-    using PropMap = std::unordered_map<const vtkProp*, int>;
+    SphereGlyphView _glyphs;
 
-    SphereMap _lviews, _mviews, _rviews;
-    PropMap _lprops, _mprops, _rprops;
+    using InstanceMap = std::unordered_map<int, int>;   // Landmark IDs to glyph instances
+    InstanceMap _linsts, _minsts, _rinsts;
+    std::unordered_map<int, std::pair<int, FaceSide> > _lmks;  // Glyph instances to landmarks
 
-    void _remove( int, SphereMap&, PropMap&);
+    InstanceMap &_instances( FaceSide);
+    int _instance( int, FaceSide) const;
+    void _remove( int, InstanceMap&);
     void _setLandmarkColour( const Vec3f&, int, FaceSide);
     LandmarkSetView( const LandmarkSetView&) = delete;
     void operator=( const LandmarkSetView&) = delete;
@@ -53,7 +53,10 @@ public:
 
     // Return ID of landmark if given prop is for a landmark or -1 if not.
     // On return of >= 0, lat is set to the face side that the landmark appears.
+    // The landmark is resolved at the display coordinates given or at the
+    // current mouse coordinates of the view's viewer if not given.
     int landmarkId( const FV*, const vtkProp*, FaceSide& lat) const;
+    int landmarkId( const FV*, const vtkProp*, const QPoint&, FaceSide& lat) const;
 
 private:
     std::unordered_map<const FV*, LandmarkSetView> _views;
@@ -0,0 +1,113 @@
+/************************************************************************
+ * Copyright (C) 2022 SIS Research Ltd & Richard Palmer
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ ************************************************************************/
+
+#ifndef FACE_TOOLS_VIS_MODEL_GEOMETRY_H
+#define FACE_TOOLS_VIS_MODEL_GEOMETRY_H
+
+/**
+ * The VTK geometry (points, polygons, texture coordinates and texture image) of a model's
+ * mesh shared between all FaceViews of the model. Each view creates its own actor over the
+ * shared geometry so properties, point/cell data arrays and active scalars remain per view.
+ * Geometry is reference counted by the views using it and freed once no views remain.
+ * Geometry can be prepared on the worker pool (from a copy of the mesh taken under the model's
+ * read lock), but this class's static functions must only be called from the GUI thread.
+ * Large meshes also have a decimated proxy prepared in the background after the full geometry
+ * is ready, for views to show while the camera is moving. Proxies keep the points duplicated
+ * along texture seams split so they're textured the same as the full geometry.
+ */
+
+#include <FaceTools/FaceTypes.h>
+#include <vtkSmartPointer.h>
+#include <vtkPolyData.h>
+#include <vtkTexture.h>
+#include <vtkActor.h>
+#include <functional>
+
+namespace FaceTools { namespace Vis {
+
+class FaceTools_EXPORT ModelGeometry
+{
+public:
+    using Ptr = std::shared_ptr<const ModelGeometry>;
+
+    // Return the geometry for the given model's current mesh. The mesh is only converted
+    // if the geometry for the model isn't already held or the model's mesh has changed.
+    static Ptr get( FM*);
+
+    // Like get but if the geometry for the model's current mesh isn't already held, it
+    // is prepared on a worker thread and the given function is called on the GUI thread
+    // with the geometry once ready. Otherwise, the function is called immediately. Only one
+    // preparation per model is undertaken at a time with all views requesting it waiting on
+    // the same preparation. If the mesh changes before preparation finishes, views waiting
+    // on the old geometry are given the geometry of the new mesh instead.
+    static void prepare( FM*, const FV*, const std::function<void( Ptr)>&);
+
+    // Cancel the outstanding call to the function given to prepare for the given view.
+    static void cancel( const FV*);
+
+    // Discard the held geometry for the given model so that the next call to get
+    // converts the mesh afresh (views already holding the old geometry keep it).
+    static void purge( const FM*);
+
+    // Forget the given model entirely. Must be called before the model is deleted. Blocks
+    // while a worker is copying the model's mesh so that no worker references it afterwards.
+    static void forget( const FM*);
+
+    // Create a new actor over this geometry. The actor has its own vtkPolyData sharing
+    // this geometry's points, polygons and arrays, and its own texture over the shared image.
+    vtkSmartPointer<vtkActor> createActor() const;
+
+    // Don't modify!
+    inline const vtkPolyData* polyData() const { return _pdata;}
+
+    // Return the mesh this geometry was generated from or null if it no longer exists.
+    inline std::shared_ptr<const r3d::Mesh> mesh() const { return _mesh.lock();}
+
+    // Set/get the number of triangles to decimate large meshes to for their proxies.
+    // Meshes with fewer than twice this number of triangles don't have a proxy.
+    // Set to zero to disable proxies. Only affects geometry generated after setting.
+    static void setProxyTriangles( int);
+    static int proxyTriangles();
+
+    // Returns true iff the decimated proxy of this geometry is ready.
+    inline bool hasProxy() const { return _proxy != nullptr;}
+
+    // Return new polydata over the proxy geometry with the point and cell data arrays of the
+    // given polydata (which must be over this geometry) resampled from the point each proxy
+    // point was kept from and the cell nearest each proxy cell. Active attributes are kept. Returns null if no proxy ready.
+    vtkSmartPointer<vtkPolyData> createProxy( vtkPolyData*) const;
+
+private:
+    struct Proxy;
+    vtkSmartPointer<vtkActor> _proto;       // Generated actor providing the mapper, property and texture settings
+    vtkSmartPointer<vtkPolyData> _pdata;    // The shared geometry
+    std::weak_ptr<const r3d::Mesh> _mesh;   // The mesh the geometry was generated from
+    Mat4f _tmat;                            // The mesh's transform at time of generation
+    mutable std::shared_ptr<const Proxy> _proxy;    // Set once ready (only from the GUI thread)
+    static int s_proxyTriangles;
+
+    ModelGeometry( r3d::Mesh::Ptr, const Mat4f&, const r3d::Mesh&);
+    static Ptr _held( const FM*, const r3d::Mesh::Ptr&, const Mat4f&);
+    static std::shared_ptr<const Proxy> _createProxy( vtkPolyData*, int);
+    static void _prepareProxy( const Ptr&);
+    ModelGeometry( const ModelGeometry&) = delete;
+    ModelGeometry& operator=( const ModelGeometry&) = delete;
+};  // end class
+
+}}   // end namespaces
+
+#endif
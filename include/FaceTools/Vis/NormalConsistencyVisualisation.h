@@ -0,0 +1,42 @@
+/************************************************************************
+ * Copyright (C) 2021 SIS Research Ltd & Richard Palmer
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ ************************************************************************/
+
+#ifndef FACE_TOOLS_VIS_NORMAL_CONSISTENCY_VISUALISATION_H
+#define FACE_TOOLS_VIS_NORMAL_CONSISTENCY_VISUALISATION_H
+
+#include "ColourVisualisation.h"
+
+namespace FaceTools { namespace Vis {
+
+// Colour maps the faces of a model by the consistency of their normals (see NormalConsistency).
+class FaceTools_EXPORT NormalConsistencyVisualisation : public ColourVisualisation
+{
+public:
+    NormalConsistencyVisualisation();
+
+    QString getCaption( const Vec3f&) const override { return "";}
+
+    // Recalculates the consistency of the view's model and (re)adds the cells array.
+    void refresh( FV*) override;
+
+protected:
+    void show( FV*) override;
+};  // end class
+
+}}   // end namespace
+
+#endif
@@ -0,0 +1,60 @@
+/************************************************************************
+ * Copyright (C) 2021 SIS Research Ltd & Richard Palmer
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ ************************************************************************/
+
+#ifndef FACE_TOOLS_VIS_OFFSCREEN_RENDERER_H
+#define FACE_TOOLS_VIS_OFFSCREEN_RENDERER_H
+
+/**
+ * Renders meshes to images on a single dedicated thread that owns persistent offscreen
+ * viewers (one per image size) so that the GL context isn't recreated for every image.
+ * Requests can be made from any thread and are queued for the render thread. Callers
+ * block until their requests are rendered so the meshes and normals given need only
+ * remain valid for the duration of the call. Exceptions thrown while rendering are
+ * rethrown to the caller.
+ */
+
+#include <FaceTools/FaceTypes.h>
+#include <r3d/CameraParams.h>
+#include <vtkFloatArray.h>
+#include <QImage>
+
+namespace FaceTools { namespace Vis {
+
+class FaceTools_EXPORT OffscreenRenderer
+{
+public:
+    struct Request
+    {
+        const r3d::Mesh *mesh;
+        const vtkFloatArray *normals;   // Point normals for smooth lighting (may be null)
+        r3d::CameraParams camera;
+        QSize size;
+    };  // end struct
+
+    // Render the given request returning the image.
+    static QImage render( const Request&);
+
+    // Render the given requests in order as a single batch returning the images.
+    static std::vector<QImage> render( const std::vector<Request>&);
+
+private:
+    OffscreenRenderer() = delete;
+};  // end class
+
+}}   // end namespaces
+
+#endif
@@ -0,0 +1,93 @@
+/************************************************************************
+ * Copyright (C) 2021 SIS Research Ltd & Richard Palmer
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ ************************************************************************/
+
+#ifndef FACE_TOOLS_VIS_PICK_BUFFER_H
+#define FACE_TOOLS_VIS_PICK_BUFFER_H
+
+/**
+ * Per pixel record of the face of a mesh visible at each pixel of a viewport for a given
+ * camera and actor transform. The faces are rasterised on the CPU (rows in parallel) so no
+ * graphics context is needed and results don't depend on the graphics driver or whether the
+ * viewer is rendering offscreen. Once made, mapping a pixel to its surface position is
+ * constant time. Buffers are immutable; a new one must be made when the camera, the actor's
+ * transform, the viewport size or the mesh changes.
+ */
+
+#include <FaceTools/FaceTypes.h>
+#include <QPoint>
+
+class vtkRenderer;
+
+namespace FaceTools { namespace Vis {
+
+class FaceTools_EXPORT PickBuffer
+{
+public:
+    using Ptr = std::shared_ptr<const PickBuffer>;
+
+    // Rasterise the faces of the given mesh (which must have sequential ids) into a buffer of
+    // the given (device) pixel dimensions. The untransformed vertices of the mesh are mapped to the
+    // normalised device coordinates of the viewport by ndc and to world coordinates by toWorld.
+    // The device pixel ratio dpr is the number of device pixels per logical pixel (per side).
+    static Ptr create( std::shared_ptr<const r3d::Mesh>, const Mat4f &ndc, const Mat4f &toWorld,
+                       int w, int h, float dpr=1.0f);
+
+    // Return the matrix taking world coordinates to the normalised device
+    // coordinates of the given renderer's viewport from its active camera.
+    static Mat4f deviceMatrix( vtkRenderer*);
+
+    // Returns true iff this buffer was made for the given mesh, matrix, dimensions and pixel ratio.
+    bool isFor( const r3d::Mesh*, const Mat4f &ndc, int w, int h, float dpr=1.0f) const;
+
+    inline int width() const { return _w;}
+    inline int height() const { return _h;}
+    inline float devicePixelRatio() const { return _dpr;}
+
+    // The following take points in logical pixels (as given by mouse events) with a top left
+    // origin and map them to the device pixels of the buffer using the device pixel ratio.
+
+    // Return the id of the face visible at the given pixel or -1 if none.
+    int faceId( const QPoint&) const;
+
+    // Returns true iff a face is visible at the given pixel, setting fid to its id and
+    // bary to the barycentric coordinates of the point on the face under the pixel.
+    bool barycentric( const QPoint&, int &fid, Vec3f &bary) const;
+
+    // Returns true iff a face is visible at the given pixel, setting
+    // pos to the (world) position on the face under the pixel.
+    bool surfacePosition( const QPoint&, Vec3f &pos) const;
+
+private:
+    std::shared_ptr<const r3d::Mesh> _mesh;
+    Mat4f _ndc;         // Untransformed vertices to normalised device coordinates
+    Mat4f _indc;        // Inverse of _ndc
+    Mat4f _toWorld;     // Untransformed vertices to world coordinates
+    int _w, _h;         // Device pixels
+    float _dpr;         // Device pixels per logical pixel
+    std::vector<int> _fids; // Row major, top row first
+
+    PickBuffer( std::shared_ptr<const r3d::Mesh>, const Mat4f&, const Mat4f&, int, int, float);
+    void _rasterise();
+    Vec2f _toDevice( const QPoint&) const;
+    bool _project( const QPoint&, int&, Vec3f&) const;
+    PickBuffer( const PickBuffer&) = delete;
+    void operator=( const PickBuffer&) = delete;
+};  // end class
+
+}}   // end namespaces
+
+#endif
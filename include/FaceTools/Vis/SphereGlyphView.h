@@ -0,0 +1,126 @@
+/************************************************************************
+ * Copyright (C) 2022 SIS Research Ltd & Richard Palmer
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ ************************************************************************/
+
+#ifndef FACE_TOOLS_SPHERE_GLYPH_VIEW_H
+#define FACE_TOOLS_SPHERE_GLYPH_VIEW_H
+
+/**
+ * Many spheres rendered as glyph instances of a single actor with per instance colour,
+ * visibility and optional caption. Captions are rendered by a single label actor.
+ * Instances are identified by the index returned when added and freed indices are reused.
+ */
+
+#include "ViewInterface.h"
+#include <vtkSmartPointer.h>
+#include <vtkSphereSource.h>
+#include <vtkPolyData.h>
+#include <vtkActor.h>
+#include <vtkActor2D.h>
+#include <vtkUnsignedCharArray.h>
+#include <vtkBitArray.h>
+#include <vtkFloatArray.h>
+#include <vtkStringArray.h>
+#include <vtkCallbackCommand.h>
+#include <vtkRenderer.h>
+#include <QColor>
+
+namespace FaceTools { namespace Vis {
+
+class FaceTools_EXPORT SphereGlyphView : public ViewInterface
+{
+public:
+    SphereGlyphView( double radius=1.0, int resolution=8, bool fixedScale=false);
+    virtual ~SphereGlyphView();
+
+    // Add a new visible sphere instance returning its index.
+    int add( const Vec3f& centre, const std::string& caption="");
+
+    // Free the given instance for reuse.
+    void remove( int);
+
+    // Returns the number of instances (including freed).
+    size_t size() const;
+
+    void setCentre( int, const Vec3f&);
+    Vec3f centre( int) const;
+
+    void setInstanceVisible( int, bool);
+    bool isInstanceVisible( int) const;
+
+    void setColour( int, double r, double g, double b);
+    void setColour( double r, double g, double b);      // All instances
+    void setOpacity( double);
+
+    void showCaption( int, bool);
+    void setCaptionColour( const QColor &fg, const QColor &bg);
+
+    void setPickable( bool);
+    bool pickable() const;
+
+    double radius() const { return _radius;}
+
+    // Render to the given renderer without a ModelViewer (for offscreen use).
+    // Sets the renderer used to keep spheres at a fixed size on screen if fixed scale.
+    void setRenderer( vtkRenderer*);
+    vtkActor* actor() { return _actor;}
+    vtkActor2D* labelsActor() { return _labels;}
+
+    // Return the visible and unoccluded instance with centre projecting closest to the given
+    // display coordinates in the given viewer, or -1 if there are no such instances. Instances
+    // behind the surface rendered at the given coordinates are occluded there.
+    int instance( const ModelViewer*, const QPoint&) const;
+
+    void setVisible( bool, ModelViewer*) override;
+    bool isVisible() const override { return _visible;}
+    bool belongs( const vtkProp*) const override;
+    void pokeTransform( const vtkMatrix4x4*) override;
+
+private:
+    ModelViewer *_vwr;
+    bool _visible;
+    double _radius;
+    bool _fixedScale;
+    Mat4f _tmat;
+    vtkRenderer *_ren;
+    unsigned long _obsId;
+    unsigned char _alpha;
+    std::vector<int> _free;
+    std::vector<std::string> _captions;
+    std::vector<bool> _showCaption;
+
+    vtkSmartPointer<vtkSphereSource> _source;
+    vtkSmartPointer<vtkPolyData> _pdata;            // Instance centres with point data arrays
+    vtkSmartPointer<vtkUnsignedCharArray> _cols;    // Instance RGBA
+    vtkSmartPointer<vtkBitArray> _mask;             // Instance visibility
+    vtkSmartPointer<vtkFloatArray> _scales;         // Instance scales
+    vtkSmartPointer<vtkActor> _actor;
+
+    vtkSmartPointer<vtkPolyData> _lpdata;           // Points of the shown captions
+    vtkSmartPointer<vtkStringArray> _ltext;         // The shown captions
+    vtkSmartPointer<vtkActor2D> _labels;
+    vtkSmartPointer<vtkCallbackCommand> _scaler;
+
+    void _updateScales();
+    void _updateLabels();
+    static void _onStartRender( vtkObject*, unsigned long, void*, void*);
+    SphereGlyphView( const SphereGlyphView&) = delete;
+    void operator=( const SphereGlyphView&) = delete;
+};  // end class
+
+}}   // end namespaces
+
+#endif
@@ -0,0 +1,82 @@
+/************************************************************************
+ * Copyright (C) 2021 SIS Research Ltd & Richard Palmer
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ ************************************************************************/
+
+#ifndef FACE_TOOLS_WORKER_POOL_H
+#define FACE_TOOLS_WORKER_POOL_H
+
+/**
+ * Thread pool shared by asynchronous actions and other background work so that
+ * threads aren't created and destroyed for every piece of work. Queued work runs in
+ * order of priority with work requested by the user ahead of background refreshes.
+ * Work is given a cancellation token to poll, and the time work spends queued
+ * before starting is recorded per priority.
+ */
+
+#include "FaceTypes.h"
+#include <QThreadPool>
+#include <atomic>
+
+namespace FaceTools {
+
+class FaceTools_EXPORT WorkerPool
+{
+public:
+    enum Priority
+    {
+        BACKGROUND = 0, // Work done automatically in response to events
+        USER = 1        // Work requested by the user
+    };  // end enum
+
+    class Token
+    {
+    public:
+        using Ptr = std::shared_ptr<Token>;
+        Token() : _cancelled(false) {}
+
+        // Request that the work be cancelled. Work not yet started is still run
+        // (so it can clean up) but should return as soon as it sees it's cancelled.
+        void cancel() { _cancelled = true;}
+        bool isCancelled() const { return _cancelled;}
+
+    private:
+        std::atomic<bool> _cancelled;
+        Token( const Token&) = delete;
+        void operator=( const Token&) = delete;
+    };  // end class
+
+    // Queue the given function to run on the pool with the given priority. The function is
+    // passed the returned cancellation token (or the one given if not null).
+    static Token::Ptr run( const std::function<void( const Token&)>&, Priority p=BACKGROUND, Token::Ptr tok=nullptr);
+
+    // Set/get the maximum number of threads (defaults to the number of cores).
+    static void setMaxThreadCount( int);
+    static int maxThreadCount();
+
+    // The number of pieces of work of the given priority started since the last reset,
+    // and the mean and maximum times in milliseconds that they spent queued.
+    static size_t numStarted( Priority);
+    static double meanQueueWait( Priority);
+    static double maxQueueWait( Priority);
+    static void resetQueueWaits();
+
+private:
+    static QThreadPool& _pool();
+};  // end class
+
+}   // end namespace
+
+#endif
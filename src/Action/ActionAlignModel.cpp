@@ -108,7 +108,7 @@ MatX3f getNormFeatures( const FM &fm, Vec3f &pos, float sqRad)
     const size_t N = vidxs.size();
 
     const Mat4f T = fm.mesh().transformMatrix();   // Need to transform vertex normals
-    FMCS::RPtr curv = FMCS::rvals( fm);
+    FMCS::RPtr curv = FMCS::waitRvals( fm);  // Curvature may still be calculating
     assert( curv);
     const MatX3f &vnrms = curv->vals().vertexNormals();    // Untransformed
     MatX3f frows( N, 3);
@@ -168,7 +168,7 @@ void ActionAlignModel::align( FM &fm)
     }   // end if
     else
     {
-        assert( FMCS::rvals( fm) != nullptr);
+        assert( FMCS::has( fm));
 
         Mat4f T = Mat4f::Zero();
 
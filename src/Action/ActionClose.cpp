@@ -20,8 +20,10 @@
 #include <FileIO/FaceModelManager.h>
 #include <QMessageBox>
 #include <QFileInfo>
+#include <QTimer>
 using FaceTools::Action::ActionClose;
 using FaceTools::Action::FaceAction;
+using FaceTools::Action::FaceActionWorker;
 using FaceTools::Action::Event;
 using FaceTools::Action::FAM;
 using FaceTools::Vis::FV;
@@ -32,7 +34,7 @@ using QMB = QMessageBox;
 
 
 ActionClose::ActionClose( const QString& dname, const QIcon& ico, const QKeySequence& ks)
-    : FaceAction( dname, ico, ks)
+    : FaceAction( dname, ico, ks), _closing(nullptr)
 {
     addRefreshEvent( Event::LOADED_MODEL | Event::CLOSED_MODEL);
 }   // end ctor
@@ -42,26 +44,63 @@ bool ActionClose::isAllowed( Event) { return MS::isViewSelected();}
 
 bool ActionClose::doBeforeAction( Event)
 {
-    FM::RPtr fm = MS::selectedModelScopedRead();
-    bool inPreferredFormat = FMM::hasPreferredFileFormat( *fm);
+    FM *cfm = MS::selectedModel();
+    bool doclose = cfm && cfm == _closing;  // Already confirmed if waiting on jobs
+    _closing = nullptr;
 
-    bool doclose = false;
-    if ( fm->isSaved())
-        doclose = true;
-    else
+    if ( !doclose)
     {
-        const QString fname = QFileInfo( FMM::filepath(*fm)).fileName();
-        QString msg = tr( ("Model '" + fname.toStdString() + "' is unsaved! Really close?").c_str());
-        if ( fm->hasMetaData() && !inPreferredFormat)
-            msg = tr("Not saved as 3DF; data will be lost! Really close?");
-        doclose = QMB::Yes == QMB::warning( static_cast<QWidget*>(parent()),
-                tr("Unsaved Changes!"), QString("<p align='center'>%1</p>").arg(msg), QMB::Yes | QMB::No, QMB::No);
+        FM::RPtr fm = MS::selectedModelScopedRead();
+        bool inPreferredFormat = FMM::hasPreferredFileFormat( *fm);
+
+        if ( fm->isSaved())
+            doclose = true;
+        else
+        {
+            const QString fname = QFileInfo( FMM::filepath(*fm)).fileName();
+            QString msg = tr( ("Model '" + fname.toStdString() + "' is unsaved! Really close?").c_str());
+            if ( fm->hasMetaData() && !inPreferredFormat)
+                msg = tr("Not saved as 3DF; data will be lost! Really close?");
+            doclose = QMB::Yes == QMB::warning( static_cast<QWidget*>(parent()),
+                    tr("Unsaved Changes!"), QString("<p align='center'>%1</p>").arg(msg), QMB::Yes | QMB::No, QMB::No);
+        }   // end if
+    }   // end if
+
+    // Cancel any jobs on the model and close it once they've finished.
+    if ( doclose && FaceActionWorker::isWorking( cfm))
+    {
+        FaceActionWorker::cancel( cfm);
+        MS::showStatus( "Cancelling actions working on the model before closing...", 5000);
+        _closing = cfm;
+        QTimer::singleShot( 100, this, &ActionClose::_closeWhenFinished);
+        doclose = false;
     }   // end if
 
     return doclose;
 }   // end doBeforeAction
 
 
+void ActionClose::_closeWhenFinished()
+{
+    if ( !_closing || FMM::opened().count( _closing) == 0)
+    {
+        _closing = nullptr;
+        return;
+    }   // end if
+
+    if ( FaceActionWorker::isWorking( _closing))
+    {
+        QTimer::singleShot( 100, this, &ActionClose::_closeWhenFinished);
+        return;
+    }   // end if
+
+    // Close the model even if it's no longer the selected one
+    FM *pfm = MS::bindSelected( _closing);
+    execute( Event::USER);
+    MS::bindSelected( pfm);
+}   // end _closeWhenFinished
+
+
 void ActionClose::doAction( Event)
 {
     MS::setInteractionMode( IMode::CAMERA_INTERACTION);
@@ -19,8 +19,10 @@
 #include <Action/FaceActionManager.h>
 #include <FileIO/FaceModelManager.h>
 #include <QMessageBox>
+#include <QTimer>
 using FaceTools::Action::ActionCloseAll;
 using FaceTools::Action::FaceAction;
+using FaceTools::Action::FaceActionWorker;
 using FaceTools::Action::Event;
 using FaceTools::Action::FAM;
 using FaceTools::FM;
@@ -30,7 +32,7 @@ using QMB = QMessageBox;
 
 
 ActionCloseAll::ActionCloseAll( const QString& dname, const QIcon& icon, const QKeySequence& ks)
-    : FaceAction( dname, icon, ks)
+    : FaceAction( dname, icon, ks), _closing(false)
 {
     addRefreshEvent( Event::LOADED_MODEL | Event::CLOSED_MODEL);
 }   // end ctor
@@ -39,6 +41,12 @@ bool ActionCloseAll::isAllowed( Event) { return FMM::numOpen() > 1;}
 
 bool ActionCloseAll::doBeforeAction( Event)
 {
+    if ( _closing)  // Already confirmed
+    {
+        _closing = false;
+        return true;
+    }   // end if
+
     bool doshowmsg = false;
     for ( FM* fm : FMM::opened())
     {
@@ -58,10 +66,31 @@ bool ActionCloseAll::doBeforeAction( Event)
                 tr("Unsaved Changes!"), QString("<p align='center'>%1</p>").arg(msg), QMB::Yes | QMB::No, QMB::No);
     }   // end if
 
+    // Cancel any jobs and close the models once they've finished.
+    if ( doclose && FaceActionWorker::isWorking())
+    {
+        FaceActionWorker::cancel( nullptr);
+        MS::showStatus( "Cancelling actions working on the models before closing...", 5000);
+        _closing = true;
+        QTimer::singleShot( 100, this, &ActionCloseAll::_closeWhenFinished);
+        doclose = false;
+    }   // end if
+
     return doclose;
 }   // end doBeforeAction
 
 
+void ActionCloseAll::_closeWhenFinished()
+{
+    if ( FaceActionWorker::isWorking())
+        QTimer::singleShot( 100, this, &ActionCloseAll::_closeWhenFinished);
+    else if ( !FMM::opened().empty())
+        execute( Event::USER);
+    else
+        _closing = false;
+}   // end _closeWhenFinished
+
+
 void ActionCloseAll::doAction( Event)
 {
     UndoStates::clear();
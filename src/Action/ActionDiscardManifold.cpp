@@ -108,20 +108,13 @@ bool ActionDiscardManifold::doBeforeAction( Event)
 
 void ActionDiscardManifold::doAction( Event)
 {
-    FM* fm = MS::selectedModel();
-    fm->lockForWrite();
-    const Mat4f T = fm->transformMatrix();
-
-    const IntSet& polys = fm->manifolds()[_mid].faces();  // Faces to discard
-    r3d::Mesh::Ptr mobj = fm->mesh().deepCopy();
-    for ( int f : polys)
-        mobj->removeFace(f);
-
-    // FM::update removes any unused vertices resulting from the removal of faces
-    // and then ensures that the vertices are in sequential order.
-    fm->update( mobj, true, true);
-    fm->addTransformMatrix( T); // Reapply any transform
-    fm->unlock();
+    FM::WPtr fm = MS::selectedModelScopedWrite();
+    IntSet mids;    // Manifolds to keep
+    const int nm = int(fm->manifolds().count());
+    for ( int i = 0; i < nm; ++i)
+        if ( i != _mid)
+            mids.insert(i);
+    fm->keepManifolds( mids);
 }   // end doAction
 
 
@@ -20,6 +20,8 @@
 #include <Interactor/RadialSelectHandler.h>
 #include <FaceModel.h>
 #include <r3d/Copier.h>
+#include <algorithm>
+#include <unordered_map>
 using FaceTools::Action::ActionExtractFace;
 using FaceTools::Action::FaceAction;
 using FaceTools::Action::Event;
@@ -108,6 +110,24 @@ r3d::Mesh::Ptr cropRegion( const r3d::Mesh &mesh, const IntSet &cfids)
 }   // end cropRegion
 
 
+// Returns the manifolds whose faces are all in cfids, or none if cfids
+// has faces from any manifold that isn't wholly within it.
+IntSet wholeManifolds( const r3d::Manifolds &manfs, const IntSet &cfids)
+{
+    std::unordered_map<int, size_t> counts;    // Selected faces per manifold
+    for ( int fid : cfids)
+        counts[manfs.fromFaceId(fid)]++;
+    IntSet mids;
+    for ( const auto &p : counts)
+    {
+        if ( p.second < manfs.at(p.first).faces().size())
+            return IntSet();
+        mids.insert( p.first);
+    }   // end for
+    return mids;
+}   // end wholeManifolds
+
+
 r3d::Mesh::Ptr extractFacialRegion( const FM &fm, r3d::Vec3f pos, float sqd)
 {
     std::vector<std::pair<size_t, float> > vtxs;
@@ -160,7 +180,22 @@ void ActionExtractFace::doAction( Event)
 
     RadialSelectHandler *handler = MS::handler<RadialSelectHandler>();
     if ( handler->isEnabled())
-        nmod = cropRegion( fm->mesh(), handler->selectedFaces());
+    {
+        // If the selection is of whole manifolds, keep the largest of them directly.
+        const IntSet &cfids = handler->selectedFaces();
+        const IntSet mids = wholeManifolds( fm->manifolds(), cfids);
+        if ( !mids.empty())
+        {
+            const int mid = *std::max_element( mids.begin(), mids.end(), [&fm]( int m0, int m1)
+                        { return fm->manifolds().at(m0).faces().size() < fm->manifolds().at(m1).faces().size();});
+            if ( fm->manifolds().count() > 1)
+                fm->keepManifolds( {mid});
+            else
+                _ev = Event::NONE;
+            return;
+        }   // end if
+        nmod = cropRegion( fm->mesh(), cfids);
+    }   // end if
     else
         nmod = extract( *fm);
 
@@ -18,6 +18,7 @@
 #include <Action/ActionFillHoles.h>
 #include <FaceModelViewer.h>
 #include <FaceModel.h>
+#include <FaceTools.h>
 #include <r3d/HoleFiller.h>
 #include <algorithm>
 using FaceTools::Action::ActionFillHoles;
@@ -85,59 +86,183 @@ size_t getNumHoles( const r3d::Manifolds& manf)
 }   // end namespace
 
 
-void ActionFillHoles::doAction( Event)
-{
-    using namespace r3d;
+namespace {
 
-    FM* fm = MS::selectedModel();
-    fm->lockForWrite();
-    const Manifolds* manfs = &fm->manifolds();
-    const size_t nm = manfs->count();
-    Mesh::Ptr mesh = fm->mesh().deepCopy();
-    Manifolds::Ptr nmanfs;
+using namespace r3d;
 
-    while ( true)
+// Fill the holes (all boundaries except the first) of each manifold returning the number of polygons added.
+int fillManifoldHoles( Mesh::Ptr mesh, const Manifolds &manfs)
+{
+    HoleFiller hfiller( mesh);
+    int sumPolysAdded = 0;    // Total polygons added
+    const size_t nm = manfs.count();
+    for ( size_t i = 0; i < nm; ++i)
     {
-        HoleFiller hfiller( mesh);
-        std::vector<int> mholes(nm);    // Record the number of holes per manifold
+        const r3d::Manifold& man = manfs.at(int(i));
+        const IntSet& mpolys = man.faces();
+        assert( !mpolys.empty());
+
+        const Boundaries& bnds = man.boundaries();
+        const int nbs = static_cast<int>(bnds.count()); // Can be zero
 
-        int sumPolysAdded = 0;    // Total polygons added
-        for ( size_t i = 0; i < nm; ++i)
+        int polysAdded = 0;
+        for ( int j = 1; j < nbs; ++j)  // Ignore the first (longest) boundary
         {
-            const r3d::Manifold& man = manfs->at(int(i));
-            const IntSet& mpolys = man.faces();
-            assert( !mpolys.empty());
+            const std::list<int>& blist = bnds.boundary(j);
+            polysAdded += hfiller.fillHole( blist, mpolys);
+        }   // end for
+#ifndef NDEBUG
+        if ( nbs > 1)
+        {
+            std::cerr << "Manifold " << i << ": " << std::setw(4) << (nbs-1)
+                      << " holes filled with " << std::setw(4) << polysAdded << " polygons" << std::endl;
+        }   // end if
+#endif
+        sumPolysAdded += polysAdded;
+    }   // end for
+    return sumPolysAdded;
+}   // end fillManifoldHoles
 
-            const Boundaries& bnds = man.boundaries();
-            const int nbs = static_cast<int>(bnds.count()); // Can be zero
-            mholes[i] = std::max(0, nbs-1);
 
-            int polysAdded = 0;
-            for ( int j = 1; j < nbs; ++j)  // Ignore the first (longest) boundary
-            {
-                const std::list<int>& blist = bnds.boundary(j);
-                polysAdded += hfiller.fillHole( blist, mpolys);
-            }   // end for
-#ifndef NDEBUG
-            if ( nbs > 1)
+struct FilledPart
+{
+    Mesh::Ptr mesh;     // Copy of the manifold's faces (untransformed) with its holes filled
+    IntSet copiedFids;  // Faces in the copy from the source mesh (the rest were added)
+    std::unordered_map<int, int> svmap;    // Copied vertices to their source mesh vertices
+};  // end struct
+
+
+// Copy just the faces of the given manifold into a new mesh and fill its holes
+// there, re-parsing only the copy between passes until no polygons are added.
+// The copy is made here rather than with r3d::Copier to keep the source of each copied vertex.
+FilledPart fillPart( const Mesh &mesh, const Manifold &man)
+{
+    std::vector<int> fids( man.faces().begin(), man.faces().end());
+    std::sort( fids.begin(), fids.end());
+
+    FilledPart part;
+    part.mesh = Mesh::create();
+    Mesh &pmesh = *part.mesh;
+    const int smid = mesh.hasMaterials() ? *mesh.materialIds().begin() : -1;
+    const int mid = smid >= 0 ? pmesh.addMaterial( mesh.texture( smid)) : -1;
+    std::unordered_map<int, int> vmap;  // Source vertices to copied vertices
+    for ( int fid : fids)
+    {
+        const int *fvidxs = mesh.fvidxs(fid);
+        int vidxs[3];
+        for ( int k = 0; k < 3; ++k)
+        {
+            auto it = vmap.find( fvidxs[k]);
+            if ( it == vmap.end())
             {
-                std::cerr << "Manifold " << i << ": " << std::setw(4) << mholes[i]
-                          << " holes filled with " << std::setw(4) << polysAdded << " polygons" << std::endl;
+                it = vmap.insert( {fvidxs[k], pmesh.addVertex( mesh.uvtx(fvidxs[k]))}).first;
+                part.svmap[it->second] = fvidxs[k];
             }   // end if
-#endif
-            sumPolysAdded += polysAdded;
+            vidxs[k] = it->second;
         }   // end for
 
+        const int pfid = pmesh.addFace( vidxs[0], vidxs[1], vidxs[2]);
+        if ( pfid >= 0 && mid >= 0 && mesh.faceMaterialId(fid) >= 0)
+            pmesh.setOrderedFaceUVs( mid, pfid, mesh.faceUV( fid, 0), mesh.faceUV( fid, 1), mesh.faceUV( fid, 2));
+    }   // end for
+
+    part.copiedFids = pmesh.faces();
+    int npolys = 1;
+    while ( npolys > 0)
+        npolys = fillManifoldHoles( part.mesh, *Manifolds::create( pmesh));
+    return part;
+}   // end fillPart
+
+
+// Add the polygons added to the part into mesh. Vertices copied from mesh map back
+// to their source vertices and the vertices added by hole filling are added as new.
+void mergePart( Mesh &mesh, const FilledPart &part)
+{
+    const Mesh &pmesh = *part.mesh;
+    std::vector<int> nfids;
+    for ( int fid : pmesh.faces())
+        if ( part.copiedFids.count(fid) == 0)
+            nfids.push_back(fid);
+    std::sort( nfids.begin(), nfids.end());
+
+    const int mid = mesh.hasMaterials() ? *mesh.materialIds().begin() : -1;
+    std::unordered_map<int, int> pvmap = part.svmap;   // Part vertices to mesh vertices
+    for ( int pfid : nfids)
+    {
+        const int *pfvidxs = pmesh.fvidxs(pfid);
+        int vidxs[3];
+        for ( int k = 0; k < 3; ++k)
+        {
+            const int pvidx = pfvidxs[k];
+            auto it = pvmap.find(pvidx);
+            if ( it == pvmap.end())
+                it = pvmap.insert( {pvidx, mesh.addVertex( pmesh.uvtx(pvidx))}).first;
+            vidxs[k] = it->second;
+        }   // end for
+
+        const int fid = mesh.addFace( vidxs[0], vidxs[1], vidxs[2]);
+        if ( fid >= 0 && mid >= 0 && pmesh.faceMaterialId(pfid) >= 0)
+            mesh.setOrderedFaceUVs( mid, fid, pmesh.faceUV( pfid, 0), pmesh.faceUV( pfid, 1), pmesh.faceUV( pfid, 2));
+    }   // end for
+}   // end mergePart
+
+}   // end namespace
+
+
+// public static
+Mesh::Ptr ActionFillHoles::fillHoles( const Mesh &smesh, const Manifolds &smanfs, bool parallel)
+{
+    Mesh::Ptr mesh = smesh.deepCopy();
+    if ( !parallel)
+    {
+        const Manifolds* manfs = &smanfs;
+        Manifolds::Ptr nmanfs;
         // If no polygons added, break loop.
-        if ( sumPolysAdded == 0)
-            break;
+        while ( fillManifoldHoles( mesh, *manfs) > 0)
+        {
+            nmanfs = Manifolds::create( *mesh);
+            const size_t nm = nmanfs->count();
+            for ( size_t i = 0; i < nm; ++i)
+                nmanfs->at(int(i)).boundaries();  // Causes boundary edges to be calculated
+            manfs = nmanfs.get();
+        }   // end while
+        return mesh;
+    }   // end if
+
+    // The manifolds having holes (ordered by index)
+    std::vector<int> mids;
+    const int nm = int(smanfs.count());
+    for ( int i = 0; i < nm; ++i)
+        if ( smanfs.at(i).boundaries().count() > 1)
+            mids.push_back(i);
+
+    std::vector<FilledPart> parts( mids.size());
+    parallelFor( mids.size(), [&]( size_t i0, size_t i1)
+    {
+        for ( size_t i = i0; i < i1; ++i)
+            parts[i] = fillPart( smesh, smanfs.at(mids[i]));
+    });
+
+    // Merge in manifold order with the transform removed so the
+    // added vertices are in the same space as the copied parts.
+    const Mat4f T = mesh->transformMatrix();
+    mesh->setTransformMatrix( Mat4f::Identity());
+    for ( size_t i = 0; i < mids.size(); ++i)
+        mergePart( *mesh, parts[i]);
+    mesh->setTransformMatrix( T);
+    return mesh;
+}   // end fillHoles
 
-        nmanfs = Manifolds::create( *mesh);
-        for ( size_t i = 0; i < nm; ++i)
-            nmanfs->at(int(i)).boundaries();  // Causes boundary edges to be calculated
-        manfs = nmanfs.get();
-    }   // end while
 
+void ActionFillHoles::doAction( Event)
+{
+    FM* fm = MS::selectedModel();
+    // Holes are filled in a copy of the mesh so the model need only be locked for
+    // writing while it's updated (jobs on the same model don't run concurrently).
+    fm->lockForRead();
+    Mesh::Ptr mesh = fillHoles( fm->mesh(), fm->manifolds());
+    fm->unlock();
+    fm->lockForWrite();
     fm->update( mesh, true, true);
     fm->unlock();
 }   // end doAction
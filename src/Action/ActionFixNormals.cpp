@@ -17,16 +17,15 @@
 
 #include <Action/ActionFixNormals.h>
 #include <QMessageBox>
+#include <NormalConsistency.h>
 #include <FaceModel.h>
-#include <r3d/FaceParser.h>
-#include <algorithm>
-#include <cassert>
 using FaceTools::Action::FaceAction;
 using FaceTools::Action::ActionFixNormals;
 using FaceTools::Action::Event;
 using FaceTools::Vis::FV;
 using FaceTools::FVS;
 using FaceTools::FMS;
+using FaceTools::NormalConsistency;
 using FaceTools::FM;
 using MS = FaceTools::ModelSelect;
 using QMB = QMessageBox;
@@ -49,131 +48,45 @@ bool ActionFixNormals::doBeforeAction( Event)
 }   // end doBeforeAction
 
 
-namespace {
-
-struct NormalAgreementParser : r3d::TriangleParser
-{
-    void parseTriangle( int fid, int vroot, int va, int vb) override
-    {
-        const r3d::Vec3f &v0 = mesh->uvtx(vroot);
-        const r3d::Vec3f &v1 = mesh->uvtx(va);
-        const r3d::Vec3f &v2 = mesh->uvtx(vb);
-        const r3d::Vec3f e10 = v1 - v0;
-        const r3d::Vec3f e20 = v2 - v0;
-
-        const r3d::Vec3f cvec = e20.cross(e10);
-        const r3d::Vec3f mvec = mesh->calcFaceVector( fid);
-        // If cvec is in the same direction as mvec (i.e. according to the triangle's current stored vertex order),
-        // then the face id goes in the agree vector, otherwise it goes in disagree.
-        // Note that we don't know what the CORRECT ordering is at this stage since we cannot specify an
-        // authoritative ordering of edges e10 and e20 for the cross product above. But the expectation is
-        // that the set of triangles with vertex orderings that we want to change is the smaller of the
-        // two sets when parsing completes (see getInconsistent below).
-        if ( mvec.dot(cvec) > 0)
-            _agreeFaces.push_back(fid);
-        else
-            _disagreeFaces.push_back(fid);
-    }   // end parseTriangle
-
-    // The "inconsistent" faces is the set that is smaller since we don't know which side
-    // was the "correct" side to start on when we initiated the parsing of faces on this manifold.
-    const std::vector<int> &getInconsistent() const
-    {
-        const std::vector<int> *efids = &_agreeFaces;
-        if ( _disagreeFaces.size() < _agreeFaces.size())
-            efids = &_disagreeFaces;
-        return *efids;
-    }   // end getInconsistent
-
-private:
-    // Vectors that will hold the ids of the faces with normals calculated from their stored
-    // indices that either do or don't agree with the normals calculated using the obtained
-    // vertex order from r3d::FaceParser.
-    std::vector<int> _agreeFaces;
-    std::vector<int> _disagreeFaces;
-};  // end struct
-
-
-struct ManifoldBoundaryParser : r3d::BoundaryParser
-{
-    ManifoldBoundaryParser( const r3d::Manifold &m) : _manf(m)
-    {
-#ifndef NDEBUG
-        std::cerr << "Manifold edge count: " << _manf.edges().size() << std::endl;
-        std::cerr << "Manifold face count: " << _manf.faces().size() << std::endl;
-        std::cerr << "Manifold vtxs count: " << _manf.vertices().size() << std::endl;
-        std::cerr << "Manifold bnds count: " << _manf.boundaries().count() << std::endl;
-#endif
-    }   // end ctor
-
-    // Only go beyond this edge if e is not a boundary edge on this (or another) manifold.
-    bool parseEdge( int fid, const r3d::Vec2i &e, int&) override
-    {
-        assert( _manf.faces().count( fid) > 0);
-        const r3d::Mesh &mesh = _manf.mesh();
-        const int eid = mesh.edgeId(e);
-        return _manf.edges().count(eid) == 0 && mesh.nsfaces(eid) <= 2;
-    }   // end parseEdge
-
-private:
-    const r3d::Manifold &_manf;
-};  // end struct
-
-}   // end namespace
-
-
 int ActionFixNormals::fixNormals( FM *fm)
 {
-    const r3d::Mesh& mesh = fm->mesh();
-    const r3d::Manifolds &manfs = fm->manifolds();
+    int nfixed = 0;
     bool twisted = false;
-    IntSet efids;
-
-    // Parse each manifold in turn finding which faces agree and which don't.
-    const int nm = int(manfs.count());
-    for ( int i = 0; i < nm; ++i)
+    bool swapped = false;
+    while ( !swapped)
     {
-        r3d::FaceParser fparser( mesh);
-
-        NormalAgreementParser naparser;
-        fparser.addTriangleParser( &naparser);
-
-        ManifoldBoundaryParser boundaryParser( manfs[i]);
-        fparser.setBoundaryParser( &boundaryParser);
-
-        const int sfid = *manfs[i].faces().begin();
-        fparser.parse( sfid);
-        // Only reverse the order if twisted returned false
-        if ( !fparser.twisted())
+        fm->lockForRead();
+        const std::shared_ptr<const r3d::Mesh> smesh = fm->meshPtr();
+        const NormalConsistency nc( fm->mesh(), fm->manifolds());
+        for ( int i : nc.twisted())
+            std::cerr << "[INFO] FaceTools::ActionFixNormals::fixNormals: Manifold " << i << " has a twisted surface" << std::endl;
+        nfixed = int(nc.inconsistent().size());
+        r3d::Mesh::Ptr mesh = nfixed > 0 ? nc.fixed() : nullptr;
+        twisted = !nc.twisted().empty();
+        fm->unlock();
+
+        if ( !mesh)
+            break;
+
+        // Only set the fixed mesh if the model's mesh wasn't replaced in the meantime
+        // (otherwise check again), taking the current transform in case it was moved.
+        fm->lockForWrite();
+        swapped = fm->meshPtr() == smesh;
+        if ( swapped)
         {
-            const std::vector<int> &fids = naparser.getInconsistent();
-            efids.insert( fids.begin(), fids.end());
+            mesh->setTransformMatrix( fm->transformMatrix());
+            fm->updateGeometry( mesh, false);
         }   // end if
-        else
-        {
-            std::cerr << "[INFO] FaceTools::ActionFixNormals::fixNormals: Manifold " << i << " has a twisted surface" << std::endl;
-            twisted = true;
-        }   // end else
-    }   // end for
-
-    if ( !efids.empty())
-    {
-        r3d::Mesh::Ptr mesh = fm->mesh().deepCopy();
-        for ( int fid : efids)
-            mesh->reverseFaceVertices(fid);
-        fm->update( mesh, false, false);
-    }   // end if
+        fm->unlock();
+    }   // end while
 
-    return twisted ? -1 * int(efids.size()) : int(efids.size());
+    return twisted ? -1 * nfixed : nfixed;
 }   // end fixNormals
 
 
 void ActionFixNormals::doAction( Event)
 {
-    FM* fm = MS::selectedModel();
-    fm->lockForWrite();
-    _nfixed = fixNormals( fm);
-    fm->unlock();
+    _nfixed = fixNormals( MS::selectedModel());
 }   // end doAction
 
 
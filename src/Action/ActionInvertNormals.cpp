@@ -47,7 +47,7 @@ void ActionInvertNormals::doAction( Event)
     fm->lockForWrite();
     r3d::Mesh::Ptr mesh = fm->mesh().deepCopy();
     mesh->invertNormals();
-    fm->update( mesh, false, false);
+    fm->updateGeometry( mesh, false);
     fm->unlock();
 }   // end doAction
 
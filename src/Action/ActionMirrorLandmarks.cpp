@@ -87,24 +87,51 @@ void updateLandmark( FM &fm, int lmid, FaceSide fs, const Vec3f &pos)
 void centreMedialLandmarks( FM &fm)
 {
     // Set all the medial landmark positions to be at X=0 and iteratively reposition
-    // them until change in the x position is <= MAX_XPOS_DIFF.
+    // them until change in the x position is <= MAX_XPOS_DIFF. The landmarks still
+    // to converge are projected back to the surface together in a single batch.
     const r3d::KDTree &kdt = fm.kdtree();
     const Landmark::LandmarkSet &lmks = fm.currentLandmarks();
     static const float MAX_XPOS_DIFF = 1.0e-8f;
     static const size_t MAX_ITERATIONS = 10;
     const std::unordered_map<int, r3d::Vec3f>& mlmks = lmks.lateral( MID);
+
+    std::vector<int> lmids;
+    std::vector<r3d::Vec3f> pts;
+    std::vector<size_t> active;  // Indices into pts not yet converged
     for ( const auto &p : mlmks)
     {
-        r3d::Vec3f pos = p.second;
-        size_t i = 0;
-        while ( (fabsf(pos[0]) > MAX_XPOS_DIFF) && (i < MAX_ITERATIONS))
+        if ( fabsf(p.second[0]) > MAX_XPOS_DIFF)
+            active.push_back( pts.size());
+        lmids.push_back( p.first);
+        pts.push_back( p.second);
+    }   // end for
+
+    std::vector<r3d::Vec3f> apts;
+    for ( size_t i = 0; i < MAX_ITERATIONS && !active.empty(); ++i)
+    {
+        apts.resize( active.size());
+        for ( size_t j = 0; j < active.size(); ++j)
         {
-            pos[0] = 0.0f;
-            pos = FaceTools::toSurface( kdt, pos);
-            i++;
-        }   // end while
-        pos[0] = 0.0f;
-        updateLandmark( fm, p.first, MID, pos);
+            apts[j] = pts[active[j]];
+            apts[j][0] = 0.0f;
+        }   // end for
+
+        FaceTools::toSurface( kdt, apts, apts);
+
+        size_t k = 0;
+        for ( size_t j = 0; j < active.size(); ++j)
+        {
+            pts[active[j]] = apts[j];
+            if ( fabsf(apts[j][0]) > MAX_XPOS_DIFF)
+                active[k++] = active[j];
+        }   // end for
+        active.resize( k);
+    }   // end for
+
+    for ( size_t i = 0; i < pts.size(); ++i)
+    {
+        pts[i][0] = 0.0f;
+        updateLandmark( fm, lmids[i], MID, pts[i]);
     }   // end for
 }   // end centreMedialLandmarks
 
@@ -53,7 +53,7 @@ void ActionReflectModel::saveState( UndoState &us) const
 
 void ActionReflectModel::restoreState( const UndoState &us)
 {
-    us.model()->update( us.userData("Mesh").value<r3d::Mesh::Ptr>(), false, false);
+    us.model()->updateGeometry( us.userData("Mesh").value<r3d::Mesh::Ptr>(), false);
     us.model()->setAssessment( us.userData("Ass").value<FaceAssessment::Ptr>());
 }   // end restoreState
 
@@ -121,7 +121,7 @@ void ActionReflectModel::doAction( Event)
     mesh->invertNormals();
     mesh->fixTransformMatrix();
 
-    fm->update( mesh, false, false);
+    fm->updateGeometry( mesh, false);
     if ( mask)
     {
         swapMaskLaterals( *mask);           // So that post reflection the vertex IDs are on the same laterals
@@ -17,14 +17,254 @@
 
 #include <Action/ActionRemesh.h>
 #include <FaceModel.h>
-#include <VertexAdder.h>   // r3d
+#include <FaceTools.h>
+#include <QMutex>
+#include <algorithm>
+#include <unordered_map>
+#include <cfloat>
+#include <climits>
+#include <cmath>
+#include <map>
+#include <array>
 using FaceTools::Action::FaceAction;
 using FaceTools::Action::ActionRemesh;
 using FaceTools::Action::Event;
+using FaceTools::Vec2f;
+using FaceTools::Vec3f;
+using FaceTools::FM;
 using MS = FaceTools::ModelSelect;
+using r3d::Mesh;
 
 
-ActionRemesh::ActionRemesh( const QString& dn, const QIcon& ico) : FaceAction(dn, ico), _maxtarea(2.0)
+namespace {
+
+// Subdivision stops at this depth regardless of edge length (only reached for degenerate input).
+static const int MAX_DEPTH = 32;
+
+// The weights of an added corner's source vertices sum to this. Corners are only ever made at
+// the midpoints of others (to MAX_DEPTH) so the weights are exact.
+static const uint64_t ONE = uint64_t(1) << MAX_DEPTH;
+
+struct Corner
+{
+    int vidx;   // Source mesh vertex or -1 if added
+    Vec3f pos;
+    Vec2f uv;
+    std::array<int,3> svidxs;       // Vertices of the source face the corner is within
+    std::array<uint64_t,3> wts;     // Weights of svidxs giving the corner's position
+};  // end struct
+
+using Tri = std::array<Corner,3>;
+
+
+// Corners c0 and c1 must be within the same source face.
+Corner midpoint( const Corner &c0, const Corner &c1)
+{
+    // Addition is commutative so faces on either side of an edge make the same midpoint
+    // position and so split the halves of shared edges identically.
+    Corner m{ -1, 0.5f * (c0.pos + c1.pos), 0.5f * (c0.uv + c1.uv), c0.svidxs, {}};
+    for ( int k = 0; k < 3; ++k)
+        m.wts[k] = (c0.wts[k] + c1.wts[k]) / 2;
+    return m;
+}   // end midpoint
+
+
+// Subdivide the given triangle appending the subdivided triangles (with the same winding) to tris.
+// Whether an edge is split depends only on its length so neighbouring faces split shared edges
+// identically, and the split edges' halves are again shared.
+void subdivide( const Tri &t, float maxLen2, std::vector<Tri> &tris, int depth=0)
+{
+    std::array<bool,3> split;   // Edge k goes from corner k to corner k+1
+    int nsplit = 0;
+    for ( int k = 0; k < 3; ++k)
+    {
+        split[k] = depth < MAX_DEPTH && (t[(k+1)%3].pos - t[k].pos).squaredNorm() > maxLen2;
+        nsplit += split[k] ? 1 : 0;
+    }   // end for
+
+    if ( nsplit == 0)
+    {
+        tris.push_back(t);
+        return;
+    }   // end if
+
+    std::vector<Tri> stris;
+    if ( nsplit == 3)
+    {
+        const Corner m0 = midpoint( t[0], t[1]);
+        const Corner m1 = midpoint( t[1], t[2]);
+        const Corner m2 = midpoint( t[2], t[0]);
+        stris = {{t[0], m0, m2}, {m0, t[1], m1}, {m2, m1, t[2]}, {m0, m1, m2}};
+    }   // end if
+    else if ( nsplit == 1)
+    {
+        const int k = split[0] ? 0 : split[1] ? 1 : 2;
+        const Corner &a = t[k];
+        const Corner &b = t[(k+1)%3];
+        const Corner &c = t[(k+2)%3];
+        const Corner m = midpoint( a, b);
+        stris = {{a, m, c}, {m, b, c}};
+    }   // end else if
+    else
+    {
+        const int k = !split[2] ? 0 : !split[0] ? 1 : 2;    // Edges k and k+1 are split
+        const Corner &a = t[k];
+        const Corner &b = t[(k+1)%3];
+        const Corner &c = t[(k+2)%3];
+        const Corner mab = midpoint( a, b);
+        const Corner mbc = midpoint( b, c);
+        stris.push_back( {mab, b, mbc});
+        // Divide the remaining quad along its shorter diagonal
+        if ( (mbc.pos - a.pos).squaredNorm() <= (c.pos - mab.pos).squaredNorm())
+        {
+            stris.push_back( {a, mab, mbc});
+            stris.push_back( {a, mbc, c});
+        }   // end if
+        else
+        {
+            stris.push_back( {mab, mbc, c});
+            stris.push_back( {a, mab, c});
+        }   // end else
+    }   // end else
+
+    for ( const Tri &st : stris)
+        subdivide( st, maxLen2, tris, depth+1);
+}   // end subdivide
+
+
+Corner corner( const Mesh &mesh, int fid, int k, bool hasUVs)
+{
+    const int *fvidxs = mesh.fvidxs(fid);
+    Corner c{ fvidxs[k], mesh.uvtx(fvidxs[k]), hasUVs ? mesh.faceUV( fid, k) : Vec2f::Zero(),
+              {fvidxs[0], fvidxs[1], fvidxs[2]}, {0, 0, 0}};
+    c.wts[k] = ONE;
+    return c;
+}   // end corner
+
+
+// Identifies an added corner by its source vertices having nonzero weight (in ascending order)
+// and their weights. Corners added along a source edge have just that edge's two vertices so
+// the faces on either side of the edge (which may be in different partitions) share them.
+using AKey = std::array<int64_t,6>;
+AKey akey( const Corner &c)
+{
+    std::array<std::pair<int,uint64_t>,3> vws;
+    for ( int k = 0; k < 3; ++k)
+        vws[k] = c.wts[k] > 0 ? std::make_pair( c.svidxs[k], c.wts[k]) : std::make_pair( INT_MAX, uint64_t(0));
+    std::sort( vws.begin(), vws.end());
+    AKey key;
+    for ( int k = 0; k < 3; ++k)
+    {
+        key[2*k] = vws[k].first;
+        key[2*k+1] = int64_t(vws[k].second);
+    }   // end for
+    return key;
+}   // end akey
+
+}   // end namespace
+
+
+// public static
+Mesh::Ptr ActionRemesh::remesh( const Mesh &smesh, float maxTriangleArea, bool parallel)
+{
+    static const size_t MIN_BLOCK = 4096;   // Faces per partition
+
+    // Longest edge of an equilateral triangle having the maximum area
+    const float maxLen2 = 4.0f * maxTriangleArea / sqrtf(3.0f);
+    const bool hasUVs = smesh.hasMaterials();
+
+    // Partition the faces spatially into slabs along the axis of greatest extent
+    std::vector<int> fids( smesh.faces().begin(), smesh.faces().end());
+    std::vector<Vec3f> centres( smesh.numFaces());
+    Vec3f vmin = Vec3f::Constant( FLT_MAX);
+    Vec3f vmax = Vec3f::Constant( -FLT_MAX);
+    std::unordered_map<int, size_t> fpos;
+    for ( size_t i = 0; i < fids.size(); ++i)
+    {
+        const int *fvidxs = smesh.fvidxs(fids[i]);
+        centres[i] = (smesh.uvtx(fvidxs[0]) + smesh.uvtx(fvidxs[1]) + smesh.uvtx(fvidxs[2])) / 3;
+        vmin = vmin.cwiseMin( centres[i]);
+        vmax = vmax.cwiseMax( centres[i]);
+        fpos[fids[i]] = i;
+    }   // end for
+    int axis = 0;
+    (vmax - vmin).maxCoeff( &axis);
+    std::sort( fids.begin(), fids.end(), [&]( int f0, int f1)
+    {
+        const float c0 = centres[fpos.at(f0)][axis];
+        const float c1 = centres[fpos.at(f1)][axis];
+        return c0 < c1 || (c0 == c1 && f0 < f1);
+    });
+
+    // Subdivide the partitions (each a contiguous range of the sorted faces)
+    std::map<size_t, std::vector<Tri> > parts;
+    QMutex partsLock;
+    const auto subdividePart = [&]( size_t i0, size_t i1)
+    {
+        std::vector<Tri> tris;
+        for ( size_t i = i0; i < i1; ++i)
+        {
+            const int fid = fids[i];
+            const Tri t = {corner( smesh, fid, 0, hasUVs), corner( smesh, fid, 1, hasUVs), corner( smesh, fid, 2, hasUVs)};
+            subdivide( t, maxLen2, tris);
+        }   // end for
+        partsLock.lock();
+        parts[i0].swap( tris);
+        partsLock.unlock();
+    };  // end subdividePart
+
+    if ( parallel)
+        FaceTools::parallelFor( fids.size(), subdividePart, MIN_BLOCK);
+    else
+        subdividePart( 0, fids.size());
+
+    // Merge the partitions keeping the connected source vertices (in order) and merging
+    // the vertices added along the seams by their source vertices and weights.
+    Mesh::Ptr mesh = Mesh::create();
+    std::vector<int> svids;
+    svids.reserve( 3*fids.size());
+    for ( int fid : fids)
+        svids.insert( svids.end(), smesh.fvidxs(fid), smesh.fvidxs(fid) + 3);
+    std::sort( svids.begin(), svids.end());
+    svids.erase( std::unique( svids.begin(), svids.end()), svids.end());
+    std::unordered_map<int, int> vmap;  // Source vertices to new vertices
+    for ( int svidx : svids)
+        vmap[svidx] = mesh->addVertex( smesh.uvtx(svidx));
+
+    const int mid = hasUVs ? mesh->addMaterial( smesh.texture( *smesh.materialIds().begin())) : -1;
+    std::map<AKey, int> amap;   // Added vertices
+    for ( const auto &part : parts)
+    {
+        for ( const Tri &t : part.second)
+        {
+            int vidxs[3];
+            for ( int k = 0; k < 3; ++k)
+            {
+                const Corner &c = t[k];
+                if ( c.vidx >= 0)
+                    vidxs[k] = vmap.at(c.vidx);
+                else
+                {
+                    const AKey key = akey( c);
+                    auto it = amap.find( key);
+                    if ( it == amap.end())
+                        it = amap.insert( {key, mesh->addVertex( c.pos)}).first;
+                    vidxs[k] = it->second;
+                }   // end else
+            }   // end for
+
+            const int fid = mesh->addFace( vidxs[0], vidxs[1], vidxs[2]);
+            if ( fid >= 0 && mid >= 0)
+                mesh->setOrderedFaceUVs( mid, fid, t[0].uv, t[1].uv, t[2].uv);
+        }   // end for
+    }   // end for
+
+    mesh->setTransformMatrix( smesh.transformMatrix());
+    return mesh;
+}   // end remesh
+
+
+ActionRemesh::ActionRemesh( const QString& dn, const QIcon& ico) : FaceAction(dn, ico), _maxtarea(2.0f), _swapped(false)
 {
     setAsync(true);
 }   // end ctor
@@ -43,22 +283,46 @@ bool ActionRemesh::doBeforeAction( Event)
     return true;
 }   // end doBeforeAction
 
+
 void ActionRemesh::doAction( Event)
 {
     FM* fm = MS::selectedModel();
-    fm->lockForWrite();
-    r3d::Mesh::Ptr model = fm->mesh()->deepCopy(true);
-    r3d::VertexAdder vadder( model);
-    vadder.subdivideAndMerge( maxTriangleArea());
-    //vadder.addVerticesToMaxTriangleArea( maxTriangleArea());
-    fm->update(model);
-    fm->moveLandmarksToSurface();
+    fm->lockForRead();
+    std::shared_ptr<const Mesh> smesh = fm->meshPtr();
+    const Mesh::Ptr cmesh = smesh->deepCopy();
     fm->unlock();
+
+    // The model's mesh can be transformed in place so subdivide a copy without holding the lock
+    Mesh::Ptr mesh = remesh( *cmesh, maxTriangleArea());
+
+    // Leave the model as it is if cancelled while subdividing
+    _swapped = false;
+    if ( isCancelled())
+        return;
+
+    // Only swap in the remeshed model if the mesh wasn't replaced while subdividing,
+    // taking the current transform in case the model was moved in the meantime.
+    FM::WPtr wfm = fm->scopedWriteLock();
+    _swapped = wfm->meshPtr() == smesh;
+    if ( _swapped)
+    {
+        mesh->setTransformMatrix( wfm->transformMatrix());
+        wfm->update( mesh, true, true);
+    }   // end if
 }   // end doAction
 
 
-Event ActionRemesh::doAfterAction()
+Event ActionRemesh::doAfterAction( Event)
 {
+    if ( !_swapped)
+    {
+        scrapLastUndo( MS::selectedModel(), this);  // The model wasn't changed
+        if ( isCancelled())
+            MS::showStatus( "Remeshing cancelled.", 5000);
+        else
+            MS::showStatus( "Remeshing abandoned since the model changed!", 5000);
+        return Event::NONE;
+    }   // end if
     MS::showStatus( "Finished remeshing model.", 5000);
     return _ev;
 }   // end doAfterAction
@@ -108,17 +108,8 @@ bool ActionRemoveManifolds::doBeforeAction( Event)
 
 void ActionRemoveManifolds::doAction( Event)
 {
-    FM* fm = MS::selectedModel();
-    fm->lockForWrite();
-    const Mat4f T = fm->transformMatrix();
-    r3d::Copier copier( fm->mesh());
-    const IntSet& fids = fm->manifolds()[_mid].faces();
-    for ( int fid : fids)
-        copier.add(fid);
-    r3d::Mesh::Ptr mobj = copier.copiedMesh();
-    fm->update( mobj, true, true);
-    fm->addTransformMatrix( T);
-    fm->unlock();
+    FM::WPtr fm = MS::selectedModelScopedWrite();
+    fm->keepManifolds( {_mid});
 }   // end doAction
 
 
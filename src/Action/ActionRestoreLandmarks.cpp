@@ -26,6 +26,7 @@ using FaceTools::Action::ActionRestoreLandmarks;
 using FaceTools::Action::FaceAction;
 using FaceTools::Action::Event;
 using FaceTools::FM;
+using FaceTools::Vec3f;
 using FaceTools::Widget::LandmarksCheckDialog;
 using MS = FaceTools::ModelSelect;
 using LMAN = FaceTools::Landmark::LandmarksManager;
@@ -105,28 +106,52 @@ void updateVisualisation( const FM &fm, const IntSet &ulmks)
 }   // end namespace
 
 
-bool ActionRestoreLandmarks::restoreLandmark( FM &fm, int lmid, int aid)
+namespace {
+
+// Restore the given landmarks from the mask on the given assessments in a single surface projection.
+void restoreFromMask( FM &fm, const IntSet &lmids, const IntSet &aids)
 {
-    if ( !fm.hasMask())
-        return false;
+    using MaskReg = FaceTools::MaskRegistration;
+    const r3d::Mesh &msk = fm.mask();
 
-    FaceAssessment::Ptr ass = fm.assessment(aid);
-    assert( ass);
-    Landmark::LandmarkSet &lmset = ass->landmarks();
+    std::vector<FaceTools::Landmark::SpecificLandmark> slmks;
+    std::vector<Vec3f> pts;
+    for ( int lmid : lmids)
+    {
+        if ( LMAN::isBilateral(lmid))
+        {
+            slmks.push_back( {lmid, FaceTools::LEFT});
+            slmks.push_back( {lmid, FaceTools::RIGHT});
+        }   // end if
+        else
+            slmks.push_back( {lmid, FaceTools::MID});
+    }   // end for
 
-    const r3d::Mesh &msk = fm.mask();
-    const r3d::KDTree &kdt = fm.kdtree();
+    pts.reserve( slmks.size());
+    for ( const auto &slmk : slmks)
+        pts.push_back( MaskReg::maskLandmarkPosition( msk, slmk.id, slmk.lat));
+    FaceTools::toSurface( fm.kdtree(), pts, pts);
 
-    using MaskReg = MaskRegistration;
-    if ( LMAN::isBilateral(lmid))
+    for ( int aid : aids)
     {
-        lmset.set( lmid, toSurface( kdt, MaskReg::maskLandmarkPosition( msk, lmid, LEFT)), LEFT);
-        lmset.set( lmid, toSurface( kdt, MaskReg::maskLandmarkPosition( msk, lmid, RIGHT)), RIGHT);
-    }   // end if
-    else
-        lmset.set( lmid, toSurface( kdt, MaskReg::maskLandmarkPosition( msk, lmid, MID)), MID);
+        FaceTools::FaceAssessment::Ptr ass = fm.assessment(aid);
+        assert( ass);
+        FaceTools::Landmark::LandmarkSet &lmset = ass->editLandmarks();
+        for ( size_t i = 0; i < slmks.size(); ++i)
+            lmset.set( slmks[i].id, pts[i], slmks[i].lat);
+    }   // end for
 
     fm.setMetaSaved(false);
+}   // end restoreFromMask
+
+}   // end namespace
+
+
+bool ActionRestoreLandmarks::restoreLandmark( FM &fm, int lmid, int aid)
+{
+    if ( !fm.hasMask())
+        return false;
+    restoreFromMask( fm, {lmid}, {aid});
     return true;
 }   // end restoreLandmark
 
@@ -136,8 +161,7 @@ bool ActionRestoreLandmarks::restoreLandmarks( FM &fm, const IntSet &ulmks, bool
     if ( !fm.hasMask())
         return false;
 
-    for ( int lmid : ulmks)
-        restoreLandmark( fm, lmid, -1); // Just the current assessment
+    restoreFromMask( fm, ulmks, {-1}); // Just the current assessment
 
     if ( uvis)
         updateVisualisation( fm, ulmks);
@@ -159,9 +183,8 @@ bool ActionRestoreLandmarks::restoreMissingLandmarks( FM &fm)
         if ( !lmset.has(lmid))
             mlmks.insert(lmid);
 
-    for ( int aid : fm.assessmentIds())
-        for ( int lmid : mlmks)
-            restoreLandmark( fm, lmid, aid);
+    if ( !mlmks.empty())
+        restoreFromMask( fm, mlmks, fm.assessmentIds());
 
     return !mlmks.empty();
 }   // end restoreMissingLandmarks
@@ -43,7 +43,7 @@ int landmarkFromMousePos( const QPoint &mp)
     const FV *fv = MS::selectedView();
     FaceSide lat;
     const vtkProp *prop = fv->viewer()->getPointedAt( mp);
-    return lmksHandler->visualisation().landmarkId( fv, prop, lat);
+    return lmksHandler->visualisation().landmarkId( fv, prop, mp, lat);
 }   // end landmarkFromMousePos
 }   // end namespace
 
@@ -0,0 +1,48 @@
+/************************************************************************
+ * Copyright (C) 2021 SIS Research Ltd & Richard Palmer
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ ************************************************************************/
+
+#include <Action/ActionShowNormalConsistency.h>
+#include <Vis/NormalConsistencyVisualisation.h>
+using FaceTools::Action::ActionShowNormalConsistency;
+using FaceTools::Action::ActionVisualise;
+using FaceTools::Action::Event;
+
+
+ActionShowNormalConsistency::ActionShowNormalConsistency( const QString& dn, const QIcon& ico, const QKeySequence &ks)
+    : ActionVisualise( dn, ico, new Vis::NormalConsistencyVisualisation, ks)
+{
+    addPurgeEvent( Event::MESH_CHANGE | Event::MASK_CHANGE);
+    addRefreshEvent( Event::SURFACE_DATA_CHANGE);
+}   // end ctor
+
+
+QString ActionShowNormalConsistency::toolTip() const
+{
+    return "Colour the faces of the model by the consistency of their normals.";
+}   // end toolTip
+
+
+QString ActionShowNormalConsistency::whatsThis() const
+{
+    QStringList htxt;
+    htxt << "Colours faces having normals consistent with their neighbours white,";
+    htxt << "faces having normals inconsistent with their neighbours pink, and the";
+    htxt << "faces of manifolds twisted onto themselves (where no consistent ordering";
+    htxt << "of normals is possible) red. Inconsistent normals can be fixed using the";
+    htxt << "fix normals action.";
+    return htxt.join(" ");
+}   // end whatsThis
@@ -16,15 +16,18 @@
  ************************************************************************/
 
 #include <Action/ActionSmooth.h>
-#include <FaceModelCurvatureStore.h>
 #include <FaceModelViewer.h>
 #include <FaceModel.h>
+#include <FaceTools.h>
 #include <QMessageBox>
-#include <r3d/Smoother.h>
+#include <unordered_map>
+#include <algorithm>
+#include <cassert>
 using FaceTools::Action::FaceAction;
 using FaceTools::Action::ActionSmooth;
 using FaceTools::Action::Event;
 using FaceTools::Action::UndoState;
+using FaceTools::Vec3f;
 using MS = FaceTools::ModelSelect;
 using QMB = QMessageBox;
 
@@ -45,7 +48,7 @@ ActionSmooth::ActionSmooth( const QString& dn, const QIcon& ico) : FaceAction(dn
 
 bool ActionSmooth::isAllowed( Event)
 {
-    return MS::isViewSelected() && FaceModelCurvatureStore::rvals( *MS::selectedModel());
+    return MS::isViewSelected();
 }   // end isAllowed
 
 
@@ -89,20 +92,210 @@ bool ActionSmooth::doBeforeAction( Event)
 }   // end doBeforeAction
 
 
+namespace {
+
+// Moves vertices along their normals towards the centroids of their neighbours while their
+// curvature exceeds a threshold. Each iteration moves all vertices above the threshold
+// concurrently (computing their new positions from the previous iteration's positions)
+// and then recalculates the curvature for just the moved vertices and their neighbours.
+class ParallelSmoother
+{
+public:
+    explicit ParallelSmoother( const r3d::Mesh &mesh)
+        : _mesh(mesh), _pos( mesh.numVtxs()), _vfaces( mesh.numVtxs()), _vnbrs( mesh.numVtxs()),
+          _border( mesh.numVtxs(), false), _curv( mesh.numVtxs(), 0.0f)
+    {
+        assert( mesh.hasSequentialIds());
+        const int N = int(_pos.size());
+        for ( int i = 0; i < N; ++i)
+            _pos[i] = mesh.uvtx(i);
+
+        std::unordered_map<int64_t, int> ecounts;   // Faces per edge
+        for ( int fid : mesh.faces())
+        {
+            const int *fvidxs = mesh.fvidxs(fid);
+            for ( int k = 0; k < 3; ++k)
+            {
+                const int v0 = fvidxs[k];
+                const int v1 = fvidxs[(k+1)%3];
+                _vfaces[v0].push_back(fid);
+                _vnbrs[v0].push_back(v1);
+                _vnbrs[v1].push_back(v0);
+                ecounts[int64_t(std::min(v0,v1)) << 32 | std::max(v0,v1)]++;
+            }   // end for
+        }   // end for
+
+        for ( const auto &p : ecounts)
+            if ( p.second == 1)
+                _border[int(p.first >> 32)] = _border[int(p.first & 0xffffffff)] = true;
+
+        FaceTools::parallelFor( _pos.size(), [this]( size_t i0, size_t i1)
+        {
+            for ( size_t i = i0; i < i1; ++i)
+            {
+                std::sort( _vnbrs[i].begin(), _vnbrs[i].end());
+                _vnbrs[i].erase( std::unique( _vnbrs[i].begin(), _vnbrs[i].end()), _vnbrs[i].end());
+            }   // end for
+        }, 1024);
+    }   // end ctor
+
+    // Smooth until no vertex has curvature above maxc or until maxi iterations have been
+    // done. Returns the number of iterations done.
+    size_t operator()( float maxc, size_t maxi)
+    {
+        const size_t N = _pos.size();
+        FaceTools::parallelFor( N, [this]( size_t i0, size_t i1)
+        {
+            for ( size_t i = i0; i < i1; ++i)
+                _curv[i] = _curvature(int(i));
+        }, 1024);
+
+        std::vector<char> dirty( N, 0);
+        _moved.assign( N, 0);
+        size_t its = 0;
+        for ( ; its < maxi; ++its)
+        {
+            std::vector<int> active;
+            for ( size_t i = 0; i < N; ++i)
+                if ( _curv[i] > maxc)
+                    active.push_back( int(i));
+            if ( active.empty())    // Converged
+                break;
+
+            std::vector<Vec3f> npos( active.size());
+            FaceTools::parallelFor( active.size(), [&]( size_t i0, size_t i1)
+            {
+                for ( size_t i = i0; i < i1; ++i)
+                    npos[i] = _smoothed( active[i]);
+            }, 256);
+
+            // Curvature changes for the moved vertices and their neighbours only
+            std::vector<int> update;
+            for ( size_t i = 0; i < active.size(); ++i)
+            {
+                const int vidx = active[i];
+                _pos[vidx] = npos[i];
+                _moved[vidx] = 1;
+                if ( !dirty[vidx])
+                {
+                    dirty[vidx] = 1;
+                    update.push_back(vidx);
+                }   // end if
+                for ( int nvidx : _vnbrs[vidx])
+                {
+                    if ( !dirty[nvidx])
+                    {
+                        dirty[nvidx] = 1;
+                        update.push_back(nvidx);
+                    }   // end if
+                }   // end for
+            }   // end for
+
+            FaceTools::parallelFor( update.size(), [&]( size_t i0, size_t i1)
+            {
+                for ( size_t i = i0; i < i1; ++i)
+                    _curv[update[i]] = _curvature( update[i]);
+            }, 256);
+
+            for ( int vidx : update)
+                dirty[vidx] = 0;
+        }   // end for
+
+        return its;
+    }   // end operator()
+
+    // Set the positions of just the moved vertices in the given mesh (which must have the same vertex ids).
+    void apply( r3d::Mesh &mesh) const
+    {
+        for ( size_t i = 0; i < _moved.size(); ++i)
+            if ( _moved[i])
+                mesh.adjustRawVertex( int(i), _pos[i][0], _pos[i][1], _pos[i][2]);
+    }   // end apply
+
+private:
+    const r3d::Mesh &_mesh;
+    std::vector<Vec3f> _pos;
+    std::vector<std::vector<int> > _vfaces;
+    std::vector<std::vector<int> > _vnbrs;
+    std::vector<bool> _border;
+    std::vector<float> _curv;
+    std::vector<char> _moved;
+
+    // Sets the unit normal at vidx and the vector from vidx to the centroid of its neighbours,
+    // returning the mean squared distance to the neighbours (zero if vidx cannot be moved).
+    float _umbrella( int vidx, Vec3f &n, Vec3f &u) const
+    {
+        const std::vector<int> &nbrs = _vnbrs[vidx];
+        if ( _border[vidx] || nbrs.empty())
+            return 0.0f;
+
+        n = Vec3f::Zero();
+        for ( int fid : _vfaces[vidx])
+        {
+            const int *fvidxs = _mesh.fvidxs(fid);
+            const Vec3f &v0 = _pos[fvidxs[0]];
+            n += (_pos[fvidxs[1]] - v0).cross( _pos[fvidxs[2]] - v0);   // Area weighted
+        }   // end for
+        const float nlen = n.norm();
+        if ( nlen == 0.0f)
+            return 0.0f;
+        n /= nlen;
+
+        const Vec3f &p = _pos[vidx];
+        Vec3f c = Vec3f::Zero();
+        float r2 = 0.0f;
+        for ( int nvidx : nbrs)
+        {
+            c += _pos[nvidx];
+            r2 += (_pos[nvidx] - p).squaredNorm();
+        }   // end for
+        u = c / float(nbrs.size()) - p;
+        return r2 / float(nbrs.size());
+    }   // end _umbrella
+
+    // Approximate absolute mean curvature at vidx (the reciprocal of the radius of the sphere
+    // through the vertex's neighbours) since for neighbours at distance d the displacement
+    // of their centroid along the normal is about d^2/2R on a sphere of radius R.
+    float _curvature( int vidx) const
+    {
+        Vec3f n, u;
+        const float r2 = _umbrella( vidx, n, u);
+        return r2 > 0.0f ? 2.0f * fabsf( u.dot(n)) / r2 : 0.0f;
+    }   // end _curvature
+
+    // Returns the position of vidx moved along its normal to the plane through its neighbours' centroid.
+    Vec3f _smoothed( int vidx) const
+    {
+        Vec3f n, u;
+        if ( _umbrella( vidx, n, u) <= 0.0f)
+            return _pos[vidx];
+        return _pos[vidx] + u.dot(n) * n;
+    }   // end _smoothed
+};  // end class
+
+}   // end namespace
+
+
+size_t ActionSmooth::smooth( r3d::Mesh &mesh, double maxc, size_t maxi)
+{
+    ParallelSmoother smoother( mesh);
+    const size_t its = smoother( float(maxc), maxi);
+    smoother.apply( mesh);
+    return its;
+}   // end smooth
+
+
 void ActionSmooth::doAction( Event)
 {
     FM::WPtr fm = MS::selectedModelScopedWrite();
     r3d::Mesh::Ptr mesh = fm->mesh().deepCopy();
-    FaceModelCurvatureStore::WPtr cmap = FaceModelCurvatureStore::wvals( *fm);
-    // Updates curvature data for the mesh but should be reconstructed anyway
-    // so no need to call updateArrays.
-    r3d::Smoother( maxCurvature(), maxIterations())( *mesh, cmap->vals());
-    fm->update( mesh, false, true);
+    _nits = smooth( *mesh, maxCurvature(), maxIterations());
+    fm->updateGeometry( mesh, true);
 }   // end doAction
 
 
 Event ActionSmooth::doAfterAction( Event)
 {
-    MS::showStatus("Finished smooth.", 5000);
+    MS::showStatus( QString("Finished smooth after %1 iteration%2.").arg(_nits).arg( _nits != 1 ? "s" : ""), 5000);
     return _ev;
 }   // end doAfterAction
@@ -47,31 +47,37 @@ public:
 
     void update()
     {
-        cameraStart();
+        _start();
         if ( _ivwr)
             cameraMove();
-        cameraStop();
+        _stop();
     }   // end update
 
     bool isSynching() const { return _issync;}
     void setSynching( bool v) { _issync = v;}
 
 protected:
+    // Show low detail proxies in the viewers being rendered while the camera moves.
     void cameraStart() override
     {
-        _ivwr = MS::selectedViewer();
-        _setPickingEnabled( false);
-        if ( isSynching() && _ivwr)
-            for ( ModelViewer* v : MS::viewers())
-                if ( v != _ivwr)
-                    _sset.push_back(v);
+        _start();
+        if ( _ivwr)
+            _lset.push_back(_ivwr);
+        for ( ModelViewer* v : _sset)
+            _lset.push_back( static_cast<FMV*>(v));
+        for ( FMV* v : _lset)
+            v->setLowDetail( true);
     }   // end cameraStart
 
     void cameraStop() override
     {
-        _setPickingEnabled( true);
-        _ivwr = nullptr;
-        _sset.clear();
+        for ( FMV* v : _lset)
+        {
+            v->setLowDetail( false);
+            v->updateRender();
+        }   // end for
+        _lset.clear();
+        _stop();
     }   // end cameraStop
 
     void cameraMove() override
@@ -108,6 +114,24 @@ private:
     bool _issync;
     FMV* _ivwr;
     std::vector<ModelViewer*> _sset;
+    std::vector<FMV*> _lset;
+
+    void _start()
+    {
+        _ivwr = MS::selectedViewer();
+        _setPickingEnabled( false);
+        if ( isSynching() && _ivwr)
+            for ( ModelViewer* v : MS::viewers())
+                if ( v != _ivwr)
+                    _sset.push_back(v);
+    }   // end _start
+
+    void _stop()
+    {
+        _setPickingEnabled( true);
+        _ivwr = nullptr;
+        _sset.clear();
+    }   // end _stop
 
     static void _setPickingEnabled( bool v)
     {
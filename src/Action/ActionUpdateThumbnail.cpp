@@ -18,12 +18,8 @@
 #include <Action/ActionUpdateThumbnail.h>
 #include <Action/ActionOrientCamera.h>
 #include <FaceModelCurvatureStore.h>
-#include <Vis/FaceView.h>
+#include <Vis/OffscreenRenderer.h>
 #include <FaceModel.h>
-#include <r3dvis/OffscreenMeshViewer.h>
-#include <QTools/QImageTools.h>
-#include <vtkPointData.h>
-#include <vtkProperty.h>
 using FaceTools::Action::ActionUpdateThumbnail;
 using FaceTools::Action::FaceAction;
 using FaceTools::Action::Event;
@@ -72,34 +68,30 @@ QImage ActionUpdateThumbnail::generateImage( const FM *fm, const QSize &sz, floa
 QImage ActionUpdateThumbnail::generateImage( const FM *fm, const r3d::Mesh &mesh,
                                                 const QSize &sz, float fov, float dscale)
 {
-    // This function used to be an instance member function (now static). The note
-    // below relates to when it was a member function:
-    // "Don't make offscreen viewer a private member - VTK on Windows hangs in r3dvis::extractBGR
-    // if exec in diff thread. Note that this issue doesn't arise if omv is a private member and
-    // its snapshot function is called in the GUI thread."
-    r3dvis::OffscreenMeshViewer omv( cv::Size(sz.width(), sz.height()));
-    omv.setBackgroundColour( 1.0f, 1.0f, 1.0f);
-
-    vtkActor *actor = omv.setModel( mesh);  // Create the actor in the viewer
-    // Add normals for smooth lighting interpolation
-    const auto rptr = FaceModelCurvatureStore::rvals( *fm);
-    if ( rptr)
-        r3dvis::getPolyData( actor)->GetPointData()->SetNormals( rptr->normals());
-
-    vtkProperty *prop = actor->GetProperty();
-    prop->SetInterpolationToPhong();
-    if ( !mesh.hasMaterials())
-    {
-        static const QColor COL = Vis::FV::BASECOL;
-        prop->SetColor( COL.redF(), COL.greenF(), COL.blueF());
-    }   // end if
-
-    omv.setCamera( ActionOrientCamera::makeFrontCamera( *fm, fov, dscale));
-	const cv::Mat img = omv.snapshot(); // Breaks in separate thread if omv not constructed every time
-	return QTools::copyOpenCV2QImage( img);
+    return generateImages( {{fm, &mesh, sz}}, fov, dscale).front();
 }   // end generateImage
 
 
+// static
+std::vector<QImage> ActionUpdateThumbnail::generateImages( const std::vector<ImageRequest> &ireqs, float fov, float dscale)
+{
+    // Rendering happens on the offscreen renderer's dedicated thread (whose viewers are
+    // never used from any other thread) so this can be called from any thread.
+    std::vector<FaceModelCurvatureStore::RPtr> rptrs;   // Held until rendered
+    std::vector<Vis::OffscreenRenderer::Request> reqs( ireqs.size());
+    for ( size_t i = 0; i < ireqs.size(); ++i)
+    {
+        const FM *fm = ireqs[i].fm;
+        rptrs.push_back( FaceModelCurvatureStore::rvals( *fm));
+        reqs[i].mesh = ireqs[i].mesh;
+        reqs[i].normals = rptrs.back() ? rptrs.back()->normals().Get() : nullptr;
+        reqs[i].camera = ActionOrientCamera::makeFrontCamera( *fm, fov, dscale);
+        reqs[i].size = ireqs[i].size;
+    }   // end for
+    return Vis::OffscreenRenderer::render( reqs);
+}   // end generateImages
+
+
 void ActionUpdateThumbnail::setThumbnailSize( const QSize &sz) { _vsz = sz;}
 
 
@@ -53,6 +53,7 @@ void CameraWorker::start()
     _hangle = 0.0f;
     _vangle = 0.0f;
 
+    _viewer->setLowDetail( true);  // Show proxies while rotating
     _timer = new QTimer(this);
     connect( _timer, &QTimer::timeout, this, &CameraWorker::createFrame);
     _timer->start( mspf);
@@ -62,7 +63,11 @@ void CameraWorker::start()
 void CameraWorker::stop()
 {
     if ( _timer)
+    {
         delete _timer;
+        _viewer->setLowDetail( false);
+        _viewer->updateRender();
+    }   // end if
     _timer = nullptr;
 }   // end stop
 
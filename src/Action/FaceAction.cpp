@@ -47,7 +47,8 @@ void FaceAction::_pinit()
 {
     _doasync = false;
     _isWorking = false;
-    _key = 0;
+    _workModel = nullptr;
+    _job = nullptr;
     _unlocked = true;
     _pevents = _tevents = _revents = Event::NONE;
     if ( _dname.isEmpty())
@@ -210,17 +211,18 @@ bool FaceAction::execute( Event e)
     }   // end if
 
     _isWorking = true;
+    _workModel = MS::selectedModel();
 
     if ( isAsync())
     {
         if (_PRINT_STAGE)
             std::cerr << " <<<NEW THREAD>>>" << std::endl;
-        if ( e == Event::USER)
-            _key = MS::lockSelect();
-        FaceActionWorker *worker = new FaceActionWorker( this, e);
-        connect( worker, &FaceActionWorker::onWorkFinished, this, &FaceAction::_endExecute);
-        connect( worker, &FaceActionWorker::finished, worker, &FaceActionWorker::deleteLater);
-        worker->start();   // Asynchronous start
+        _job = new FaceActionWorker( this, e);   // Bound to the selected model
+        connect( _job, &FaceActionWorker::onWorkFinished, this, &FaceAction::_endExecute);
+        connect( _job, &FaceActionWorker::onWorkCancelled, this, &FaceAction::_cancelExecute);
+        connect( _job, &FaceActionWorker::onWorkFinished, _job, &FaceActionWorker::deleteLater);
+        connect( _job, &FaceActionWorker::onWorkCancelled, _job, &FaceActionWorker::deleteLater);
+        _job->start();   // Asynchronous start
     }   // end else
     else
     {
@@ -248,25 +250,43 @@ void FaceAction::endNow()
 }   // end endNow
 
 
+bool FaceAction::isCancelled() const { return _job && _job->isCancelled();}
+
+
 // private slot
 void FaceAction::_endExecute( Event e)   // Always in GUI thread
 {
     _isWorking = false;
-    if ( _key != 0)
-    {
-        MS::unlockSelect(_key); // Unlock ability to change selected view now that asynchronous action done
-        _key = 0;
-    }   // end if
+    _workModel = nullptr;
+    // Asynchronous actions finish on the model they were bound to when executed
+    FM *pfm = _job ? MS::bindSelected( _job->model()) : nullptr;
     Event fev = doAfterAction( e);
+    if ( _job)
+        MS::bindSelected( pfm);
     _mpos = QPoint(-1,-1);
 #ifndef NDEBUG
     std::cerr << _dbgPrfx << " Finished " << debugName() << " emits " << fev << std::endl;
 #endif
     refresh( fev);
-    emit onEvent( fev);
+    emit onEvent( fev); // FaceActionManager handles the event for the job's model if set
+    _job = nullptr;
 }   // end _endExecute
 
 
+// private slot
+void FaceAction::_cancelExecute()   // Always in GUI thread
+{
+    _isWorking = false;
+    _workModel = nullptr;
+    _job = nullptr;
+    _mpos = QPoint(-1,-1);
+    if (_PRINT_STAGE)
+        std::cerr << _dbgPrfx << " Cancelled " << debugName() << std::endl;
+    refresh();
+    emit onEvent( Event::CANCEL);
+}   // end _cancelExecute
+
+
 void FaceAction::saveState( UndoState&) const
 {
     std::cerr << "[ERROR] FaceTools::Action::FaceAction::saveState: [" << debugName() << "] "
@@ -23,6 +23,8 @@
 #include <Metric/MetricManager.h>
 #include <FaceModel.h>
 #include <Vis/FaceView.h>
+#include <QElapsedTimer>
+#include <QTimer>
 #include <functional>
 #include <algorithm>
 #include <cassert>
@@ -62,15 +64,30 @@ void applyFnToModels( const Event &e, FM* fm, const std::function<void( FM*)> &f
     }   // end else
 }   // end applyFnToModels
 
+
+// Indices of the dispatch statistics for the flags of the given event (0 if none).
+std::vector<size_t> statIndices( Event e)
+{
+    std::vector<size_t> idxs;
+    const uint32_t bits = uint32_t(e);
+    for ( size_t i = 0; i < 32; ++i)
+        if ( bits & (1u << i))
+            idxs.push_back( i+1);
+    if ( idxs.empty())
+        idxs.push_back( 0);
+    return idxs;
+}   // end statIndices
+
 }   // end namespace
 
 
 FaceActionManager::Ptr FaceActionManager::s_singleton;
 
 
-FaceActionManager::FaceActionManager() : _lvl(0)
+FaceActionManager::FaceActionManager() : _flushQueued(false), _lvl(0)
 {
-    connect( this, &FaceActionManager::_selfRaise, this, &FaceActionManager::_doRaise);
+    resetDispatchStats();
+    connect( this, &FaceActionManager::_selfRaise, this, &FaceActionManager::_onRaise);
 }   // end ctor
 
 
@@ -88,6 +105,7 @@ QAction* FaceActionManager::registerAction( FaceAction* act, QWidget *parentWidg
 {
     std::vector<FaceAction*>& acts = get()->_actions;
     acts.push_back(act);
+    get()->_dispatches.clear();
     act->addRefreshEvent( Event::MODEL_SELECT | Event::CLOSED_MODEL);
     act->_init( parentWidget);    // No more events added after this
     return act->qaction();
@@ -104,7 +122,7 @@ void FaceActionManager::finalise()
     {
         FaceAction *act = acts.at(i);
         act->refresh();
-        connect( act, &FaceAction::onEvent, fam, &FaceActionManager::_doRaise);
+        connect( act, &FaceAction::onEvent, fam, &FaceActionManager::_onRaise);
         connect( act, &FaceAction::onShowHelp, [fam](const QString& tok){ emit fam->onShowHelp(tok);});
     }   // end for
     const Interactor::SelectNotifier *sn = MS::selectNotifier();
@@ -122,6 +140,10 @@ FaceTools::Vis::FV* FaceActionManager::close( const FM *fm)
     for ( FaceAction* act : acts)
         act->purge( fm);
     fm->unlock();
+    // Triggers deferred until actions finish working on other models are dropped for this model
+    std::vector<Deferred> &dfrd = fam->_deferred;
+    dfrd.erase( std::remove_if( dfrd.begin(), dfrd.end(), [fm]( const Deferred &d){ return d.fm == fm;}), dfrd.end());
+
     MS::remove(fm); // Removes views which ordinarily would cause Event::MODEL_SELECT but signal is blocked
     MM::purge(fm);  // Removes cached metric calculation data
     FMM::close(*fm);
@@ -155,29 +177,225 @@ FaceTools::Vis::FV* FaceActionManager::close( const FM *fm)
 void FaceActionManager::raise( Event E)
 {
     // emit to queue in the signal handling thread.
-    // Don't call _doRaise directly since the client might
+    // Don't call _onRaise directly since the client might
     // have called raise from a non-GUI thread.
     emit get()->_selfRaise( E);
 }   // end raise
 
 
-void FaceActionManager::_doRaise( Event E)
+// static
+size_t FaceActionManager::raisedCount( Event e)
+{
+    const FaceActionManager *fam = get();
+    size_t n = 0;
+    for ( size_t i : statIndices(e))
+        n += fam->_nraised[i];
+    return n;
+}   // end raisedCount
+
+
+// static
+size_t FaceActionManager::dispatchedCount( Event e)
+{
+    const FaceActionManager *fam = get();
+    size_t n = 0;
+    for ( size_t i : statIndices(e))
+        n += fam->_ndispatched[i];
+    return n;
+}   // end dispatchedCount
+
+
+// static
+double FaceActionManager::dispatchTime( Event e)
+{
+    const FaceActionManager *fam = get();
+    double msecs = 0;
+    for ( size_t i : statIndices(e))
+        msecs += fam->_msecs[i];
+    return msecs;
+}   // end dispatchTime
+
+
+// static
+void FaceActionManager::resetDispatchStats()
+{
+    FaceActionManager *fam = get();
+    fam->_nraised.fill(0);
+    fam->_ndispatched.fill(0);
+    fam->_msecs.fill(0);
+}   // end resetDispatchStats
+
+
+void FaceActionManager::_onRaise( Event E)
+{
+    for ( size_t i : statIndices(E))
+        _nraised[i]++;
+
+    // NOTE sact may be null since a FaceAction may not be causing this call!
+    FaceAction* sact = qobject_cast<FaceAction*>( sender());
+
+    // A finished (or cancelled) action may have deferred triggers waiting for it
+    if ( sact && !sact->isWorking() && !_deferred.empty())
+        _queueFlush();
+
+    if ( E == Event::CANCEL)
+        return;
+
+    // Events from finishing asynchronous actions are for the model they worked on.
+    FM *fm = sact && sact->_job ? sact->_job->model() : MS::selectedModel();
+
+    // Events raised while handling others are handled immediately since the
+    // recursion checks for the handling of the originating event must apply.
+    if ( _lvl > 0)
+    {
+        _dispatchFor( sact, fm, E);
+        return;
+    }   // end if
+
+    // Otherwise the event is handled immediately unless the same event from the same source
+    // and for the same model has already been handled in this iteration of the event loop,
+    // in which case it's part of a burst and is handled (once) on the next iteration.
+    const auto same = [sact, fm, E]( const Raised &r){ return r.sender == sact && r.fm == fm && r.event == E;};
+    if ( std::none_of( _dispatched.begin(), _dispatched.end(), same))
+    {
+        _dispatched.push_back( {sact, fm, E});
+        _queueFlush();  // Ends the burst on the next iteration
+        _dispatchFor( sact, fm, E);
+        return;
+    }   // end if
+
+    if ( std::none_of( _pending.begin(), _pending.end(), same))
+        _pending.push_back( {sact, fm, E});
+    _queueFlush();
+}   // end _onRaise
+
+
+void FaceActionManager::_queueFlush()
+{
+    if ( !_flushQueued)
+    {
+        _flushQueued = true;
+        QTimer::singleShot( 0, this, &FaceActionManager::_flush);
+    }   // end if
+}   // end _queueFlush
+
+
+void FaceActionManager::_flush()
+{
+    std::vector<Raised> pending;
+    pending.swap( _pending);
+    _dispatched.clear();
+    _flushQueued = false;
+    for ( const Raised &r : pending)
+        _dispatchFor( r.sender, r.fm, r.event);
+    _runDeferred();
+}   // end _flush
+
+
+void FaceActionManager::_defer( FaceAction *act, FM *fm, Event E)
+{
+    auto it = std::find_if( _deferred.begin(), _deferred.end(),
+                            [act, fm]( const Deferred &d){ return d.action == act && d.fm == fm;});
+    if ( it != _deferred.end())
+        it->event |= E;
+    else
+        _deferred.push_back( {act, fm, E});
+}   // end _defer
+
+
+void FaceActionManager::_runDeferred()
+{
+    // Trigger (in the order deferred) the actions that have since finished working.
+    // Actions started here are busy again so any others deferred for them stay deferred.
+    std::vector<Deferred> deferred;
+    deferred.swap( _deferred);
+    bool ran = false;
+    for ( const Deferred &d : deferred)
+    {
+        if ( d.action->isWorking())
+            _deferred.push_back( d);
+        else if ( FMM::opened().count(d.fm) > 0)
+        {
+            FM *pfm = MS::bindSelected( d.fm);
+            d.action->execute( d.event);
+            MS::bindSelected( pfm);
+            ran = true;
+        }   // end else if
+    }   // end for
+
+    if ( ran)
+    {
+        MS::refreshHandlers();
+        emit onUpdateSelected();
+    }   // end if
+}   // end _runDeferred
+
+
+void FaceActionManager::_dispatchFor( FaceAction *sact, FM *fm, Event E)
+{
+    // Events for a model other than the selected one (raised by asynchronous actions finishing)
+    // are handled with that model bound as the selected model. Closed models are ignored.
+    const FM *sfm = MS::selectedModel();
+    if ( !fm || fm == sfm || FMM::opened().count(fm) == 0)
+    {
+        _doRaise( sact, E);
+        return;
+    }   // end if
+
+    FM *pfm = MS::bindSelected( fm);
+    _doRaise( sact, E);
+    MS::bindSelected( pfm);
+
+    // Actions and handlers were refreshed against the bound model so refresh them for the selected one.
+    if ( _lvl == 0)
+    {
+        MS::refreshHandlers();
+        for ( FaceAction *act : _actions)
+            if ( !act->isWorking())
+                act->refresh( Event::MODEL_SELECT);
+        emit onUpdateSelected();
+    }   // end if
+}   // end _dispatchFor
+
+
+const FaceActionManager::Dispatch& FaceActionManager::_dispatch( Event E)
+{
+    const auto it = _dispatches.find( uint32_t(E));
+    if ( it != _dispatches.end())
+        return it->second;
+
+    Dispatch &d = _dispatches[uint32_t(E)];
+    for ( FaceAction *act : _actions)
+    {
+        if ( act->purges( E))
+            d.purgers.push_back( act);
+        if ( act->triggers( E)) // Triggers take precedence
+            d.responders.push_back( {act, true});
+        else if ( act->refreshes( E))
+            d.responders.push_back( {act, false});
+    }   // end for
+    return d;
+}   // end _dispatch
+
+
+void FaceActionManager::_doRaise( FaceAction *sact, Event E)
 {
     FM* fm = MS::selectedModel();
     assert( fm || FMM::numOpen() == 0);
     if ( E == Event::CANCEL)
         return;
 
+    QElapsedTimer timer;
+    timer.start();
+    const Dispatch &dispatch = _dispatch( E);
+
     // The sending action should not be triggered by its own events (note that
     // executed actions always refresh their own state upon completion).
-    // NOTE sact may be null since a FaceAction may not be causing this call!
-    FaceAction* sact = qobject_cast<FaceAction*>( sender());
-
     if ( fm && E != Event::NONE)
     {
         // Purge actions first.
-        for ( FaceAction *act : _actions)
-            if ( act != sact && act->purges( E) && !act->isWorking())
+        for ( FaceAction *act : dispatch.purgers)
+            if ( act != sact && !act->isWorking())
                 act->purge( fm);
         if ( has( E, Event::MESH_CHANGE))
         {
@@ -199,35 +417,35 @@ void FaceActionManager::_doRaise( Event E)
 
     if ( E != Event::NONE)
     {
-        for ( FaceAction *act : _actions)
+        // Actions that have already been acted upon (or that are scheduled
+        // for refresh already) are ignored to prevent recursion - only
+        // the event info is updated for when the action refreshes.
+        // Actions are not reentrant so running actions are ignored
+        // (they refresh at the end of their action in any case) unless
+        // triggered for a model other than the one they're working on,
+        // in which case they're triggered for it once they finish.
+        for ( auto &p : _acted)
+            if ( p.first && !p.first->isWorking())
+                p.second |= E;
+
+        for ( const auto &r : dispatch.responders)
         {
-            // Actions are not reentrant so running actions are ignored
-            // (they refresh at the end of their action in any case).
+            FaceAction *act = r.first;
             if ( act->isWorking())
-                continue;
-
-            // Actions that have already been acted upon (or that are scheduled
-            // for refresh already) are ignored to prevent recursion - only
-            // the event info is updated for when the action refreshes.
-            if ( _acted.count(act) > 0)
             {
-                _acted[act] |= E;
+                if ( r.second && fm && !act->isWorking( fm) && act != sact)
+                    _defer( act, fm, E);
                 continue;
             }   // end if
-
-            if ( act->triggers( E)) // Triggers take precedence
-            {
+            if ( _acted.count(act) > 0)
+                continue;
+            if ( r.second)
                 tacts.push_back(act);
-                _acted[act] = E;
-            }   // end if
-            else if ( act->refreshes( E))
-            {
+            else
                 racts.push_back(act);
-                _acted[act] = E;
-            }   // end else if
+            _acted[act] = E;
         }   // end for
     }   // end if
-
     const std::string chevrons( ++_lvl, '>');
 
     // Actions triggered for immediate response by the received action (if we have any)
@@ -272,4 +490,11 @@ void FaceActionManager::_doRaise( Event E)
         MS::updateRender();
         emit onUpdateSelected();
     }   // end if
+
+    const double msecs = 1e-6 * timer.nsecsElapsed();
+    for ( size_t i : statIndices(E))
+    {
+        _ndispatched[i]++;
+        _msecs[i] += msecs;
+    }   // end for
 }   // end _doRaise
@@ -17,83 +17,182 @@
 
 #include <Action/FaceActionWorker.h>
 #include <Action/FaceAction.h>
+#include <FileIO/FaceModelManager.h>
 #include <ModelSelect.h>
+#include <QDateTime>
+#include <QFileInfo>
+#include <algorithm>
 using FaceTools::Action::FaceActionWorker;
 using FaceTools::Action::FaceAction;
 using FaceTools::Action::Event;
+using FMM = FaceTools::FileIO::FaceModelManager;
 using MS = FaceTools::ModelSelect;
 
 
-int FaceActionWorker::_s_userWorkCount(0);
 QMutex FaceActionWorker::_s_mutex;
+std::list<FaceActionWorker*> FaceActionWorker::_s_jobs;
+QTimer *FaceActionWorker::_s_timer(nullptr);
+QToolButton *FaceActionWorker::_s_cancel(nullptr);
 
 
 FaceActionWorker::FaceActionWorker( FaceAction* worker, Event e)
-    : QThread(worker), _worker(worker), _event(e), _timer(nullptr), _tcount(0)
+    : _worker(worker), _event(e), _fm( MS::selectedModel()), _started(false),
+      _priority( e == Event::USER ? WorkerPool::USER : WorkerPool::BACKGROUND),
+      _token( std::make_shared<WorkerPool::Token>()), _startTime(0)
 {
-    if ( e == Event::USER)
+    _name = worker->displayName();
+    if ( _fm)
+        _name += " on " + QFileInfo( FMM::filepath(*_fm)).fileName();
+
+    if ( !_s_timer)
+    {
+        _s_timer = new QTimer;
+        _s_timer->setTimerType( Qt::CoarseTimer);
+        QObject::connect( _s_timer, &QTimer::timeout, &FaceActionWorker::_showStatus);
+    }   // end if
+
+    if ( !_s_cancel && MS::statusBar())
     {
-        _s_mutex.lock();
-        _s_userWorkCount++;
-        _s_mutex.unlock();
-
-        MS::setCursor( Qt::CursorShape::BusyCursor);
-        _tcount = 0;
-        _timer = new QTimer(this);
-        _timer->setTimerType( Qt::CoarseTimer);
-        _status = MS::currentStatus();
-        connect( _timer, &QTimer::timeout, this, &FaceActionWorker::_doOnTimerInterval);
-        _timer->start( 1000);   // Once per second
+        _s_cancel = new QToolButton;
+        _s_cancel->setText( tr("Cancel"));
+        _s_cancel->setToolTip( tr("Cancel all working actions."));
+        _s_cancel->setAutoRaise( true);
+        _s_cancel->hide();
+        MS::statusBar()->addPermanentWidget( _s_cancel);
+        QObject::connect( _s_cancel, &QToolButton::clicked, [](){ FaceActionWorker::cancel( nullptr);});
     }   // end if
 }   // end ctor
 
 
 FaceActionWorker::~FaceActionWorker()
 {
-    _deleteTimer();
+    _s_mutex.lock();
+    _s_jobs.remove(this);
+    const bool done = _s_jobs.empty();
+    _s_mutex.unlock();
 
-    if ( _event == Event::USER)
+    if ( done)
     {
-        _s_mutex.lock();
-        _s_userWorkCount--;
-        assert( _s_userWorkCount >= 0);
-        _s_mutex.unlock();
-
-        MS::restoreCursor();
+        _s_timer->stop();
+        if ( _s_cancel)
+            _s_cancel->hide();
         MS::clearStatus();
     }   // end if
+    else
+        _showStatus();
 }   // end dtor
 
 
-void FaceActionWorker::run()    // thread function
+void FaceActionWorker::start()
+{
+    _s_mutex.lock();
+    // Only start now if no other unfinished job on this job's model
+    _started = !_fm || std::none_of( _s_jobs.begin(), _s_jobs.end(),
+                            [this]( const FaceActionWorker *w){ return w->_fm == _fm && w->_startTime >= 0;});
+    _s_jobs.push_back(this);
+    if ( _started)
+        _submit();
+    _s_mutex.unlock();
+
+    _showStatus();
+    if ( _s_cancel)
+        _s_cancel->show();
+    if ( !_s_timer->isActive())
+        _s_timer->start( 1000);   // Once per second
+}   // end start
+
+
+bool FaceActionWorker::isUserWorking()
+{
+    QMutexLocker lock( &_s_mutex);
+    return std::any_of( _s_jobs.begin(), _s_jobs.end(), []( const FaceActionWorker *w){ return w->_event == Event::USER;});
+}   // end isUserWorking
+
+
+bool FaceActionWorker::isWorking( const FM *fm)
 {
-    _worker->doAction( _event);
-    emit onWorkFinished( _event);
-}   // end run
+    QMutexLocker lock( &_s_mutex);
+    return std::any_of( _s_jobs.begin(), _s_jobs.end(), [fm]( const FaceActionWorker *w){ return !fm || w->_fm == fm;});
+}   // end isWorking
 
 
-void FaceActionWorker::_doOnTimerInterval()
+void FaceActionWorker::cancel()
 {
-    static const int MAX_TIME_OUT = 120;  // seconds
-    _tcount++;
-    if ( _tcount == MAX_TIME_OUT)
-    {
-        requestInterruption();
-        _status += " timed out!";
-        _deleteTimer();
+    _token->cancel();
+    if ( _startTime > 0)
         _worker->endNow();
-    }   // end if
-    else if ( _tcount < MAX_TIME_OUT)
-        _status += ".";
-    MS::showStatus( _status);
-}   // end _doOnTimerInterval
+}   // end cancel
 
 
-void FaceActionWorker::_deleteTimer()
+void FaceActionWorker::cancel( const FM *fm)
+{
+    std::vector<FaceActionWorker*> jobs;
+    _s_mutex.lock();
+    for ( FaceActionWorker *w : _s_jobs)
+        if ( !fm || w->_fm == fm)
+            jobs.push_back(w);
+    _s_mutex.unlock();
+    for ( FaceActionWorker *w : jobs)
+        w->cancel();
+}   // end cancel
+
+
+void FaceActionWorker::_submit()
 {
-    if ( _timer)
+    WorkerPool::run( [this]( const WorkerPool::Token&){ _run();}, _priority, _token);
+}   // end _submit
+
+
+void FaceActionWorker::_run()    // thread function
+{
+    const bool cancelled = isCancelled();
+    if ( !cancelled)
+    {
+        _startTime = QDateTime::currentMSecsSinceEpoch();
+        FM *pfm = MS::bindSelected( _fm);
+        _worker->doAction( _event);
+        MS::bindSelected( pfm);
+    }   // end if
+
+    // Start the next waiting job on the same model
+    _s_mutex.lock();
+    _startTime = -1;    // Finished
+    if ( _fm)
     {
-        delete _timer;
-        _timer = nullptr;
+        const auto it = std::find_if( _s_jobs.begin(), _s_jobs.end(),
+                            [this]( const FaceActionWorker *w){ return w->_fm == _fm && !w->_started;});
+        if ( it != _s_jobs.end())
+        {
+            (*it)->_started = true;
+            (*it)->_submit();
+        }   // end if
     }   // end if
-}   // _deleteTimer
+    _s_mutex.unlock();
+
+    if ( cancelled)
+        emit onWorkCancelled();
+    else
+        emit onWorkFinished( _event);
+}   // end _run
+
+
+void FaceActionWorker::_showStatus()
+{
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+    QStringList msgs;
+    _s_mutex.lock();
+    for ( const FaceActionWorker *w : _s_jobs)
+    {
+        const qint64 t0 = w->_startTime;
+        if ( t0 >= 0 && w->isCancelled())
+            msgs << QString("%1 (cancelling)").arg( w->_name);
+        else if ( t0 > 0)
+            msgs << QString("%1 (%2s)").arg( w->_name).arg( (now - t0) / 1000);
+        else if ( t0 == 0)
+            msgs << QString("%1 (waiting)").arg( w->_name);
+    }   // end for
+    _s_mutex.unlock();
+
+    if ( !msgs.isEmpty())
+        MS::showStatus( msgs.join(" | "));
+}   // end _showStatus
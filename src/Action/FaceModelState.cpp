@@ -23,6 +23,17 @@ using FaceTools::Action::Event;
 using FaceTools::FM;
 using MS = FaceTools::ModelSelect;
 
+namespace {
+
+// Rough estimate of the memory used by a mesh with its kd-tree.
+size_t _meshBytes( const r3d::Mesh &mesh)
+{
+    return mesh.numVtxs() * (2*sizeof(FaceTools::Vec3f) + 6*sizeof(int))
+         + mesh.numFaces() * (sizeof(FaceTools::Vec3f) + 6*sizeof(int));
+}   // end _meshBytes
+
+}   // end namespace
+
 
 FaceModelState::Ptr FaceModelState::create( FM* fm, Event e)
 {
@@ -49,16 +60,16 @@ void FaceModelState::_restoreMesh() const
 
 void FaceModelState::_saveBounds()
 {
-    const size_t n = _fm->_bnds.size();
-    _bnds.resize(n);
-    for ( size_t i = 0; i < n; ++i)
-        _bnds[i] = _fm->_bnds[i]->deepCopy();
+    // Shared with the model which copies its bounds before modifying them
+    _bnds = _fm->_bnds;
+    _fm->_bndsShared = true;
 }   // end _saveBounds
 
 
 void FaceModelState::_restoreBounds() const
 {
     _fm->_bnds = _bnds;
+    _fm->_bndsShared = true;
 }   // end _restoreBounds
 
 
@@ -149,6 +160,7 @@ void FaceModelState::_restoreCameras( const Event &egrp) const
 
 void FaceModelState::_saveAssessments()
 {
+    // Assessment copies share their data with the model's until modified
     _ass.clear();
     for ( const auto& a : _fm->_ass)
         _ass[a->id()] = a->deepCopy();
@@ -159,13 +171,31 @@ void FaceModelState::_saveAssessments()
 
 void FaceModelState::_restoreAssessments() const
 {
-    _fm->_ass = _ass;
-    _fm->_cass = _cass;
+    // Restore copies so this state is unaffected by subsequent changes to the model
+    _fm->_ass.clear();
+    for ( const auto& a : _ass)
+        _fm->_ass[a->id()] = a->deepCopy();
+    _fm->_cass = _fm->_ass[_cass->id()];
     _fm->remakeBounds();
     _restoreMetaData();
 }   // end _restoreAssessments
 
 
+size_t FaceModelState::bytes() const
+{
+    size_t nbytes = sizeof(FaceModelState);
+    // Meshes are split between their sharers (the model and other states)
+    if ( _mesh)
+        nbytes += _meshBytes( *_mesh) / std::max<long>( 1, _mesh.use_count());
+    if ( _mask)
+        nbytes += _meshBytes( *_mask) / std::max<long>( 1, _mask.use_count());
+    nbytes += _bnds.size() * sizeof(r3d::Bounds);
+    for ( const auto& a : _ass)
+        nbytes += a->bytes();
+    return nbytes;
+}   // end bytes
+
+
 FaceModelState::FaceModelState( FM* fm, Event egrp)
 {
     _fm = fm;
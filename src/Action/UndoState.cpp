@@ -31,9 +31,9 @@ void FaceTools::Action::storeUndo( const FaceAction* a, Event egrp, bool autoRes
 }   // end storeUndo
 
 
-void FaceTools::Action::scrapLastUndo( const FM *fm)
+void FaceTools::Action::scrapLastUndo( const FM *fm, const FaceAction *a)
 {
-    UndoStates::scrapLastUndo( fm);
+    UndoStates::scrapLastUndo( fm, a);
 }   // end scrapLastUndo
 
 
@@ -45,7 +45,8 @@ UndoState::Ptr UndoState::create( const FaceAction* a, Event egrp, bool autoRest
 
 UndoState::UndoState( const FaceAction* a, Event egrp, bool ar)
     : _action( const_cast<FaceAction*>(a)), _egrp(egrp), _autoRestore(ar),
-      _name(a->displayName()), _sfm( MS::selectedModel()) // Could be null
+      _name(a->displayName()), _sfm( MS::selectedModel()), // Could be null
+      _nbytes( sizeof(UndoState))
 {
     // If auto-restoring, backup the needed data elements otherwise the setUserData function will be used.
     if ( isAutoRestore())
@@ -67,6 +68,8 @@ UndoState::UndoState( const FaceAction* a, Event egrp, bool ar)
 
         for ( FM* fm : fms)
             _fstates.push_back( FaceModelState::create(fm, egrp));
+        for ( const auto& fstate : _fstates)
+            _nbytes += fstate->bytes();
     }   // end if
 }   // end ctor
 
@@ -28,7 +28,7 @@ using MS = FaceTools::ModelSelect;
 
 // static init
 UndoStates::Ptr UndoStates::_singleton;
-
+size_t UndoStates::s_maxBytes( size_t(512) << 20);
 
 UndoStates::Ptr UndoStates::get()
 {
@@ -42,12 +42,66 @@ void UndoStates::clear( const FM* fm) { get()->_clear(fm);}
 void UndoStates::_clear( const FM* fm)
 {
     assert(fm);
-    _stacks.erase(fm);
+    const auto it = _stacks.find(fm);
+    if ( it != _stacks.end())
+    {
+        _nbytes -= it->second.undoBytes + it->second.redoBytes;
+        _stacks.erase(it);
+    }   // end if
 }   // end _clear
 
 
 void UndoStates::clear() { get()->_clear();}
-void UndoStates::_clear() { _stacks.clear();}
+void UndoStates::_clear()
+{
+    _stacks.clear();
+    _nbytes = 0;
+}   // end _clear
+
+
+void UndoStates::setMaxBytes( size_t nbytes)
+{
+    s_maxBytes = nbytes;
+    UndoStates::Ptr us = get();
+    us->_mutex.lockForWrite();
+    us->_trimToMaxBytes();
+    us->_mutex.unlock();
+    emit us->onUpdated();
+}   // end setMaxBytes
+
+
+size_t UndoStates::bytes()
+{
+    UndoStates::Ptr us = get();
+    us->_mutex.lockForRead();
+    const size_t nbytes = us->_nbytes;
+    us->_mutex.unlock();
+    return nbytes;
+}   // end bytes
+
+
+void UndoStates::_trimToMaxBytes()
+{
+    // Each state's estimate is fixed when it's created so the running totals
+    // need only be adjusted by the estimates of the states discarded.
+    while ( _nbytes > s_maxBytes)
+    {
+        // Discard the oldest undo from the model with the most memory in its undos
+        Stacks *mstacks = nullptr;
+        for ( auto &p : _stacks)
+        {
+            if ( p.second.undos.size() >= 2 && (!mstacks || p.second.undoBytes > mstacks->undoBytes))
+                mstacks = &p.second;
+        }   // end for
+
+        if ( !mstacks)
+            break;
+        const size_t nbytes = mstacks->undos.back()->bytes();
+        mstacks->undos.pop_back();
+        mstacks->undoBytes -= nbytes;
+        _nbytes -= nbytes;
+    }   // end while
+}   // end _trimToMaxBytes
 
 
 void UndoStates::storeUndo( const FaceAction* a, Event e, bool autoRestore) { get()->_storeUndo(a, e, autoRestore);}
@@ -59,28 +113,48 @@ void UndoStates::_storeUndo( const FaceAction* a, Event e, bool autoRestore)
 
     _mutex.lockForWrite();
     Stacks& stacks = _stacks[us->model()];
+    _nbytes -= stacks.undoBytes + stacks.redoBytes;
     if ( stacks.undos.size() == MAX_RESTORES)
+    {
+        stacks.undoBytes -= stacks.undos.back()->bytes();
         stacks.undos.pop_back();
+    }   // end if
     stacks.undos.push_front( us);   // Push to undo stack
+    stacks.undoBytes += us->bytes();
     stacks.oldRedos = stacks.redos; // In case of scrapping - can roll back
+    stacks.oldRedoBytes = stacks.redoBytes;
     stacks.redos.clear(); // Clear the redo stack
+    stacks.redoBytes = 0;
+    _nbytes += stacks.undoBytes;
+    _trimToMaxBytes();
     _mutex.unlock();
     emit onUpdated();
 }   // end _storeUndo
 
 
-void UndoStates::scrapLastUndo( const FM *fm) { get()->_scrapLastUndo( fm);}
-void UndoStates::_scrapLastUndo( const FM *fm)
+void UndoStates::scrapLastUndo( const FM *fm, const FaceAction *a) { get()->_scrapLastUndo( fm, a);}
+void UndoStates::_scrapLastUndo( const FM *fm, const FaceAction *a)
 {
-    assert( _canUndo( fm));
+    assert( a || _canUndo( fm));
     _mutex.lockForWrite();
-    Stacks& stacks = _stacks.at(fm);
-    UndoState::Ptr ustate = stacks.undos.front();
-    stacks.undos.pop_front();
-    stacks.redos = stacks.oldRedos;
-    stacks.oldRedos.clear();
+    const auto it = _stacks.find(fm);
+    const bool scrap = it != _stacks.end() && !it->second.undos.empty()
+                    && (!a || it->second.undos.front()->action() == a);
+    if ( scrap)
+    {
+        Stacks& stacks = it->second;
+        _nbytes -= stacks.undoBytes + stacks.redoBytes;
+        stacks.undoBytes -= stacks.undos.front()->bytes();
+        stacks.undos.pop_front();
+        stacks.redos = stacks.oldRedos;
+        stacks.redoBytes = stacks.oldRedoBytes;
+        stacks.oldRedos.clear();
+        stacks.oldRedoBytes = 0;
+        _nbytes += stacks.undoBytes + stacks.redoBytes;
+    }   // end if
     _mutex.unlock();
-    emit onUpdated();
+    if ( scrap)
+        emit onUpdated();
 }   // end _scrapLastUndo
 
 
@@ -139,13 +213,18 @@ Event UndoStates::_undo( const FM *fm)
     Stacks& stacks = _stacks.at(fm);
     UndoState::Ptr ustate = stacks.undos.front();
     stacks.undos.pop_front();
+    stacks.undoBytes -= ustate->bytes();
+    _nbytes -= ustate->bytes();
 
     // Before restoring state, we save the current state for redo purposes
     UndoState::Ptr rstate = UndoState::create( ustate->action(), ustate->events(), ustate->isAutoRestore());
     if ( !ustate->isAutoRestore())
         ustate->action()->saveState( *rstate);
     stacks.redos.push_front( rstate);
+    stacks.redoBytes += rstate->bytes();
+    _nbytes += rstate->bytes();
     stacks.oldRedos.clear();
+    stacks.oldRedoBytes = 0;
     _mutex.unlock();
 
     Event e = ustate->restore();
@@ -163,11 +242,15 @@ Event UndoStates::_redo( const FM *fm)
     Stacks& stacks = _stacks.at( fm);
     UndoState::Ptr rstate = stacks.redos.front();
     stacks.redos.pop_front();
+    stacks.redoBytes -= rstate->bytes();
+    _nbytes -= rstate->bytes();
     // Before restoring state, we save the current state for undo purposes
     UndoState::Ptr ustate = UndoState::create( rstate->action(), rstate->events(), rstate->isAutoRestore());
     if ( !rstate->isAutoRestore())
         rstate->action()->saveState( *ustate);
     stacks.undos.push_front( ustate);
+    stacks.undoBytes += ustate->bytes();
+    _nbytes += ustate->bytes();
     _mutex.unlock();
 
     Event e = rstate->restore();
@@ -0,0 +1,245 @@
+/************************************************************************
+ * Copyright (C) 2021 SIS Research Ltd & Richard Palmer
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ ************************************************************************/
+
+#include <CohortDeviation.h>
+#include <FileIO/FaceModelXMLFileHandler.h>
+#include <FaceModel.h>
+#include <FaceTools.h>
+#include <r3d/ProcrustesSuperimposition.h>
+#include <r3dio/IOHelpers.h>
+#include <QTemporaryDir>
+#include <QDir>
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+using FaceTools::CohortDeviation;
+using FaceTools::MatX3f;
+using FaceTools::Vec3f;
+using FaceTools::Vec3d;
+using FaceTools::FM;
+
+namespace {
+
+MatX3f vertexRows( const r3d::Mesh &mask)
+{
+    assert( mask.hasSequentialIds());
+    const int NVTXS = int(mask.numVtxs());
+    MatX3f rows( NVTXS, 3);
+    for ( int vidx = 0; vidx < NVTXS; ++vidx)
+        rows.row(vidx) = mask.uvtx(vidx);
+    return rows;
+}   // end vertexRows
+
+
+// Return the source rows aligned with the target rows by Procrustes superimposition.
+MatX3f alignRows( const MatX3f &tgt, const MatX3f &src)
+{
+    const r3d::Mat4f T = r3d::ProcrustesSuperimposition( tgt, true)( src);
+    MatX3f arows( src.rows(), 3);
+    for ( int i = 0; i < int(src.rows()); ++i)
+        arows.row(i) = r3d::transform( T, Vec3f( src.row(i)));
+    return arows;
+}   // end alignRows
+
+
+// Read just the mask of the given 3DF file setting its hash. Returns null if no mask.
+r3d::Mesh::Ptr readMask( const QString &fname, size_t &maskHash)
+{
+    QTemporaryDir tdir;
+    if ( !tdir.isValid())
+        return nullptr;
+
+    // No thumbnail since pixmaps can only be used on the GUI thread
+    PTree tree;
+    QString err = FaceTools::FileIO::unzipArchive( fname, tdir.path(), tree);
+    double fversion;
+    QString meshfname, maskfname;
+    FM fm;
+    if ( !err.isEmpty() || !FaceTools::FileIO::importMetaData( fm, tree, fversion, meshfname, maskfname) || maskfname.isEmpty())
+    {
+        std::cerr << "[WARNING] FaceTools::CohortDeviation::addFiles: No mask read from " << fname.toStdString() << std::endl;
+        return nullptr;
+    }   // end if
+
+    r3d::Mesh::Ptr mask = r3dio::loadMesh( QDir(tdir.path()).filePath( maskfname).toStdString());
+    if ( mask && !mask->hasSequentialIds())
+        mask = mask->repackedCopy();
+    maskHash = fm.maskHash();
+    return mask;
+}   // end readMask
+
+}   // end namespace
+
+
+CohortDeviation::Ptr CohortDeviation::create() { return Ptr( new CohortDeviation);}
+
+
+CohortDeviation::CohortDeviation() : _maskHash(0), _n(0) {}
+
+
+bool CohortDeviation::add( const FM &fm)
+{
+    return fm.hasMask() && _add( fm.mask(), fm.maskHash());
+}   // end add
+
+
+size_t CohortDeviation::add( const std::vector<const FM*> &fms, bool parallel)
+{
+    return _addAll( fms.size(), [this, &fms]( size_t i){ return add( *fms[i]);}, parallel);
+}   // end add
+
+
+size_t CohortDeviation::addFiles( const QStringList &fnames, bool parallel)
+{
+    return _addAll( size_t(fnames.size()), [this, &fnames]( size_t i)
+    {
+        size_t maskHash = 0;
+        const r3d::Mesh::Ptr mask = readMask( fnames.at(int(i)), maskHash);
+        return mask && _add( *mask, maskHash);
+    }, parallel);
+}   // end addFiles
+
+
+// private
+size_t CohortDeviation::_addAll( size_t n, const std::function<bool( size_t)> &addItem, bool parallel)
+{
+    // Add serially until one is added so the reference mask is always the first that can be added
+    size_t i0 = 0;
+    bool added = false;
+    while ( i0 < n && !added)
+        added = addItem( i0++);
+    if ( !added)
+        return 0;
+
+    std::atomic<size_t> nadded(1);
+    const auto fn = [&]( size_t j0, size_t j1)
+    {
+        for ( size_t j = j0; j < j1; ++j)
+            if ( addItem( i0 + j))
+                nadded++;
+    };  // end fn
+    if ( parallel)
+        parallelFor( n - i0, fn);
+    else
+        fn( 0, n - i0);
+    return nadded;
+}   // end _addAll
+
+
+// private
+bool CohortDeviation::_add( const r3d::Mesh &mask, size_t maskHash)
+{
+    const MatX3f rows = vertexRows( mask);
+
+    _lock.lock();
+    if ( !_rmask)
+    {
+        _maskHash = maskHash;
+        _rmask = mask.deepCopy();
+        _rvtxs = rows;
+        _means.assign( size_t(rows.rows()), Vec3d::Zero());
+        _comoments.assign( size_t(rows.rows()), Eigen::Matrix3d::Zero());
+    }   // end if
+    const bool matches = maskHash == _maskHash && rows.rows() == _rvtxs.rows();
+    _lock.unlock();
+
+    if ( !matches)
+    {
+        std::cerr << "[WARNING] FaceTools::CohortDeviation::_add: Mask mismatch!" << std::endl;
+        return false;
+    }   // end if
+
+    // Alignment is the expensive part so is done outside the lock (_rvtxs is not changed once set)
+    const MatX3f arows = alignRows( _rvtxs, rows);
+
+    // Accumulate the mean and co-moment of each vertex (Welford's algorithm)
+    _lock.lock();
+    _n++;
+    for ( int i = 0; i < int(arows.rows()); ++i)
+    {
+        const Vec3d x = arows.row(i).transpose().cast<double>();
+        Vec3d &mean = _means[size_t(i)];
+        const Vec3d d = x - mean;
+        mean += d / double(_n);
+        _comoments[size_t(i)] += d * (x - mean).transpose();
+    }   // end for
+    _lock.unlock();
+    return true;
+}   // end _add
+
+
+size_t CohortDeviation::count() const
+{
+    _lock.lock();
+    const size_t n = _n;
+    _lock.unlock();
+    return n;
+}   // end count
+
+
+bool CohortDeviation::finish()
+{
+    _lock.lock();
+    if ( _n < 2)
+    {
+        _lock.unlock();
+        return false;
+    }   // end if
+
+    const int NVTXS = int(_means.size());
+    _mmask = _rmask->deepCopy();
+    for ( int vidx = 0; vidx < NVTXS; ++vidx)
+    {
+        const Vec3d &m = _means[size_t(vidx)];
+        _mmask->adjustRawVertex( vidx, float(m[0]), float(m[1]), float(m[2]));
+    }   // end for
+    _mvtxs = vertexRows( *_mmask);
+
+    // Variance along the normal n is n'Cn where C is the covariance of the vertex
+    _mnrms.resize( size_t(NVTXS));
+    _sds.resize( size_t(NVTXS));
+    for ( int vidx = 0; vidx < NVTXS; ++vidx)
+    {
+        const Vec3f nrm = _mmask->calcVertexNorm( vidx);
+        const Vec3d n = nrm.cast<double>();
+        const double var = n.dot( _comoments[size_t(vidx)] * n) / double(_n - 1);
+        _mnrms[size_t(vidx)] = nrm;
+        _sds[size_t(vidx)] = float( sqrt( std::max( var, 0.0)));
+    }   // end for
+    _lock.unlock();
+    return true;
+}   // end finish
+
+
+std::vector<float> CohortDeviation::zscores( const FM &fm) const
+{
+    assert( _mmask);
+    std::vector<float> zs;
+    if ( !_mmask || !fm.hasMask() || fm.maskHash() != _maskHash || int(fm.mask().numVtxs()) != int(_mvtxs.rows()))
+        return zs;
+
+    const MatX3f arows = alignRows( _mvtxs, vertexRows( fm.mask()));
+    zs.resize( size_t(arows.rows()), 0.0f);
+    for ( int i = 0; i < int(arows.rows()); ++i)
+    {
+        const float sd = _sds[size_t(i)];
+        if ( sd > 0.0f)
+            zs[size_t(i)] = Vec3f( arows.row(i) - _mvtxs.row(i)).dot( _mnrms[size_t(i)]) / sd;
+    }   // end for
+    return zs;
+}   // end zscores
+
@@ -19,6 +19,7 @@
 using FaceTools::FaceAssessment;
 using FaceTools::Landmark::LandmarkSet;
 using FaceTools::PathSet;
+using FaceTools::Path;
 using FaceTools::FM;
 using FaceTools::Vec3f;
 using FaceTools::Mat4f;
@@ -27,6 +28,45 @@ using FaceTools::Metric::MetricSet;
 
 namespace {
 const QString UNKNOWN_NAME = "Unknown";
+
+// Flags for the data an assessment may share with its copies.
+enum : int
+{
+    LANDMARKS_SHARED = 0x01,
+    PATHS_SHARED = 0x02,
+    METRICS_SHARED = 0x04,
+    METRICSL_SHARED = 0x08,
+    METRICSR_SHARED = 0x10,
+    ALL_SHARED = 0x1f
+};
+
+
+// Copy the pointed to data if flagged as shared so that it can be modified.
+template <typename T>
+T& _detach( std::shared_ptr<T> &p, std::atomic<int> &shared, int flag)
+{
+    if ( shared & flag)
+    {
+        p = std::make_shared<T>( *p);
+        shared &= ~flag;
+    }   // end if
+    return *p;
+}   // end _detach
+
+
+// Divide the given number of bytes among the sharers of p.
+template <typename T>
+size_t _share( const std::shared_ptr<T> &p, size_t nbytes)
+{
+    return nbytes / std::max<long>( 1, p.use_count());
+}   // end _share
+
+
+size_t _metricBytes( const MetricSet &mset)
+{
+    return sizeof(MetricSet) + mset.count() * (sizeof(FaceTools::Metric::MetricValue) + 4*sizeof(float));
+}   // end _metricBytes
+
 }   // end namespace
 
 
@@ -44,7 +84,42 @@ FaceAssessment::Ptr FaceAssessment::deepCopy() const
 
 
 // private
-FaceAssessment::FaceAssessment( int id) : _id(id), _assessor(UNKNOWN_NAME), _notes("") {}
+FaceAssessment::FaceAssessment( int id)
+    : _id(id), _assessor(UNKNOWN_NAME), _notes(""),
+      _landmarks( std::make_shared<LandmarkSet>()), _paths( std::make_shared<PathSet>()),
+      _metrics( std::make_shared<MetricSet>()), _metricsL( std::make_shared<MetricSet>()), _metricsR( std::make_shared<MetricSet>()),
+      _shared(0)
+{}
+
+
+// private
+FaceAssessment::FaceAssessment( const FaceAssessment &fa)
+    : _id(fa._id), _assessor(fa._assessor), _notes(fa._notes),
+      _landmarks(fa._landmarks), _paths(fa._paths),
+      _metrics(fa._metrics), _metricsL(fa._metricsL), _metricsR(fa._metricsR),
+      _shared(ALL_SHARED)
+{
+    fa._shared = ALL_SHARED;
+}   // end ctor
+
+
+size_t FaceAssessment::bytes() const
+{
+    size_t pbytes = sizeof(PathSet);
+    for ( int pid : _paths->ids())
+        pbytes += sizeof(Path) + _paths->path(pid).pathVertices().capacity() * sizeof(Vec3f);
+
+    return sizeof(FaceAssessment)
+         + _share( _landmarks, sizeof(LandmarkSet) + _landmarks->size() * sizeof(Vec3f))
+         + _share( _paths, pbytes)
+         + _share( _metrics, _metricBytes( *_metrics))
+         + _share( _metricsL, _metricBytes( *_metricsL))
+         + _share( _metricsR, _metricBytes( *_metricsR));
+}   // end bytes
+
+
+LandmarkSet &FaceAssessment::editLandmarks() { return _detach( _landmarks, _shared, LANDMARKS_SHARED);}
+PathSet &FaceAssessment::editPaths() { return _detach( _paths, _shared, PATHS_SHARED);}
 
 
 bool FaceAssessment::setAssessor( const QString &aname)
@@ -76,9 +151,10 @@ bool FaceAssessment::setNotes( const QString& notes)
 bool FaceAssessment::setLandmarks( const LandmarkSet &lmks)
 {
     bool setok = false;
-    if ( !_landmarks.empty() || !lmks.empty())
+    if ( !_landmarks->empty() || !lmks.empty())
     {
-        _landmarks = lmks;
+        _landmarks = std::make_shared<LandmarkSet>( lmks);
+        _shared &= ~LANDMARKS_SHARED;
         setok = true;
     }   // end if
     return setok;
@@ -87,24 +163,25 @@ bool FaceAssessment::setLandmarks( const LandmarkSet &lmks)
 
 void FaceAssessment::transform( const Mat4f &T, const Mat3f &iR)
 {
-    _paths.transform(T, &iR);
-    _landmarks.transform(T);
+    editPaths().transform(T, &iR);
+    editLandmarks().transform(T);
 }   // end transform
 
 
 void FaceAssessment::moveToSurface( const FM* fm)
 {
-    _landmarks.moveToSurface( fm);
-    _paths.update(fm);
+    editLandmarks().moveToSurface( fm);
+    editPaths().update(fm);
 }   // end moveToSurface
 
 
 bool FaceAssessment::setPaths( const PathSet &pths)
 {
     bool setok = false;
-    if ( !_paths.empty() || !pths.empty())
+    if ( !_paths->empty() || !pths.empty())
     {
-        _paths = pths;
+        _paths = std::make_shared<PathSet>( pths);
+        _shared &= ~PATHS_SHARED;
         setok = true;
     }   // end if
     return setok;
@@ -113,42 +190,42 @@ bool FaceAssessment::setPaths( const PathSet &pths)
 
 MetricSet &FaceAssessment::metrics( FaceSide fs)
 {
-    MetricSet *mset = &_metrics;
     if ( fs == FaceSide::LEFT)
-        mset = &_metricsL;
+        return _detach( _metricsL, _shared, METRICSL_SHARED);
     else if ( fs == FaceSide::RIGHT)
-        mset = &_metricsR;
-    return *mset;
+        return _detach( _metricsR, _shared, METRICSR_SHARED);
+    return _detach( _metrics, _shared, METRICS_SHARED);
 }   // end metrics
 
 
 const MetricSet &FaceAssessment::cmetrics( FaceSide fside) const
 {
-    const MetricSet *mset = &_metrics;
+    const MetricSet *mset = _metrics.get();
     if ( fside == FaceSide::LEFT)
-        mset = &_metricsL;
+        mset = _metricsL.get();
     else if ( fside == FaceSide::RIGHT)
-        mset = &_metricsR;
+        mset = _metricsR.get();
     return *mset;
 }   // end cmetrics
 
 
 bool FaceAssessment::hasMetric( int mid) const
 {
-    return _metrics.ids().count(mid) > 0 || _metricsL.ids().count(mid) > 0 || _metricsR.ids().count(mid) > 0;
+    return _metrics->ids().count(mid) > 0 || _metricsL->ids().count(mid) > 0 || _metricsR->ids().count(mid) > 0;
 }   // end hasMetric
 
 
 void FaceAssessment::clearMetrics()
 {
-    _metrics.reset();
-    _metricsL.reset();
-    _metricsR.reset();
+    _metrics = std::make_shared<MetricSet>();
+    _metricsL = std::make_shared<MetricSet>();
+    _metricsR = std::make_shared<MetricSet>();
+    _shared &= ~(METRICS_SHARED | METRICSL_SHARED | METRICSR_SHARED);
 }   // end clearMetrics
 
 
 bool FaceAssessment::hasContent() const
 {
     return (!_assessor.isEmpty() && _assessor != UNKNOWN_NAME) || !_notes.isEmpty()
-        || !_landmarks.empty() || !_paths.empty();
+        || !_landmarks->empty() || !_paths->empty();
 }   // end hasContent
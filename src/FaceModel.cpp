@@ -18,8 +18,12 @@
 #include <FaceModel.h>
 #include <FaceTools.h>
 #include <Vis/FaceView.h>
+#include <Vis/ModelGeometry.h>
+#include <r3d/Copier.h>
 #include <algorithm>
+#include <array>
 #include <cassert>
+#include <thread>
 using FaceTools::Path;
 using FaceTools::PathSet;
 using FaceTools::FaceModel;
@@ -37,13 +41,39 @@ int FaceModel::MAX_MANIFOLDS(1);
 
 namespace {
 static const float MATRIX_PRECISION = 1e-4f;
+
+
+#ifndef NDEBUG
+// Returns true iff the two meshes have the same vertex and face ids with each face
+// joining the same vertices (ignoring winding order so inverted faces are allowed).
+bool _sameConnectivity( const r3d::Mesh &m0, const r3d::Mesh &m1)
+{
+    if ( m0.numVtxs() != m1.numVtxs() || m0.numFaces() != m1.numFaces())
+        return false;
+    for ( int fid : m0.faces())
+    {
+        if ( m1.faces().count(fid) == 0)
+            return false;
+        const int *f0 = m0.fvidxs(fid);
+        const int *f1 = m1.fvidxs(fid);
+        std::array<int,3> v0 = {f0[0], f0[1], f0[2]};
+        std::array<int,3> v1 = {f1[0], f1[1], f1[2]};
+        std::sort( v0.begin(), v0.end());
+        std::sort( v1.begin(), v1.end());
+        if ( v0 != v1)
+            return false;
+    }   // end for
+    return true;
+}   // end _sameConnectivity
+#endif
+
 }   // end namespace
 
 
 FaceModel::FaceModel( r3d::Mesh::Ptr mesh)
     : _savedMeta(false), _savedModel(false), _source(""), _studyId(""), _subjectId(""), _imageId(""),
       _dob( QDate::currentDate()), _sex(FaceTools::UNKNOWN_SEX),
-      _methnicity(0), _pethnicity(0), _cdate( QDate::currentDate())
+      _methnicity(0), _pethnicity(0), _cdate( QDate::currentDate()), _bndsShared(false)
 {
     assert(mesh);
     setAssessment( FaceAssessment::create( 0));
@@ -54,7 +84,7 @@ FaceModel::FaceModel( r3d::Mesh::Ptr mesh)
 FaceModel::FaceModel()
     : _savedMeta(false), _savedModel(false), _source(""), _studyId(""), _subjectId(""), _imageId(""),
       _dob( QDate::currentDate()), _sex(FaceTools::UNKNOWN_SEX),
-      _methnicity(0), _pethnicity(0), _cdate( QDate::currentDate())
+      _methnicity(0), _pethnicity(0), _cdate( QDate::currentDate()), _bndsShared(false)
 {
     setAssessment( FaceAssessment::create(0));
 }   // end ctor
@@ -64,42 +94,45 @@ void FaceModel::update( r3d::Mesh::Ptr mesh, bool updateConnectivity, bool settl
 {
     assert( mesh);
 
-    if ( updateConnectivity)
+    if ( !updateConnectivity && _manifolds)  // Topology unchanged
     {
-        const size_t rverts = mesh->removeDisconnectedVertices();
-        /*
-        static const std::string imsg = "[INFO] FaceTools::FaceModel::update: ";
-        if ( rverts > 0)
-            std::cerr << imsg << "Removed " << rverts << " disconnected vertices\n";
-        */
+        updateGeometry( mesh, settleLandmarks);
+        return;
+    }   // end if
 
-        // Ensure that vertices are in sequential order.
-        if ( !mesh->hasSequentialIds())
-            mesh = mesh->repackedCopy();
+    const size_t rverts = mesh->removeDisconnectedVertices();
+    /*
+    static const std::string imsg = "[INFO] FaceTools::FaceModel::update: ";
+    if ( rverts > 0)
+        std::cerr << imsg << "Removed " << rverts << " disconnected vertices\n";
+    */
 
-        if ( mesh->numMats() > 1)  // Merge materials?
-            mesh->mergeMaterials();
+    // Ensure that vertices are in sequential order.
+    if ( !mesh->hasSequentialIds())
+        mesh = mesh->repackedCopy();
 
-        if ( maxManifolds <= 0)
-            maxManifolds = MAX_MANIFOLDS;
+    if ( mesh->numMats() > 1)  // Merge materials?
+        mesh->mergeMaterials();
 
-        r3d::Manifolds::Ptr manf = r3d::Manifolds::create( *mesh);
-        if ( int(manf->count()) > maxManifolds)
-        {
-            //std::cerr << imsg << "Reducing from " << manf->count() << " to " << maxManifolds << " manifolds...\n";
-            mesh = manf->reduceManifolds( maxManifolds);
-            manf = r3d::Manifolds::create( *mesh);
-        }   // end if
+    if ( maxManifolds <= 0)
+        maxManifolds = MAX_MANIFOLDS;
 
-        const int nm = static_cast<int>( manf->count());
-        for ( int i = 0; i < nm; ++i)
-        {
-            manf->at(i).boundaries();  // Causes boundary edges to be calculated
-            //const auto& bnds = manf->at(i).boundaries();  // Causes boundary edges to be calculated
-            //std::cerr << " - Manifold " << i << " has " << bnds.count() << " boundary edges\n";
-        }   // end for
-        _manifolds = manf;
-    }   // end updateConnectivity
+    r3d::Manifolds::Ptr manf = r3d::Manifolds::create( *mesh);
+    if ( int(manf->count()) > maxManifolds)
+    {
+        //std::cerr << imsg << "Reducing from " << manf->count() << " to " << maxManifolds << " manifolds...\n";
+        mesh = manf->reduceManifolds( maxManifolds);
+        manf = r3d::Manifolds::create( *mesh);
+    }   // end if
+
+    const int nm = static_cast<int>( manf->count());
+    for ( int i = 0; i < nm; ++i)
+    {
+        manf->at(i).boundaries();  // Causes boundary edges to be calculated
+        //const auto& bnds = manf->at(i).boundaries();  // Causes boundary edges to be calculated
+        //std::cerr << " - Manifold " << i << " has " << bnds.count() << " boundary edges\n";
+    }   // end for
+    _manifolds = manf;
 
     _mesh = mesh;
     _kdtree = r3d::KDTree::create( *_mesh);
@@ -109,11 +142,47 @@ void FaceModel::update( r3d::Mesh::Ptr mesh, bool updateConnectivity, bool settl
 }   // end update
 
 
+void FaceModel::updateGeometry( r3d::Mesh::Ptr mesh, bool settleLandmarks)
+{
+    assert( mesh);
+    assert( _manifolds);
+    assert( _sameConnectivity( *_mesh, *mesh));
+    _mesh = mesh;
+    // The search tree must be remade for the new vertex positions but the bounds
+    // don't depend on it so remake them on this thread at the same time.
+    std::thread kdtThread( [this](){ _kdtree = r3d::KDTree::create( *_mesh);});
+    remakeBounds();
+    kdtThread.join();
+    if ( settleLandmarks)
+        _moveToSurface();
+}   // end updateGeometry
+
+
+void FaceModel::keepManifolds( const IntSet &mids)
+{
+    assert( !mids.empty());
+    std::vector<int> smids( mids.begin(), mids.end());
+    std::sort( smids.begin(), smids.end());
+
+    r3d::Copier copier( *_mesh);
+    for ( int mid : smids)
+    {
+        assert( mid >= 0 && mid < int(_manifolds->count()));
+        for ( int fid : _manifolds->at(mid).faces())
+            copier.add(fid);
+    }   // end for
+
+    r3d::Mesh::Ptr mesh = copier.copiedMesh();
+    mesh->setTransformMatrix( transformMatrix());
+    update( mesh, true, true, int(smids.size()));
+}   // end keepManifolds
+
+
 void FaceModel::fixTransformMatrix()
 {
     r3d::Mesh::Ptr nmesh = _mesh->deepCopy();
     nmesh->fixTransformMatrix();
-    update( nmesh, false, false);
+    updateGeometry( nmesh, false);
     if ( _mask)
     {
         r3d::Mesh::Ptr nmask = _mask->deepCopy();
@@ -141,6 +210,7 @@ void FaceModel::remakeBounds()
     _bnds[0] = _bnds[1]->deepCopy();
     for ( size_t i = 2; i < nm+1; ++i)
         _bnds[0]->encompass(*_bnds[i]);
+    _bndsShared = false;
 
     setMetaSaved( false);
     setModelSaved( false);
@@ -154,8 +224,20 @@ Mat4f FaceModel::inverseTransformMatrix() const { return _mesh->inverseTransform
 bool FaceModel::isAligned() const { return transformMatrix().isIdentity( MATRIX_PRECISION);}
 
 
+void FaceModel::_detachBounds()
+{
+    if ( _bndsShared)
+    {
+        for ( auto& b : _bnds)
+            b = b->deepCopy();
+        _bndsShared = false;
+    }   // end if
+}   // end _detachBounds
+
+
 void FaceModel::_syncBoundsToAlignment()
 {
+    _detachBounds();
     Mat4f T = transformMatrix();
     for ( auto& b : _bnds)
         b->setTransformMatrix(T);
@@ -172,6 +254,7 @@ void FaceModel::addTransformMatrix( const Mat4f& T)
     for ( auto& ass : _ass)
         ass.get()->transform(T, iR);
     // Have to do it this way because the model may not yet have landmarks defined.
+    _detachBounds();
     for ( auto& b : _bnds)
         b->addTransformMatrix(T);
     setMetaSaved( false);
@@ -184,6 +267,8 @@ void FaceModel::eraseView( FV* fv) { _fvs.erase(fv);}
 
 void FaceModel::rebuildViews()
 {
+    // Convert the mesh once for all views to share
+    Vis::ModelGeometry::purge( this);
     for ( FV *fv : _fvs)
         fv->rebuild();
 }   // end rebuildViews
@@ -394,7 +479,7 @@ bool FaceModel::hasLandmarks() const { return _cass->hasLandmarks();}
 
 void FaceModel::setLandmarkPosition( int lid, FaceSide flat, const Vec3f &pos)
 {
-    _cass->landmarks().set( lid, pos, flat);
+    _cass->editLandmarks().set( lid, pos, flat);
     remakeBounds();
 }   // end setLandmarkPosition
 
@@ -412,7 +497,7 @@ void FaceModel::swapLandmarkLaterals()
     {
         if ( ass.get()->hasLandmarks())
         {
-            ass.get()->landmarks().swapLaterals();
+            ass.get()->editLandmarks().swapLaterals();
             didswap = true;
         }   // end if
     }   // end for
@@ -465,21 +550,21 @@ int FaceModel::addPath( const Vec3f& pos)
 {
     assert( _cass);
     setMetaSaved(false);
-    return _cass->paths().addPath( pos);
+    return _cass->editPaths().addPath( pos);
 }   // end addPath
 
 
 int FaceModel::addPath( Path &&path)
 {
     setMetaSaved(false);
-    return _cass->paths().addPath( std::move(path));
+    return _cass->editPaths().addPath( std::move(path));
 }   // end addPath
 
 
 void FaceModel::removePath( int pid)
 {
     assert( _cass);
-    if ( _cass->paths().removePath(pid))
+    if ( _cass->editPaths().removePath(pid))
         setMetaSaved(false);
 }   // end removePath
 
@@ -487,7 +572,7 @@ void FaceModel::removePath( int pid)
 void FaceModel::renamePath( int pid, const QString &nm)
 {
     assert( _cass);
-    if ( _cass->paths().renamePath( pid, nm))
+    if ( _cass->editPaths().renamePath( pid, nm))
         setMetaSaved(false);
 }   // end renamePath
 
@@ -21,50 +21,26 @@ using FaceTools::FaceModelCurvatureStore;
 using FMC = FaceTools::FaceModelCurvature;
 using FaceTools::FM;
 
-std::unordered_map<const FM*, FMC::Ptr> FaceModelCurvatureStore::_metrics;
-QReadWriteLock FaceModelCurvatureStore::_lock;
+FaceModelCurvatureStore::Cache FaceModelCurvatureStore::_cache;
 
 
-FaceModelCurvatureStore::RPtr FaceModelCurvatureStore::rvals( const FM &fm)
-{
-    if ( !_lock.tryLockForRead())
-        return nullptr;
-    const FMC *fmc = _metrics.count(&fm) > 0 ?  _metrics.at(&fm).get() : nullptr;
-    if ( !fmc)
-    {
-        _lock.unlock();
-        return nullptr;
-    }   // end if
-    return RPtr( fmc, []( const FMC*){ _lock.unlock();});
-}   // end rvals
+FaceModelCurvatureStore::RPtr FaceModelCurvatureStore::rvals( const FM &fm) { return _cache.read(&fm);}
 
 
-FaceModelCurvatureStore::WPtr FaceModelCurvatureStore::wvals( const FM &fm)
-{
-    _lock.lockForWrite();
-    FMC *fmc = _metrics.count(&fm) > 0 ?  _metrics.at(&fm).get() : nullptr;
-    if ( !fmc)
-    {
-        _lock.unlock();
-        return nullptr;
-    }   // end if
-    return WPtr( fmc, []( const FMC*){ _lock.unlock();});
-}   // end wvals
+FaceModelCurvatureStore::RPtr FaceModelCurvatureStore::waitRvals( const FM &fm) { return _cache.waitRead(&fm);}
 
 
-void FaceModelCurvatureStore::purge( const FM &fm)
-{
-    _lock.lockForWrite();
-    _metrics.erase(&fm);
-    _lock.unlock();
-}   // end purge
+FaceModelCurvatureStore::WPtr FaceModelCurvatureStore::wvals( const FM &fm) { return _cache.write(&fm);}
+
+
+bool FaceModelCurvatureStore::has( const FM &fm) { return _cache.has(&fm);}
+
+
+void FaceModelCurvatureStore::purge( const FM &fm) { _cache.purge(&fm);}
 
 
 void FaceModelCurvatureStore::add( const FM &fm)
 {
-    FMC::Ptr fmc = FMC::create( fm.mesh());  // Blocks
-    _lock.lockForWrite();
-    assert( _metrics.count(&fm) == 0);
-    _metrics[&fm] = fmc;
-    _lock.unlock();
+    _cache.reserve(&fm);    // Readers of this model can wait while calculating
+    _cache.set( &fm, FMC::create( fm.mesh()));  // Blocks
 }   // end add
@@ -19,74 +19,47 @@
 #include <FaceTools/FaceModel.h>
 #include <cassert>
 using FaceTools::FaceModelDeltaStore;
+using FaceTools::ModelPair;
 using FMD = FaceTools::FaceModelDelta;
 using FaceTools::FM;
 
 
-std::unordered_map<const FM*, std::unordered_map<const FM*, FMD::Ptr> > FaceModelDeltaStore::_t2s;
-std::unordered_map<const FM*, std::unordered_map<const FM*, FMD::Ptr> > FaceModelDeltaStore::_s2t;
-QReadWriteLock FaceModelDeltaStore::_lock;
+FaceModelDeltaStore::Cache FaceModelDeltaStore::_cache;
 
 
-bool FaceModelDeltaStore::_has( const FM *tgt, const FM *src)
+FaceModelDeltaStore::RPtr FaceModelDeltaStore::vals( const FM *tgt, const FM *src)
 {
-    return (_t2s.count(tgt) > 0) && (_t2s.at(tgt).count(src) > 0);
-}   // end _has
+    return _cache.read( ModelPair( tgt, src));
+}   // end vals
 
 
-using RPtr = std::shared_ptr<const FMD>;
-RPtr FaceModelDeltaStore::vals( const FM *tgt, const FM *src)
+FaceModelDeltaStore::RPtr FaceModelDeltaStore::waitVals( const FM *tgt, const FM *src)
 {
-    if ( !_lock.tryLockForRead())
-        return nullptr;
-    if ( !_has(tgt, src))
-    {
-        _lock.unlock();
-        return nullptr;
-    }   // end if
-    return RPtr( _t2s.at(tgt).at(src).get(), []( const FMD*){ _lock.unlock();});
-}   // end vals
+    return _cache.waitRead( ModelPair( tgt, src));
+}   // end waitVals
 
 
 void FaceModelDeltaStore::add( const FM *tgt, const FM *src)
 {
-    _lock.lockForWrite();
+    const ModelPair key( tgt, src);
+    _cache.reserve( key);
     FMD::Ptr fmd = FMD::create( tgt, src);
     assert(fmd);
-    _t2s[tgt][src] = fmd;
-    _s2t[src][tgt] = fmd;
-    _lock.unlock();
+    if ( fmd)
+        _cache.set( key, fmd);
+    else
+        _cache.purge( key);   // Release any waiters
 }   // end add
 
 
 bool FaceModelDeltaStore::has( const FM *tgt, const FM *src)
 {
-    if ( !_lock.tryLockForRead())
-        return false;
-    const bool h = _has( tgt, src);
-    _lock.unlock();
-    return h;
+    return _cache.isReady( ModelPair( tgt, src));
 }   // end has
 
 
 void FaceModelDeltaStore::purge( const FM *fm)
 {
-    _lock.lockForWrite();
-    // All the targets using fm as a source need purging
-    if ( _s2t.count(fm) > 0)
-    {
-        for ( const auto& p : _s2t.at(fm))
-        {
-            const FM *tgt = p.first;
-            if ( _t2s.count(tgt) > 0)
-            {
-                _t2s.at(tgt).erase(fm);
-                if ( _t2s.at(tgt).empty())
-                    _t2s.erase(tgt);
-            }   // end if
-        }   // end for
-        _s2t.erase(fm);
-    }   // end if
-    _t2s.erase(fm);
-    _lock.unlock();
+    // Purge deltas where fm is the target as well as all targets using fm as a source
+    _cache.purgeIf( [fm]( const ModelPair &p){ return p.first == fm || p.second == fm;});
 }   // end purge
@@ -22,49 +22,28 @@ using FaceTools::FaceModelSymmetryStore;
 using FaceTools::FaceModelSymmetry;
 using FaceTools::FM;
 
-std::unordered_map<const FM*, FaceModelSymmetry::Ptr> FaceModelSymmetryStore::_vtxSymm;
-QReadWriteLock FaceModelSymmetryStore::_lock;
+FaceModelSymmetryStore::Cache FaceModelSymmetryStore::_cache;
+
+
+FaceModelSymmetryStore::RPtr FaceModelSymmetryStore::vals( const FM *fm) { return _cache.read(fm);}
 
-using RPtr = std::shared_ptr<const FaceModelSymmetry>;
-RPtr FaceModelSymmetryStore::vals( const FM *fm)
-{
-    if ( !_lock.tryLockForRead())
-        return nullptr;
-    const FaceModelSymmetry *vvals = _vtxSymm.count(fm) > 0 ? _vtxSymm.at(fm).get() : nullptr;
-    if ( !vvals)
-    {
-        _lock.unlock();
-        return nullptr;
-    }   // end if
-    return RPtr( vvals, []( const FaceModelSymmetry*){ _lock.unlock();});
-}   // end vals
+
+FaceModelSymmetryStore::RPtr FaceModelSymmetryStore::waitVals( const FM *fm) { return _cache.waitRead(fm);}
 
 
 bool FaceModelSymmetryStore::isMapped( const FM *fm)
 {
     assert( fm);
-    bool gotvals = false;
-    if ( _lock.tryLockForRead())
-    {
-        gotvals = _vtxSymm.count(fm) > 0;
-        _lock.unlock(); 
-    }   // end if
-    return gotvals;
+    return _cache.isReady(fm);
 }   // end isMapped
 
 
-void FaceModelSymmetryStore::purge( const FM *fm)
-{
-    _lock.lockForWrite();
-    _vtxSymm.erase(fm);
-    _lock.unlock();
-}   // end purge
+void FaceModelSymmetryStore::purge( const FM *fm) { _cache.purge(fm);}
 
 
 void FaceModelSymmetryStore::add( const FM *fm)
 {
-    assert( _vtxSymm.count(fm) == 0);
-    _lock.lockForWrite();
-    _vtxSymm[fm] = FaceModelSymmetry::create(fm);
-    _lock.unlock();
+    assert( !_cache.isReady(fm));
+    _cache.reserve(fm);
+    _cache.set( fm, FaceModelSymmetry::create(fm));
 }   // end add
@@ -18,18 +18,92 @@
 #include <FaceModelViewer.h>
 #include <FaceModel.h>
 #include <Vis/FaceView.h>
+#include <vtkCallbackCommand.h>
+#include <vtkNew.h>
 #include <algorithm>
 #include <cassert>
 using FaceTools::FaceModelViewer;
 using FaceTools::Vis::FV;
 using FaceTools::FM;
 
-FaceModelViewer::FaceModelViewer( QWidget *parent) : ModelViewer(parent), _lastfv(nullptr)
+namespace {
+// Views only show their proxies while in low detail if full detail frames take longer
+// than this many milliseconds, or if too few full detail frames have been timed to tell.
+const double MAX_FULL_DETAIL_FRAME_TIME = 1000.0 / 30;
+const size_t MIN_TIMED_FRAMES = 10;
+}   // end namespace
+
+
+FaceModelViewer::FaceModelViewer( QWidget *parent)
+    : ModelViewer(parent), _lastfv(nullptr), _lowDetailCount(0), _proxiesShown(false), _frameLowDetail(false)
 {
     resetDefaultCamera();
+    resetFrameTimes();
+    vtkNew<vtkCallbackCommand> cb;
+    cb->SetCallback( &FaceModelViewer::_onRender);
+    cb->SetClientData( this);
+    _startTag = getRenderer()->AddObserver( vtkCommand::StartEvent, cb);
+    _endTag = getRenderer()->AddObserver( vtkCommand::EndEvent, cb);
 }   // end ctor
 
 
+FaceModelViewer::~FaceModelViewer()
+{
+    getRenderer()->RemoveObserver( _startTag);
+    getRenderer()->RemoveObserver( _endTag);
+}   // end dtor
+
+
+void FaceModelViewer::setLowDetail( bool v)
+{
+    _lowDetailCount = std::max( 0, _lowDetailCount + (v ? 1 : -1));
+    const bool showProxies = lowDetail()
+                          && (frameCount(false) < MIN_TIMED_FRAMES || meanFrameTime(false) > MAX_FULL_DETAIL_FRAME_TIME);
+    if ( showProxies != _proxiesShown)
+    {
+        _proxiesShown = showProxies;
+        for ( FV *fv : _attached)
+            fv->setLowDetail( showProxies);
+    }   // end if
+}   // end setLowDetail
+
+
+size_t FaceModelViewer::frameCount( bool v) const { return _frameCounts[v ? 1 : 0];}
+
+
+double FaceModelViewer::meanFrameTime( bool v) const
+{
+    const size_t n = frameCount(v);
+    return n > 0 ? _frameTimes[v ? 1 : 0] / n : 0.0;
+}   // end meanFrameTime
+
+
+void FaceModelViewer::resetFrameTimes()
+{
+    _frameCounts[0] = _frameCounts[1] = 0;
+    _frameTimes[0] = _frameTimes[1] = 0.0;
+}   // end resetFrameTimes
+
+
+void FaceModelViewer::_onRender( vtkObject*, unsigned long eid, void *cdata, void*)
+{
+    FaceModelViewer *vwr = static_cast<FaceModelViewer*>(cdata);
+    if ( eid == vtkCommand::StartEvent)
+    {
+        vwr->_frameLowDetail = std::any_of( vwr->_attached.begin(), vwr->_attached.end(),
+                                            []( const FV *fv){ return fv->lowDetail();});
+        vwr->_frameTimer.start();
+    }   // end if
+    else if ( vwr->_frameTimer.isValid())
+    {
+        const int i = vwr->_frameLowDetail ? 1 : 0;
+        vwr->_frameTimes[i] += vwr->_frameTimer.nsecsElapsed() * 1e-6;
+        vwr->_frameCounts[i]++;
+        vwr->_frameTimer.invalidate();
+    }   // end else if
+}   // end _onRender
+
+
 bool FaceModelViewer::attach( FV* fv)
 {
     if ( _models.count(fv->data()) > 0) // Don't add view if its model is already in the viewer.
@@ -37,6 +111,8 @@ bool FaceModelViewer::attach( FV* fv)
     _attached.insert(fv);
     _models[fv->data()] = fv;
     _lastfv = fv;
+    fv->setLowDetail( _proxiesShown);
+    resetFrameTimes();  // Times were for rendering the other models
     emit onAttached(fv);
     return true;
 }   // end attach
@@ -50,6 +126,7 @@ bool FaceModelViewer::detach( FV* fv)
     _models.erase(fv->data());
     if ( fv == _lastfv)
         _lastfv = _attached.empty() ? nullptr : _attached.first();
+    resetFrameTimes();
     emit onDetached(fv);
     return true;
 }   // end detach
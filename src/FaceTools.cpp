@@ -20,11 +20,16 @@
 #include <Vis/FaceView.h>
 #include <FaceModelViewer.h>
 #include <FaceModel.h>
+#include <WorkerPool.h>
 #include <r3d/Transformer.h>
 #include <r3d/SurfacePlanarPathFinder.h>
 #include <r3d/SurfacePointFinder.h>
 #include <r3d/SurfaceCurveFinder.h>
 #include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <future>
+#include <mutex>
 using FaceTools::FM;
 using namespace r3d;
 
@@ -89,12 +94,86 @@ void FaceTools::updateRenderers( const FMS& fms)
 }   // end updateRenderers
 
 
+void FaceTools::parallelFor( size_t n, const std::function<void( size_t, size_t)> &fn, size_t minBlock)
+{
+    minBlock = std::max<size_t>( minBlock, 1);
+    const size_t maxThreads = size_t( std::max( WorkerPool::maxThreadCount(), 1));
+    const size_t nblocks = std::min( maxThreads, (n + minBlock - 1) / minBlock);
+    if ( nblocks <= 1)
+    {
+        if ( n > 0)
+            fn( 0, n);
+        return;
+    }   // end if
+
+    // Blocks are claimed in turn by this thread and the pool's threads, so work that
+    // the pool hasn't started by the time this thread has claimed all blocks does nothing.
+    // This means it can't deadlock when called from work already running on the pool.
+    struct Blocks
+    {
+        std::atomic<size_t> next;
+        size_t done;
+        std::mutex mutex;
+        std::condition_variable finished;
+    };  // end struct
+    std::shared_ptr<Blocks> blocks = std::make_shared<Blocks>();
+    blocks->next = 0;
+    blocks->done = 0;
+
+    const size_t bsz = (n + nblocks - 1) / nblocks;
+    const auto work = [blocks, &fn, n, bsz, nblocks]()
+    {
+        size_t b;
+        while ( (b = blocks->next++) < nblocks)
+        {
+            fn( b*bsz, std::min( (b+1)*bsz, n));
+            std::lock_guard<std::mutex> lock( blocks->mutex);
+            if ( ++blocks->done == nblocks)
+                blocks->finished.notify_one();
+        }   // end while
+    };  // end work
+
+    for ( size_t i = 1; i < nblocks; ++i)
+        WorkerPool::run( [work]( const WorkerPool::Token&){ work();}, WorkerPool::USER);
+    work();
+
+    std::unique_lock<std::mutex> lock( blocks->mutex);
+    blocks->finished.wait( lock, [&blocks, nblocks](){ return blocks->done == nblocks;});
+}   // end parallelFor
+
+
 Vec3f FaceTools::toSurface( const KDTree &kdt, const Vec3f& v)
 {
     return SurfacePointFinder( kdt.mesh()).find( v, kdt.find(v));
 }   // end toSurface
 
 
+void FaceTools::toSurface( const KDTree &kdt, const std::vector<Vec3f> &pts, std::vector<Vec3f> &spts, std::vector<int> *fids)
+{
+    static const size_t MIN_BLOCK = 512;    // Not worth using another thread for fewer points
+    const size_t N = pts.size();
+    const Mesh &mesh = kdt.mesh();
+    const SurfacePointFinder spfinder( mesh);
+    spts.resize( N);
+    if ( fids)
+        fids->resize( N);
+    parallelFor( N, [&]( size_t i0, size_t i1)
+    {
+        int fid;
+        for ( size_t i = i0; i < i1; ++i)
+        {
+            const Vec3f v = pts[i];   // Copy since pts may be spts
+            int vidx = kdt.find( v);  // Nearest vertex to begin the search from
+            spfinder.find( v, vidx, fid, spts[i]);
+            if ( fid < 0)   // Surface point coincident with vertex vidx so choose any attached face
+                fid = *mesh.faces(vidx).begin();
+            if ( fids)
+                (*fids)[i] = fid;
+        }   // end for
+    }, MIN_BLOCK);
+}   // end toSurface
+
+
 float FaceTools::barycentricMapSrcToDst( const FM *src, Vec3f v, const FM *dst, Vec3f &ov)
 {
     assert( src->hasMask());
@@ -119,19 +198,41 @@ float FaceTools::barycentricMapSrcToDst( const FM *src, Vec3f v, const FM *dst,
 }   // end barycentricMapSrcToDst
 
 
+void FaceTools::barycentricMapSrcToDst( const FM *src, const std::vector<Vec3f> &svs, const FM *dst, std::vector<Vec3f> &dvs)
+{
+    assert( src->hasMask());
+    assert( src->maskHash() == dst->maskHash());
+
+    // Find the closest positions on the source mask and the faces they're in.
+    std::vector<Vec3f> vsmsks;
+    std::vector<int> fids;
+    toSurface( src->maskKDTree(), svs, vsmsks, &fids);
+
+    // Map the barycentric coordinates over to the destination mask then project back to the destination surface.
+    const size_t N = svs.size();
+    for ( size_t i = 0; i < N; ++i)
+        vsmsks[i] = dst->mask().fromBarycentric( fids[i], src->mask().toBarycentric( fids[i], vsmsks[i]));
+    toSurface( dst->kdtree(), vsmsks, dvs);
+}   // end barycentricMapSrcToDst
+
+
 Vec3f FaceTools::toTarget( const KDTree &kdt, const Vec3f& s, const Vec3f& t)
 {
     return SurfacePointFinder( kdt.mesh()).find( t, kdt.find(s));
 }   // end toTarget
 
 
-bool FaceTools::findPath( const KDTree& kdt, const Vec3f& p0, const Vec3f& p1, std::list<Vec3f>& pts)
+bool FaceTools::findPath( const KDTree& kdt, const Vec3f& p0, const Vec3f& p1, std::vector<Vec3f>& pts)
 {
     SurfaceCurveFinder scfinder0( kdt);
     SurfaceCurveFinder scfinderR( kdt);
  
+    // Search in reverse on another thread. The future is waited on when destroyed
+    // so the reverse search finishes even if the forward search throws.
+    std::future<float> rsum = std::async( std::launch::async, [&](){ return scfinderR.findPath( p1, p0);});
     float psum0 = scfinder0.findPath( p0, p1);
-    float psumr = scfinderR.findPath( p1, p0);
+    float psumr = rsum.get();
+
     if ( psum0 + psumr < 0.0f)
     {
         //std::cerr << " not found!" << std::endl;
@@ -143,26 +244,23 @@ bool FaceTools::findPath( const KDTree& kdt, const Vec3f& p0, const Vec3f& p1, s
     if ( psumr < 0)
         psumr = FLT_MAX;
 
-    const std::vector<Vec3f>* lpath = &scfinder0.lastPath();
-    if ( psumr < psum0)
-        lpath = &scfinderR.lastPath();
-    assert( lpath);
-    pts = std::list<Vec3f>( lpath->begin(), lpath->end());
     if ( psumr < psum0)
-        pts.reverse();
+    {
+        const std::vector<Vec3f> &lpath = scfinderR.lastPath();
+        pts.assign( lpath.rbegin(), lpath.rend());
+    }   // end if
+    else
+        pts = scfinder0.lastPath();
 
     return true;
 }   // end findPath
 
 
-bool FaceTools::findSlicedPath( const KDTree &kdt, const Vec3f& p0, const Vec3f& p1, const Vec3f &u, std::list<Vec3f>& pts)
+bool FaceTools::findSlicedPath( const KDTree &kdt, const Vec3f& p0, const Vec3f& p1, const Vec3f &u, std::vector<Vec3f>& pts)
 {
     SurfacePlanarPathFinder pfinder( kdt, u);
     if ( pfinder.findPath( p0, p1) >= 0)
-    {
-        const std::vector<Vec3f>& lpath = pfinder.lastPath();
-        pts = std::list<Vec3f>( lpath.begin(), lpath.end());
-    }   // end if
+        pts = pfinder.lastPath();
     return !pts.empty();
 }   // end findSlicedPath
 
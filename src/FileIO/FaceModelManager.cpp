@@ -18,6 +18,7 @@
 #include <FileIO/FaceModelManager.h>
 #include <FileIO/FaceModelDatabase.h>
 #include <FileIO/FaceModelXMLFileHandler.h>
+#include <Vis/ModelGeometry.h>
 #include <MiscFunctions.h>
 #include <FaceModel.h>
 #include <FaceTools.h>
@@ -198,6 +199,7 @@ void FaceModelManager::close( const FM &cfm)
     _mfiles.erase(fpath);
     _mpaths.erase(fm);
     _models.erase(fm);
+    FaceTools::Vis::ModelGeometry::forget( fm);   // Workers preparing view geometry mustn't use the model after this
     delete fm;
 }   // end close
 
@@ -556,7 +556,7 @@ QString FaceTools::FileIO::loadData( FM &fm, const QString &tdir, const QString
         {
             fm.update( mesh, true, false/*don't resettle landmarks (or update paths) just read in*/);
             for ( int aid : fm.assessmentIds()) // Do want to update paths over the mesh though
-                fm.assessment(aid)->paths().update( &fm);
+                fm.assessment(aid)->editPaths().update( &fm);
         }   // end if
         else
             return QString("Couldn't load main mesh from '%1'").arg( meshfname);
@@ -161,3 +161,21 @@ bool LandmarksHandler::doLeftDrag()
     }   // end if
     return swallowed;
 }   // end doLeftDrag
+
+
+bool LandmarksHandler::doMouseMove()
+{
+    // All landmarks belong to the same prop so moving directly between
+    // landmarks doesn't leave the prop and must be checked for here.
+    if ( _dragId < 0 && _hoverId >= 0)
+    {
+        FaceSide lat;
+        const int hid = _vis.landmarkId( MS::selectedView(), this->prop(), lat);
+        if ( hid != _hoverId || lat != _lat)
+        {
+            _leaveLandmark();
+            doEnterProp();
+        }   // end if
+    }   // end if
+    return false;
+}   // end doMouseMove
@@ -22,12 +22,15 @@
 #include <Vis/FaceView.h>
 #include <FaceModel.h>
 #include <MiscFunctions.h>
+#include <QTimer>
 #include <cassert>
+#include <cmath>
 using FaceTools::Interactor::PathsHandler;
 using FaceTools::Vis::PathView;
 using FaceTools::Vis::FV;
 using FaceTools::Path;
 using FaceTools::Vec3f;
+using FaceTools::WorkerPool;
 using MS = FaceTools::ModelSelect;
 using LMAN = FaceTools::Landmark::LandmarksManager;
 
@@ -35,13 +38,24 @@ using LMAN = FaceTools::Landmark::LandmarksManager;
 PathsHandler::Ptr PathsHandler::create() { return Ptr( new PathsHandler);}
 
 // private
-PathsHandler::PathsHandler() : _handle(nullptr), _dragging(false), _initPlacement(false) {}
+PathsHandler::PathsHandler() : _handle(nullptr), _dragging(false), _initPlacement(false), _pathGen(0), _pathPending(false), _pathBusy(false), _pathNext(nullptr, -1) {}
 
 
 void PathsHandler::refresh()
 {
     const FV *fv = MS::selectedView();
     setEnabled( fv && _vis.isVisible(fv));
+    _snaps.clear(); // Paths or landmarks may have changed
+
+    // Transforms are applied to the model in place so an outstanding search on a model
+    // that's since been transformed is cancelled (the path is found on finishing dragging).
+    if ( _pathPending && (!fv || fv->data()->transformMatrix() != _pathTmat))
+    {
+        if ( _pathTok)
+            _pathTok->cancel();
+        _pathNext = {nullptr, -1};
+        _pathGen++;
+    }   // end if
 
     // Handle possibility of closed model or deleted paths
     if ( !fv || fv->rdata()->currentPaths().empty())
@@ -98,6 +112,7 @@ void PathsHandler::addPath( Vec3f &v)
     const int pid = fm->addPath( v);
     _dragging = true;
     _initPlacement = true;
+    _snaps.clear();
     for ( FV *fv : fm->fvs())
         fv->apply( &_vis);
     _handle = _vis.pathHandle0( MS::selectedView(), pid);
@@ -113,6 +128,7 @@ bool PathsHandler::endDragging()
     {
         swallowed = true;
         assert(_handle);
+        _finishPath();
         const int pid = _handle->pathId();
         const int hid = _handle->handleId();
         if ( this->prop() != _handle->prop())
@@ -132,6 +148,7 @@ bool PathsHandler::doLeftButtonDown()
     {
         swallowed = true;
         _dragging = true;
+        _snaps.clear();
         emit onStartedDrag( _handle->pathId(), _handle->handleId());
     }   // end else if
     return swallowed;
@@ -141,37 +158,107 @@ bool PathsHandler::doLeftButtonDown()
 bool PathsHandler::doLeftButtonUp() { return endDragging();}
 
 
-namespace {
+const float PathsHandler::SnapIndex::CELL_SIZE(3.0f); // Snap range max is 3.0mm
 
-void checkCloser( float &minSqDist, Vec3f &nv, const Vec3f &vm, const Vec3f &v, float snapSqDist)
+
+PathsHandler::SnapIndex::SnapIndex() : _fm(nullptr), _pid(-1), _withLmks(false) {}
+
+
+int64_t PathsHandler::SnapIndex::_key( int x, int y, int z)
 {
-    const float sqdist = (vm - v).squaredNorm();
-    if ( sqdist < snapSqDist && sqdist < minSqDist)
-    {
-        minSqDist = sqdist;
-        nv = vm;
-    }   // end if
-}   // end checkCloser
+    static const int64_t M = (1 << 21) - 1;
+    return (int64_t(x) & M) << 42 | (int64_t(y) & M) << 21 | (int64_t(z) & M);
+}   // end _key
+
+
+void PathsHandler::SnapIndex::_add( Grid &grid, const Vec3f &v)
+{
+    const int x = int(floorf( v[0] / CELL_SIZE));
+    const int y = int(floorf( v[1] / CELL_SIZE));
+    const int z = int(floorf( v[2] / CELL_SIZE));
+    grid[_key(x,y,z)].push_back(v);
+}   // end _add
 
 
-Vec3f snapToPathHandle( int hpid, const FaceTools::PathSet &paths, const Vec3f &v, float sqRange)
+bool PathsHandler::SnapIndex::_snap( const Grid &grid, Vec3f &v, float sqRange)
 {
-    Vec3f nv = v;
+    assert( sqRange <= CELL_SIZE * CELL_SIZE);
+    const int x = int(floorf( v[0] / CELL_SIZE));
+    const int y = int(floorf( v[1] / CELL_SIZE));
+    const int z = int(floorf( v[2] / CELL_SIZE));
     float minSqDist = FLT_MAX;
+    const Vec3f *nv = nullptr;
+    // Points within range can only be in the cell containing v or its immediate neighbours
+    for ( int i = x-1; i <= x+1; ++i)
+        for ( int j = y-1; j <= y+1; ++j)
+            for ( int k = z-1; k <= z+1; ++k)
+            {
+                const auto it = grid.find( _key(i,j,k));
+                if ( it == grid.end())
+                    continue;
+                for ( const Vec3f &p : it->second)
+                {
+                    const float sqdist = (p - v).squaredNorm();
+                    if ( sqdist < sqRange && sqdist < minSqDist)
+                    {
+                        minSqDist = sqdist;
+                        nv = &p;
+                    }   // end if
+                }   // end for
+            }   // end for
+    if ( nv)
+        v = *nv;
+    return nv != nullptr;
+}   // end _snap
+
+
+void PathsHandler::SnapIndex::build( const FM *fm, int hpid, bool withLandmarks)
+{
+    clear();
+    _fm = fm;
+    _pid = hpid;
+    _withLmks = withLandmarks;
+
+    const FaceTools::PathSet &paths = fm->currentPaths();
     for ( int pid : paths.ids())
     {
         if ( pid != hpid)   // Don't allow handle snapping to the same path!
         {
-            const FaceTools::Path &opath = paths.path(pid);
-            checkCloser( minSqDist, nv, opath.handle0(), v, sqRange);
-            checkCloser( minSqDist, nv, opath.handle1(), v, sqRange);
-            checkCloser( minSqDist, nv, opath.depthHandle(), v, sqRange);
+            const Path &opath = paths.path(pid);
+            _add( _handles, opath.handle0());
+            _add( _handles, opath.handle1());
+            _add( _handles, opath.depthHandle());
         }   // end if
     }   // end for
-    return nv;
-}   // end snapToPathHandle
 
-}   // end namespace
+    if ( withLandmarks)
+    {
+        const FaceTools::Landmark::LandmarkSet &lmks = fm->currentLandmarks();
+        for ( int lmid : lmks.ids())
+        {
+            if ( LMAN::landmark(lmid)->isVisible())
+            {
+                if ( LMAN::isBilateral(lmid))
+                {
+                    _add( _lmks, lmks.pos(lmid, FaceTools::LEFT));
+                    _add( _lmks, lmks.pos(lmid, FaceTools::RIGHT));
+                }   // end if
+                else
+                    _add( _lmks, lmks.pos(lmid, FaceTools::MID));
+            }   // end if
+        }   // end for
+    }   // end if
+}   // end build
+
+
+void PathsHandler::SnapIndex::clear()
+{
+    _fm = nullptr;
+    _pid = -1;
+    _withLmks = false;
+    _handles.clear();
+    _lmks.clear();
+}   // end clear
 
 
 // Needed only when initial placement happening
@@ -213,20 +300,26 @@ bool PathsHandler::doLeftDrag()
 void PathsHandler::_snapHandle( const FV *fv, Vec3f &v) const
 {
     const FMV *fmv = fv->viewer();
-    const float sqRange = powf( std::min( 3.0f, fmv->snapRange()), 2);  // Snap range max is 3.0mm
+    const float sqRange = powf( std::min( SnapIndex::CELL_SIZE, fmv->snapRange()), 2);
     const Vec3f inv = v;
     const FM *fm = fv->data();
+    const int pid = _handle ? _handle->pathId() : -1;
+    const Vis::BaseVisualisation *lmkVis = &MS::handler<LandmarksHandler>()->visualisation();
+    assert( lmkVis);
+    const bool lmksVisible = lmkVis->isVisible(fv);
+    if ( !_snaps.isFor( fm, pid, lmksVisible))
+        _snaps.build( fm, pid, lmksVisible);
+
     // Check if can snap to endpoint of another path. If don't snap and landmarks are visible, snap to one.
     // Snap range scales with view distance for an apparently fixed distance no matter where camera is.
+    bool snapped = false;
     if ( _handle)
-        v = snapToPathHandle( _handle->pathId(), fm->currentPaths(), v, sqRange);
+        snapped = _snaps.snapToHandle( v, sqRange);
 
-    // If didn't snap to another path (inv == v), see if snap to a landmark
-    const Vis::BaseVisualisation *lmkVis = &MS::handler<LandmarksHandler>()->visualisation();
-    assert( lmkVis);
-    if ( lmkVis->isVisible(fv) && inv == v)
+    // If didn't snap to another path, see if snap to a landmark
+    if ( lmksVisible && !snapped)
     {
-        v = fm->currentLandmarks().snapTo( v, sqRange);
+        _snaps.snapToLandmark( v, sqRange);
         // Use unsnapped if the snapped position is the same as the other handles of the current path.
         if ( _handle)
         {   
@@ -262,7 +355,8 @@ bool PathsHandler::_execLeftDrag()
         path.setHandle( hid, v);    // Handle position (transformed)
         const r3d::CameraParams cp = fmv->camera();
         path.setOrientation( cp.pos() - cp.focus());    // Orientation will be normalized
-        path.updatePath( fm);         // Update the surface path
+        path.setStraight();         // Shown until the surface path is found
+        _findPathAsync( fm, pid);
     }   // end if
     else
     {
@@ -270,13 +364,121 @@ bool PathsHandler::_execLeftDrag()
         path.setDepthHandle( v);
     }   // end else
 
+    _refreshPath( fm, pid);
+    return true;
+}   // end _execLeftDrag
+
+
+void PathsHandler::_refreshPath( FM *fm, int pid)
+{
+    Path &path = fm->currentPaths().path( pid);
     path.updateMeasures( fm->inverseTransformMatrix().block<3,3>(0,0));
     fm->setMetaSaved( false);
     _vis.updatePath( *fm, pid);
     _showPathInfo();
+}   // end _refreshPath
 
-    return true;
-}   // end _execLeftDrag
+
+void PathsHandler::_findPathAsync( FM *fm, int pid)
+{
+    _pathGen++;
+    _pathPending = true;
+    // Only one search runs at a time (a search can't be stopped once started) so if one is
+    // running, this search replaces any other waiting to start once the running one finishes.
+    if ( _pathBusy)
+    {
+        _pathNext = {fm, pid};
+        return;
+    }   // end if
+    _startSearch( fm, pid);
+}   // end _findPathAsync
+
+
+void PathsHandler::_startSearch( FM *fm, int pid)
+{
+    _pathBusy = true;
+    _pathNext = {nullptr, -1};
+    const int gen = _pathGen;
+    const Path path = fm->currentPaths().path( pid);   // Copy with the new endpoints and orientation
+    // The model's read lock is held by the search (so the model can't be transformed in place
+    // until it finishes). Results found for a transform other than the model's current one
+    // are discarded by _onPathFound. The handler is always told when the search is done
+    // (even if cancelled before starting) so that the next search can start.
+    _pathTmat = fm->transformMatrix();
+    _pathTok = WorkerPool::run( [this, fm, gen, path]( const WorkerPool::Token &tok)
+    {
+        Path npath = path;
+        bool found = false;
+        if ( !tok.isCancelled())
+        {
+            fm->lockForRead();
+            npath.updatePath( fm->kdtree());
+            fm->unlock();
+            found = true;
+        }   // end if
+        QTimer::singleShot( 0, this, [this, fm, gen, npath, found](){ _onPathFound( fm, found ? gen : -1, npath);});
+    }, WorkerPool::USER);
+}   // end _startSearch
+
+
+void PathsHandler::_onPathFound( FM *fm, int gen, const Path &npath)
+{
+    _pathBusy = false;
+    const Mat4f tmat = _pathTmat;   // Transform the search was for (before starting the next)
+    if ( _pathNext.first)
+    {
+        FM *nfm = _pathNext.first;
+        const int npid = _pathNext.second;
+        if ( MS::selectedModel() == nfm && nfm->currentPaths().has( npid))
+            _startSearch( nfm, npid);
+        else
+            _pathNext = {nullptr, -1};
+    }   // end if
+
+    if ( gen != _pathGen)   // Superseded by a later search (or cancelled)
+        return;
+
+    // Discard if found before the model was transformed (leaving it pending
+    // so that the path is found again on finishing dragging).
+    if ( MS::selectedModel() == fm && fm->transformMatrix() != tmat)
+        return;
+    _pathPending = false;
+
+    // Discard if the model is no longer selected or the path was changed or removed in the meantime.
+    const int pid = npath.id();
+    if ( MS::selectedModel() != fm || !fm->currentPaths().has( pid))
+        return;
+    Path &path = fm->currentPaths().path( pid);
+    if ( path.handle0() != npath.handle0() || path.handle1() != npath.handle1())
+        return;
+
+    const Vec3f dhan = path.depthHandle();  // May have been moved since the search started
+    path = npath;
+    path.setDepthHandle( dhan);
+    _refreshPath( fm, pid);
+    MS::updateRender();
+}   // end _onPathFound
+
+
+void PathsHandler::_finishPath()
+{
+    if ( !_pathPending)
+        return;
+
+    // Find the final surface path now rather than wait so that measurements are complete once dragging finishes.
+    if ( _pathTok)
+        _pathTok->cancel();
+    _pathNext = {nullptr, -1};
+    _pathGen++;
+    _pathPending = false;
+    FM *fm = MS::selectedModel();
+    const int pid = _handle->pathId();
+    if ( fm && fm->currentPaths().has( pid))
+    {
+        fm->currentPaths().path( pid).updatePath( fm);
+        _refreshPath( fm, pid);
+    }   // end if
+}   // end _finishPath
 
 
 
@@ -22,6 +22,8 @@
 #include <r3d/SurfacePointFinder.h>
 #include <cassert>
 using FaceTools::Interactor::RadialSelectHandler;
+using FaceTools::RadialRegion;
+using FaceTools::IntSet;
 using FaceTools::Vis::RadialSelectVisualisation;
 using FaceTools::Vis::FV;
 using FaceTools::Vec3f;
@@ -45,7 +47,7 @@ void RadialSelectHandler::init( const FM *fm, const Vec3f &tpos, float r)
 {
     fm->lockForRead();
     _fm = fm;
-    _rsel = r3d::RegionSelector::create( fm->mesh());
+    _rsel = RadialRegion::create( fm->mesh());
     _update( tpos, r);
     fm->unlock();
     refresh();
@@ -60,7 +62,6 @@ void RadialSelectHandler::reset( const FM *fm)
     _onReticule = false;
     _moving = false;
     _radiusChange = 0;
-    _fids.clear();
     _bnds.reset();
     _rsel = nullptr;
     refresh();
@@ -72,7 +73,6 @@ void RadialSelectHandler::refresh()
     const FV *fv = MS::selectedView();
     if ( !fv || fv->data() != _fm)
     {
-        _fids.clear();
         _bnds.reset();
         _rsel = nullptr;
         _vis.purgeAll();
@@ -85,6 +85,13 @@ float RadialSelectHandler::radius() const { return _rsel ? _rsel->radius() : 0.0
 Vec3f RadialSelectHandler::centre() const { return _rsel ? _rsel->centre() : Vec3f::Zero();}
 
 
+const IntSet &RadialSelectHandler::selectedFaces() const
+{
+    static const IntSet EMPTY_SET;
+    return _rsel ? _rsel->faces() : EMPTY_SET;
+}   // end selectedFaces
+
+
 const std::list<int> &RadialSelectHandler::boundaryVertices() const
 {
     static const std::list<int> EMPTY_LIST;
@@ -117,11 +124,13 @@ void RadialSelectHandler::_update( Vec3f tpos, float r)
     // Get the manifold having this face
     const r3d::Manifold& man = manifolds[manifolds.fromFaceId( cfid)];
 
-    _rsel->update( cfid, tpos, r);
-    _fids.clear();
-    _rsel->selectedFaces( _fids, &man.faces());
-    _bnds.reset();
-    _bnds.sort( mesh, mesh.pseudoBoundaries( _fids));
+    // Only the faces changing membership are touched if just the radius changed
+    _rsel->update( cfid, tpos, r, &man.faces());
+    if ( _rsel->numChanged() > 0)
+    {
+        _bnds.reset();
+        _bnds.sort( mesh, _rsel->boundaryEdges());
+    }   // end if
 
     _showHover();
     MS::showStatus( QString( "%1  with radius %2 %3").arg( posString( "Centre at:", tpos)).arg(r, 6, 'f', 2).arg(FM::LENGTH_UNITS), 5000);
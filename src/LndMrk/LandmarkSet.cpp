@@ -27,37 +27,24 @@ using FaceTools::Landmark::LmkList;
 using SLmk = FaceTools::Landmark::SpecificLandmark;
 using FaceTools::FaceSide;
 using FaceTools::Vec3f;
+using FaceTools::Mat3f;
 using FaceTools::Mat4f;
 using FaceTools::MatX3f;
-using LDMRK_PAIR = std::pair<int, Vec3f>;
 using LMAN = FaceTools::Landmark::LandmarksManager;
+using Mat3Xf = Eigen::Matrix<float, 3, Eigen::Dynamic>;
 
 
 namespace  {
-void addLandmarks( const std::unordered_map<int, Vec3f>& vs, FaceSide lat, LandmarkSet &mlmks)
-{
-    for ( const auto& p : vs)
-    {
-        const int lmid = p.first;
-        Vec3f v = Vec3f::Zero();
-        if ( mlmks.has(lmid, lat))
-            v = mlmks.pos(lmid, lat);
-        v += p.second;
-        mlmks.set( lmid, v, lat);
-    }   // end for
-}   // end addLandmarks
 
+static const FaceSide LATS[3] = {FaceTools::LEFT, FaceTools::MID, FaceTools::RIGHT};
 
-void setAverage( std::unordered_map<int, Vec3f>& lat, int n)
-{
-    for ( auto& p : lat)
-        lat[p.first] = p.second / n;
-}   // end setAverage
+// View the given vector of positions as a 3xN matrix.
+Eigen::Map<Mat3Xf> asMatrix( std::vector<Vec3f> &v) { return Eigen::Map<Mat3Xf>( reinterpret_cast<float*>( v.data()), 3, v.size());}
 
 }   // end namespace
 
 
-LandmarkSet::LandmarkSet( const std::unordered_set<const LandmarkSet*>& lms)
+LandmarkSet::LandmarkSet( const std::unordered_set<const LandmarkSet*>& lms) : _size(0)
 {
     int n = 0;
     for ( const LandmarkSet* lmks : lms)
@@ -66,50 +53,70 @@ LandmarkSet::LandmarkSet( const std::unordered_set<const LandmarkSet*>& lms)
             continue;
 
         n++;
-        const std::unordered_map<int, Vec3f>& llat = lmks->lateral(LEFT);
-        const std::unordered_map<int, Vec3f>& mlat = lmks->lateral(MID);
-        const std::unordered_map<int, Vec3f>& rlat = lmks->lateral(RIGHT);
-
-        addLandmarks( llat, LEFT, *this);
-        addLandmarks( mlat, MID, *this);
-        addLandmarks( rlat, RIGHT, *this);
+        _reserveSlots( lmks->_lats.size());
+        for ( size_t s = 0; s < lmks->_lats.size(); ++s)
+        {
+            const uint8_t lats = lmks->_lats[s];
+            if ( lats == 0)
+                continue;
+            for ( FaceSide lat : LATS)
+            {
+                if ( lats & lat)
+                {
+                    _lateral(lat)[s] += lmks->_clateral(lat)[s];
+                    if ( !_has( int(s), lat))
+                        _size++;
+                }   // end if
+            }   // end for
+            _lats[s] |= lats;
+            _ids.insert( LMAN::slotId(int(s)));
+        }   // end for
     }   // end for
 
     if ( n > 0)
     {
-        setAverage( _lmksL, n);
-        setAverage( _lmksM, n);
-        setAverage( _lmksR, n);
+        const float fn = float(n);
+        for ( FaceSide lat : LATS)
+            asMatrix( _lateral(lat)) /= fn;
     }   // end if
 }   // end ctor
 
 
-bool LandmarkSet::has( int id, FaceSide lat) const
+void LandmarkSet::_reserveSlots( size_t n)
 {
-    if ( !has(id))
-        return false;
-
-    bool hasLmk = false;
-    switch (lat)
+    n = std::max( n, LMAN::count());
+    if ( _lats.size() < n)
     {
-        case LEFT:
-            hasLmk = _lmksL.count(id) > 0;
-            break;
-        case MID:
-            hasLmk = _lmksM.count(id) > 0;
-            break;
-        case RIGHT:
-            hasLmk = _lmksR.count(id) > 0;
-            break;
-    }   // end switch
-    return hasLmk;
+        _lats.resize( n, 0);
+        _lmksL.resize( n, Vec3f::Zero());
+        _lmksM.resize( n, Vec3f::Zero());
+        _lmksR.resize( n, Vec3f::Zero());
+    }   // end if
+}   // end _reserveSlots
+
+
+bool LandmarkSet::has( int id, FaceSide lat) const
+{
+    const int s = LMAN::slot(id);
+    return s >= 0 && size_t(s) < _lats.size() && _has( s, lat);
 }   // end has
 
 
 bool LandmarkSet::has( const SLmk& p) const { return has(p.id, p.lat);}
 
 
-const LandmarkSet::LDMRKS& LandmarkSet::lateral( FaceSide lat) const
+std::unordered_map<int, Vec3f> LandmarkSet::lateral( FaceSide lat) const
+{
+    std::unordered_map<int, Vec3f> lmks;
+    const LDMRKS &vs = _clateral(lat);
+    for ( size_t s = 0; s < _lats.size(); ++s)
+        if ( _has( int(s), lat))
+            lmks[LMAN::slotId(int(s))] = vs[s];
+    return lmks;
+}   // end lateral
+
+
+const LandmarkSet::LDMRKS& LandmarkSet::_clateral( FaceSide lat) const
 {
     const LDMRKS* lmks = nullptr;
     switch (lat)
@@ -125,26 +132,32 @@ const LandmarkSet::LDMRKS& LandmarkSet::lateral( FaceSide lat) const
             break;
     }   // end switch
     return *lmks;
-}   // end lateral
+}   // end _clateral
 
 
 LandmarkSet::LDMRKS& LandmarkSet::_lateral( FaceSide lat)
 {
     const LandmarkSet* me = this;
-    return const_cast<LDMRKS&>( me->lateral(lat));
+    return const_cast<LDMRKS&>( me->_clateral(lat));
 }   // end _lateral
 
 
 bool LandmarkSet::set( int id, const Vec3f& v, FaceSide lat)
 {
-    Landmark* lmk = LMAN::landmark(id);
-    if ( !lmk)
+    const int s = LMAN::slot(id);
+    if ( s < 0)
         return false;
 
-    if ( !lmk->isBilateral())   // Ignore specified lateral if landmark is not bilateral
+    if ( !LMAN::isBilateralSlot(s))   // Ignore specified lateral if landmark is not bilateral
         lat = MID;
 
-    _lateral(lat)[id] = v;
+    _reserveSlots( size_t(s)+1);
+    _lateral(lat)[size_t(s)] = v;
+    if ( !_has( s, lat))
+    {
+        _lats[size_t(s)] |= lat;
+        _size++;
+    }   // end if
     _ids.insert(id);
     return true;
 }   // end set
@@ -163,7 +176,11 @@ const Vec3f& LandmarkSet::pos( int id, FaceSide lat) const
 {
     static const Vec3f ZERO_VEC = Vec3f::Zero();    // Otherwise returning reference to temporary
 
-    if ( LMAN::landmark(id)->isBilateral() && lat == MID)
+    const int s = LMAN::slot(id);
+    if ( s >= 0 && size_t(s) < _lats.size() && _has( s, lat))
+        return _clateral(lat)[size_t(s)];
+
+    if ( s >= 0 && LMAN::isBilateralSlot(s) && lat == MID)
     {
         std::cerr << "[ERROR] FaceTools::Landmark::LandmarkSet::pos: Requested landmark is bilateral but requested medial!" << std::endl;
         assert(false);
@@ -171,10 +188,7 @@ const Vec3f& LandmarkSet::pos( int id, FaceSide lat) const
     }   // end if
 
     assert(has(id, lat));
-    if (!has(id, lat))
-        return ZERO_VEC;
-
-    return lateral(lat).at(id);
+    return ZERO_VEC;
 }   // end pos
 
 
@@ -204,7 +218,7 @@ r3d::Mesh::Ptr LandmarkSet::toMesh() const
     r3d::Mesh::Ptr mesh = r3d::Mesh::create();
     for ( int id : lmids)
     {
-        if ( LMAN::landmark(id)->isBilateral())
+        if ( LMAN::isBilateral(id))
         {
             mesh->addVertex( pos( id, LEFT));
             mesh->addVertex( pos( id, RIGHT));
@@ -220,11 +234,9 @@ r3d::Mesh::Ptr LandmarkSet::toMesh() const
 Vec3f LandmarkSet::eyeVec() const
 {
     Vec3f v = Vec3f::Zero();
-    if ( has( LMAN::codeId(P)))
-    {
-        const int id = LMAN::landmark(P)->id(); // Get the id of the pupil landmark
+    const int id = LMAN::codeId(P); // Get the id of the pupil landmark
+    if ( has( id))
         v = pos( id, RIGHT) - pos( id, LEFT);
-    }   // end if
     return v;
 }   // end eyeVec
 
@@ -232,52 +244,29 @@ Vec3f LandmarkSet::eyeVec() const
 Vec3f LandmarkSet::midEyePos() const
 {
     Vec3f v = Vec3f::Zero();
-    if ( has( LMAN::codeId(P)))
-    {
-        const int id = LMAN::landmark(P)->id(); // Get the id of the pupil landmark
+    const int id = LMAN::codeId(P); // Get the id of the pupil landmark
+    if ( has( id))
         v = 0.5f*(pos( id, RIGHT) + pos( id, LEFT));
-    }   // end if
     return v;
 }   // end midEyePos
 
-namespace {
 
-Vec3f getMeanOfSet( const IntSet &ms, const std::unordered_map<int, Vec3f> &lmks)
+Vec3f LandmarkSet::medialMean() const
 {
     int cnt = 0;
     Vec3f p = Vec3f::Zero();
-    for ( int lid : ms)
+    for ( int lid : LMAN::medialAlignmentSet())
     {
-        if ( lmks.count(lid) > 0)
+        if ( has( lid, MID))
         {
-            p += lmks.at(lid);
+            p += _lmksM[size_t(LMAN::slot(lid))];
             cnt++;
         }   // end if
     }   // end for
     if ( cnt > 0)
         p /= cnt;
     return p;
-}   // end getMeanOfSet
-
-}   // end namespace
-
-
-Vec3f LandmarkSet::medialMean() const { return getMeanOfSet( LMAN::medialAlignmentSet(), _lmksM);}
-
-
-namespace {
-
-void testSetExtreme( Vec3f &minc, Vec3f &maxc, const Vec3f &v)
-{
-    minc[0] = std::min( minc[0], v[0]);
-    maxc[0] = std::max( maxc[0], v[0]);
-    minc[1] = std::min( minc[1], v[1]);
-    maxc[1] = std::max( maxc[1], v[1]);
-    minc[2] = std::min( minc[2], v[2]);
-    maxc[2] = std::max( maxc[2], v[2]);
-}   // end testSetExtreme
-
-}   // end namespace
+}   // end medialMean
 
 
 r3d::Bounds::Ptr LandmarkSet::makeBounds( const Mat4f &T, const Mat4f &iT) const
@@ -285,12 +274,21 @@ r3d::Bounds::Ptr LandmarkSet::makeBounds( const Mat4f &T, const Mat4f &iT) const
     Vec3f minc( FLT_MAX, FLT_MAX, FLT_MAX);
     Vec3f maxc = -minc;
 
-    for ( const auto& p : _lmksL)
-        testSetExtreme( minc, maxc, r3d::transform( iT, p.second));
-    for ( const auto& p : _lmksM)
-        testSetExtreme( minc, maxc, r3d::transform( iT, p.second));
-    for ( const auto& p : _lmksR)
-        testSetExtreme( minc, maxc, r3d::transform( iT, p.second));
+    const Mat3f R = iT.block<3,3>(0,0);
+    const Vec3f t = iT.block<3,1>(0,3);
+    for ( FaceSide lat : LATS)
+    {
+        const LDMRKS &vs = _clateral(lat);
+        for ( size_t s = 0; s < _lats.size(); ++s)
+        {
+            if ( _has( int(s), lat))
+            {
+                const Vec3f v = R * vs[s] + t;
+                minc = minc.cwiseMin(v);
+                maxc = maxc.cwiseMax(v);
+            }   // end if
+        }   // end for
+    }   // end for
 
     const Vec3f cen = r3d::transform( iT, medialMean());
 
@@ -314,46 +312,39 @@ float LandmarkSet::sqRadius() const
 {
     float sqDist = 0.0f;
     const Vec3f mean = medialMean();
-    for ( const auto& p : _lmksL)
-        sqDist = std::max( (p.second - mean).squaredNorm(), sqDist);
-    for ( const auto& p : _lmksM)
-        sqDist = std::max( (p.second - mean).squaredNorm(), sqDist);
-    for ( const auto& p : _lmksR)
-        sqDist = std::max( (p.second - mean).squaredNorm(), sqDist);
-    return sqDist;
-}   // end sqRadius
-
-
-namespace {
-
-void nearestFromSet( FaceSide side, const std::unordered_map<int, Vec3f> &lmksSet,
-                     const SLmk &slmk, const Vec3f &slmkPos, float &sqDist, SLmk &nlmk)
-{
-    for ( const auto& p : lmksSet)
+    for ( FaceSide lat : LATS)
     {
-        if ( p.first == slmk.id && slmk.lat == side)
-            continue;
-        const float sqd = (p.second - slmkPos).squaredNorm();
-        if ( sqd < sqDist)
-        {
-            sqDist = sqd;
-            nlmk.id = p.first;
-            nlmk.lat = side;
-        }   // end if
+        const LDMRKS &vs = _clateral(lat);
+        for ( size_t s = 0; s < _lats.size(); ++s)
+            if ( _has( int(s), lat))
+                sqDist = std::max( (vs[s] - mean).squaredNorm(), sqDist);
     }   // end for
-}   // end nearestFromSet
-
-}   // end namespace
+    return sqDist;
+}   // end sqRadius
 
 
 SLmk LandmarkSet::nearest( const SLmk &slmk) const
 {
     const Vec3f &lmkPos = pos(slmk);
+    const int sslot = LMAN::slot(slmk.id);
     float sqDist = FLT_MAX;
     SLmk nlmk;
-    nearestFromSet( LEFT,  _lmksL, slmk, lmkPos, sqDist, nlmk);
-    nearestFromSet( MID,   _lmksM, slmk, lmkPos, sqDist, nlmk);
-    nearestFromSet( RIGHT, _lmksR, slmk, lmkPos, sqDist, nlmk);
+    for ( FaceSide lat : LATS)
+    {
+        const LDMRKS &vs = _clateral(lat);
+        for ( size_t s = 0; s < _lats.size(); ++s)
+        {
+            if ( !_has( int(s), lat) || (int(s) == sslot && slmk.lat == lat))
+                continue;
+            const float sqd = (vs[s] - lmkPos).squaredNorm();
+            if ( sqd < sqDist)
+            {
+                sqDist = sqd;
+                nlmk.id = LMAN::slotId(int(s));
+                nlmk.lat = lat;
+            }   // end if
+        }   // end for
+    }   // end for
     return nlmk;
 }   // end nearest
 
@@ -362,47 +353,71 @@ SLmk LandmarkSet::nearest( int id, FaceSide lat) const { return nearest( SLmk( i
 
 void LandmarkSet::swapLaterals()
 {
-    const auto tmp = _lmksL;
-    _lmksL = _lmksR;
-    _lmksR = tmp;
+    _lmksL.swap( _lmksR);
+    for ( uint8_t &lats : _lats)
+    {
+        const uint8_t l = lats & LEFT;
+        const uint8_t r = lats & RIGHT;
+        lats = uint8_t((lats & MID) | (l ? RIGHT : 0) | (r ? LEFT : 0));
+    }   // end for
 }   // end swapLaterals
 
 
 void LandmarkSet::moveToSurface( const FaceTools::FM* fm)
 {
-    for ( const auto& p : _lmksL)
-        _lmksL.at(p.first) = FaceTools::toSurface( fm->kdtree(), p.second);
-    for ( const auto& p : _lmksM)
-        _lmksM.at(p.first) = FaceTools::toSurface( fm->kdtree(), p.second);
-    for ( const auto& p : _lmksR)
-        _lmksR.at(p.first) = FaceTools::toSurface( fm->kdtree(), p.second);
+    // Gather all positions into a single batch for projection
+    std::vector<Vec3f> pts;
+    pts.reserve( _size);
+    for ( FaceSide lat : LATS)
+    {
+        const LDMRKS &vs = _clateral(lat);
+        for ( size_t s = 0; s < _lats.size(); ++s)
+            if ( _has( int(s), lat))
+                pts.push_back( vs[s]);
+    }   // end for
+
+    FaceTools::toSurface( fm->kdtree(), pts, pts);
+
+    size_t i = 0;
+    for ( FaceSide lat : LATS)
+    {
+        LDMRKS &vs = _lateral(lat);
+        for ( size_t s = 0; s < _lats.size(); ++s)
+            if ( _has( int(s), lat))
+                vs[s] = pts[i++];
+    }   // end for
 }   // end moveToSurface
 
 
 void LandmarkSet::transform( const Mat4f& t)
 {
     assert( !t.isZero());
-    for ( auto& p : _lmksL)
-        p.second = r3d::transform( t, p.second);
-    for ( auto& p : _lmksM)
-        p.second = r3d::transform( t, p.second);
-    for ( auto& p : _lmksR)
-        p.second = r3d::transform( t, p.second);
+    if ( _lats.empty())
+        return;
+    // Transform all slots at once (unset slots are ignored elsewhere so transforming them is harmless)
+    const Mat3f R = t.block<3,3>(0,0);
+    const Vec3f tr = t.block<3,1>(0,3);
+    for ( FaceSide lat : LATS)
+    {
+        Eigen::Map<Mat3Xf> m = asMatrix( _lateral(lat));
+        m = (R * m).colwise() + tr;
+    }   // end for
 }   // end transform
 
 
 // Write out the landmarks to record.
 void LandmarkSet::write( PTree& lnodes) const
 {
-    PTree& llat = lnodes.put("LeftSide", "");
-    for ( const auto& p : _lmksL)
-        r3d::putNamedVertex( llat, LMAN::landmark(p.first)->code().toStdString(), p.second);
-    PTree& mlat = lnodes.put("Medial", "");
-    for ( const auto& p : _lmksM)
-        r3d::putNamedVertex( mlat, LMAN::landmark(p.first)->code().toStdString(), p.second);
-    PTree& rlat = lnodes.put("RightSide", "");
-    for ( const auto& p : _lmksR)
-        r3d::putNamedVertex( rlat, LMAN::landmark(p.first)->code().toStdString(), p.second);
+    static const char* TAGS[3] = {"LeftSide", "Medial", "RightSide"};
+    for ( int i = 0; i < 3; ++i)
+    {
+        const FaceSide lat = LATS[i];
+        PTree& ltree = lnodes.put( TAGS[i], "");
+        const LDMRKS &vs = _clateral(lat);
+        for ( size_t s = 0; s < _lats.size(); ++s)
+            if ( _has( int(s), lat))
+                r3d::putNamedVertex( ltree, LMAN::landmark( LMAN::slotId(int(s)))->code().toStdString(), vs[s]);
+    }   // end for
 }   // end write
 
 
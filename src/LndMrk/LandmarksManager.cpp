@@ -36,6 +36,9 @@ QMap<QString, QString> LandmarksManager::_names;
 IntSet LandmarksManager::_mset;
 IntSet LandmarksManager::_bset;
 IntSet LandmarksManager::_tset;
+std::vector<int> LandmarksManager::_slots;
+std::vector<int> LandmarksManager::_slotIds;
+std::vector<bool> LandmarksManager::_bslots;
 
 
 QStringList LandmarksManager::names()
@@ -116,6 +119,9 @@ int LandmarksManager::load( const QString& fname)
     _names.clear();
     _lmks.clear();
     _clmks.clear();
+    _slots.clear();
+    _slotIds.clear();
+    _bslots.clear();
 
     const QString fpath = tmpfile->fileName();
     std::vector<rlib::StringVec> lines;
@@ -150,6 +156,12 @@ int LandmarksManager::load( const QString& fname)
         if ( lmk.isMedial())
             _mids.insert(id);
 
+        if ( _slots.size() <= size_t(id))
+            _slots.resize( size_t(id)+1, -1);
+        _slots[size_t(id)] = int(_slotIds.size());
+        _slotIds.push_back(id);
+        _bslots.push_back( lmk.isBilateral());
+
         _codes.append( code);
         _names[name.toLower()] = name;
         _clmks[code] = id;
@@ -23,7 +23,7 @@
 #include <rNonRigid.h>
 #include <QTemporaryDir>
 #include <QFileInfo>
-#include <QThread>
+#include <WorkerPool.h>
 #include <r3d/ProcrustesSuperimposition.h>
 #include <r3d/Bounds.h>
 #include <boost/filesystem/path.hpp>
@@ -162,8 +162,9 @@ bool MaskRegistration::setMask( const QString &mpath)
     }   // end if
 
     //std::cout << "Loading anthropomorphic mask for surface registration..." << std::endl;
-    QThread *thread = QThread::create(
-        [abspath, meshfname, tdir, fm]()
+    // Loaded with user priority since other work waits on the mask being loaded
+    WorkerPool::run(
+        [abspath, meshfname, tdir, fm]( const WorkerPool::Token&)
         {
             s_lock.lockForWrite();  // Setting lock here since need to wait for file op to finish
             QString unused;
@@ -215,9 +216,7 @@ bool MaskRegistration::setMask( const QString &mpath)
             tdir->remove();
             delete tdir;
             s_lock.unlock();
-        });
-    QObject::connect( thread, &QThread::finished, [thread](){ thread->deleteLater();});
-    thread->start();
+        }, WorkerPool::USER);
 
     return true;
 }   // end setMask
@@ -28,10 +28,9 @@ using GD = FaceTools::Metric::GrowthData;
 using MM = FaceTools::Metric::MetricManager;
 using FaceTools::FM;
 
-std::unordered_map<const FM*, std::unordered_map<int, const GD*> > StatsManager::_modelGDs;
+FaceTools::ModelCache<std::unordered_map<int, const GD*> > StatsManager::_modelGDs;
 std::unordered_map<int, const GD*> StatsManager::_metricGDs;
 IntSet StatsManager::_metricDefaults;
-QReadWriteLock StatsManager::_lock;
 
 
 int StatsManager::load( const QString& dname)
@@ -106,47 +105,37 @@ StatsManager::RPtr StatsManager::stats( int mid, const FM *fm)
     if ( !fm || usingDefaultMetricStats( mid))
         return RPtr( _metricGDs.at(mid), []( const GD*){/*no-op*/});
 
-    if ( !_lock.tryLockForRead())
+    assert( _modelGDs.has(fm));
+    const auto mgds = _modelGDs.read(fm);
+    if ( !mgds)
         return nullptr;
 
-    assert( _modelGDs.count(fm) > 0);
-    if ( _modelGDs.count(fm) == 0)
-    {
-        _lock.unlock();
-        return nullptr;
-    }   // end if
-
-    assert( _modelGDs.at(fm).count(mid) > 0);
-    if ( _modelGDs.at(fm).count(mid) == 0)
-    {
-        _lock.unlock();
+    assert( mgds->count(mid) > 0);
+    if ( mgds->count(mid) == 0)
         return nullptr;
-    }   // end if
 
-    const GD *gd = _modelGDs.at(fm).at(mid);
-    return RPtr( gd, []( const GD*){ _lock.unlock();});
+    return RPtr( mgds, mgds->at(mid));   // Shares ownership of the model's read lock
 }   // end stats
 
 
 void StatsManager::updateStatsForModel( const FM &fm)
 {
-    _lock.lockForWrite();
+    _modelGDs.reserve(&fm);
+    auto mgds = std::make_shared<std::unordered_map<int, const GD*> >();
     const IntSet &mids = MM::ids();
     for ( int mid : mids)
     {
         const GrowthDataRanker &gdranker = MM::cmetric(mid)->growthData();
         const GrowthDataSources gds = gdranker.compatible( &fm);
-        _modelGDs[&fm][mid] = gdranker.bestMatch( gds, &fm);
+        (*mgds)[mid] = gdranker.bestMatch( gds, &fm);
     }   // end for
-    _lock.unlock();
+    _modelGDs.set( &fm, mgds);
 }   // end updateStatsForModel
 
 
 void StatsManager::purge( const FM &fm)
 {
-    _lock.lockForWrite();
-    _modelGDs.erase(&fm);
-    _lock.unlock();
+    _modelGDs.purge(&fm);
 }   // end purge
 
 
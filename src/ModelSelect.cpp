@@ -18,7 +18,6 @@
 #include <ModelSelect.h>
 #include <FaceModel.h>
 #include <FaceModelViewer.h>
-#include <Action/FaceActionWorker.h>
 #include <Interactor/SelectNotifier.h>
 #include <FileIO/FaceModelManager.h>
 #include <Vis/FaceView.h>
@@ -37,6 +36,10 @@ using FMM = FaceTools::FileIO::FaceModelManager;
 
 ModelSelect::Ptr ModelSelect::_me;
 
+namespace {
+thread_local FM *_boundModel = nullptr;
+}   // end namespace
+
 
 void ModelSelect::addViewer( FMV* fmv, bool setDefault)
 {
@@ -51,6 +54,9 @@ void ModelSelect::addViewer( FMV* fmv, bool setDefault)
 void ModelSelect::setStatusBar( QStatusBar* sb) { me()->_sbar = sb;}
 
 
+QStatusBar* ModelSelect::statusBar() { return me()->_sbar;}
+
+
 void ModelSelect::showStatus( const QString& msg, int timeOut, bool repaintNow)
 {
     QStatusBar *sbar = me()->_sbar;
@@ -85,9 +91,7 @@ void ModelSelect::setCursor( Qt::CursorShape cs)
 
 void ModelSelect::restoreCursor()
 {
-    if ( Action::FaceActionWorker::isUserWorking())
-        setCursor( Qt::CursorShape::BusyCursor);
-    else if ( defaultViewer()->interactionMode() == IMode::ACTOR_INTERACTION)
+    if ( defaultViewer()->interactionMode() == IMode::ACTOR_INTERACTION)
         setCursor( Qt::CursorShape::DragMoveCursor);
     else
         setCursor( Qt::CursorShape::ArrowCursor);
@@ -154,7 +158,24 @@ void ModelSelect::setViewAngle( double v)
 }   // end setViewAngle
 
 
-FV* ModelSelect::selectedView() { return _selectNotifier()->selected();}
+FM* ModelSelect::bindSelected( FM *fm)
+{
+    FM *pfm = _boundModel;
+    _boundModel = fm;
+    return pfm;
+}   // end bindSelected
+
+
+FM* ModelSelect::boundModel() { return _boundModel;}
+
+
+FV* ModelSelect::selectedView()
+{
+    FV *fv = _selectNotifier()->selected();
+    if ( _boundModel && (!fv || fv->data() != _boundModel))
+        fv = _boundModel->fvs().empty() ? nullptr : _boundModel->fvs().first();
+    return fv;
+}   // end selectedView
 
 
 FM::RPtr ModelSelect::selectedModelScopedRead()
@@ -258,7 +279,7 @@ void ModelSelect::setSelected( FV* fv)
 {
     QSignalBlocker blocker(_selectNotifier());
     _forceUnlockSelect();
-    FV* sv = selectedView();
+    FV* sv = _selectNotifier()->selected();
     if ( sv) // First deselect any currently selected view.
         _selectNotifier()->setSelected( sv, false);
     if ( fv) // Then select the given view.
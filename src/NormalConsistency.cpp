@@ -0,0 +1,174 @@
+/************************************************************************
+ * Copyright (C) 2021 SIS Research Ltd & Richard Palmer
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ ************************************************************************/
+
+#include <NormalConsistency.h>
+#include <FaceTools.h>
+#include <r3d/FaceParser.h>
+#include <cassert>
+using FaceTools::NormalConsistency;
+using FaceTools::IntSet;
+
+const float NormalConsistency::CONSISTENT(0);
+const float NormalConsistency::INCONSISTENT(1);
+const float NormalConsistency::TWISTED(2);
+const char *NormalConsistency::ARRAY_NAME("NormalConsistency");
+
+
+namespace {
+
+struct NormalAgreementParser : r3d::TriangleParser
+{
+    void parseTriangle( int fid, int vroot, int va, int vb) override
+    {
+        const r3d::Vec3f &v0 = mesh->uvtx(vroot);
+        const r3d::Vec3f &v1 = mesh->uvtx(va);
+        const r3d::Vec3f &v2 = mesh->uvtx(vb);
+        const r3d::Vec3f e10 = v1 - v0;
+        const r3d::Vec3f e20 = v2 - v0;
+
+        const r3d::Vec3f cvec = e20.cross(e10);
+        const r3d::Vec3f mvec = mesh->calcFaceVector( fid);
+        // If cvec is in the same direction as mvec (i.e. according to the triangle's current stored vertex order),
+        // then the face id goes in the agree vector, otherwise it goes in disagree.
+        // Note that we don't know what the CORRECT ordering is at this stage since we cannot specify an
+        // authoritative ordering of edges e10 and e20 for the cross product above. But the expectation is
+        // that the set of triangles with vertex orderings that we want to change is the smaller of the
+        // two sets when parsing completes (see getInconsistent below).
+        if ( mvec.dot(cvec) > 0)
+            _agreeFaces.push_back(fid);
+        else
+            _disagreeFaces.push_back(fid);
+    }   // end parseTriangle
+
+    // The "inconsistent" faces is the set that is smaller since we don't know which side
+    // was the "correct" side to start on when we initiated the parsing of faces on this manifold.
+    const std::vector<int> &getInconsistent() const
+    {
+        const std::vector<int> *efids = &_agreeFaces;
+        if ( _disagreeFaces.size() < _agreeFaces.size())
+            efids = &_disagreeFaces;
+        return *efids;
+    }   // end getInconsistent
+
+private:
+    // Vectors that will hold the ids of the faces with normals calculated from their stored
+    // indices that either do or don't agree with the normals calculated using the obtained
+    // vertex order from r3d::FaceParser.
+    std::vector<int> _agreeFaces;
+    std::vector<int> _disagreeFaces;
+};  // end struct
+
+
+struct ManifoldBoundaryParser : r3d::BoundaryParser
+{
+    ManifoldBoundaryParser( const r3d::Manifold &m) : _manf(m) {}
+
+    // Only go beyond this edge if e is not a boundary edge on this (or another) manifold.
+    bool parseEdge( int fid, const r3d::Vec2i &e, int&) override
+    {
+        assert( _manf.faces().count( fid) > 0);
+        const r3d::Mesh &mesh = _manf.mesh();
+        const int eid = mesh.edgeId(e);
+        return _manf.edges().count(eid) == 0 && mesh.nsfaces(eid) <= 2;
+    }   // end parseEdge
+
+private:
+    const r3d::Manifold &_manf;
+};  // end struct
+
+
+struct ManifoldResult
+{
+    bool twisted;
+    std::vector<int> fids;  // Inconsistent faces
+};  // end struct
+
+
+ManifoldResult checkManifold( const r3d::Mesh &mesh, const r3d::Manifold &manf)
+{
+    r3d::FaceParser fparser( mesh);
+
+    NormalAgreementParser naparser;
+    fparser.addTriangleParser( &naparser);
+
+    ManifoldBoundaryParser boundaryParser( manf);
+    fparser.setBoundaryParser( &boundaryParser);
+
+    fparser.parse( *manf.faces().begin());
+    return ManifoldResult{ fparser.twisted(), naparser.getInconsistent()};
+}   // end checkManifold
+
+}   // end namespace
+
+
+NormalConsistency::NormalConsistency( const r3d::Mesh &mesh, const r3d::Manifolds &manfs, bool parallel) : _mesh(mesh)
+{
+    const size_t nm = manfs.count();
+    std::vector<ManifoldResult> results( nm);
+    const auto checkRange = [&]( size_t i0, size_t i1)
+    {
+        for ( size_t i = i0; i < i1; ++i)
+            results[i] = checkManifold( mesh, manfs[int(i)]);
+    };  // end checkRange
+
+    if ( parallel)
+    {
+        // Ensure the lazily calculated manifold edges are ready before parsing concurrently
+        for ( size_t i = 0; i < nm; ++i)
+            manfs[int(i)].edges();
+        parallelFor( nm, checkRange, 1);
+    }   // end if
+    else
+        checkRange( 0, nm);
+
+    for ( size_t i = 0; i < nm; ++i)
+    {
+        const ManifoldResult &res = results[i];
+        if ( res.twisted)
+        {
+            _twisted.insert( int(i));
+            _twistedFaces.insert( res.fids.begin(), res.fids.end());
+        }   // end if
+        else
+            _inconsistent.insert( res.fids.begin(), res.fids.end());
+    }   // end for
+}   // end ctor
+
+
+r3d::Mesh::Ptr NormalConsistency::fixed() const
+{
+    r3d::Mesh::Ptr mesh = _mesh.deepCopy();
+    for ( int fid : _inconsistent)
+        mesh->reverseFaceVertices(fid);
+    return mesh;
+}   // end fixed
+
+
+vtkSmartPointer<vtkFloatArray> NormalConsistency::cellsArray() const
+{
+    assert( _mesh.hasSequentialIds());
+    vtkSmartPointer<vtkFloatArray> arr = vtkSmartPointer<vtkFloatArray>::New();
+    arr->SetName( ARRAY_NAME);
+    arr->SetNumberOfComponents(1);
+    arr->SetNumberOfTuples( _mesh.numFaces());
+    arr->Fill( CONSISTENT);
+    for ( int fid : _inconsistent)
+        arr->SetValue( fid, INCONSISTENT);
+    for ( int fid : _twistedFaces)
+        arr->SetValue( fid, TWISTED);
+    return arr;
+}   // end cellsArray
@@ -24,9 +24,14 @@ using FaceTools::Mat4f;
 using FaceTools::Mat3f;
 using FaceTools::Path;
 using FaceTools::FM;
+using Mat3Xf = Eigen::Matrix<float, 3, Eigen::Dynamic>;
 
 namespace {
 
+// View the given vector of positions as a 3xN matrix.
+Eigen::Map<Mat3Xf> asMatrix( std::vector<Vec3f> &v) { return Eigen::Map<Mat3Xf>( reinterpret_cast<float*>( v.data()), 3, v.size());}
+Eigen::Map<const Mat3Xf> asMatrix( const std::vector<Vec3f> &v) { return Eigen::Map<const Mat3Xf>( reinterpret_cast<const float*>( v.data()), 3, v.size());}
+
 float _calcAngle( const Vec3f &dh0, const Vec3f &dh1)
 {
     float angle = NAN;
@@ -76,13 +81,11 @@ Path Path::mapSrcToDst( const FM *sfm, const FM *dfm) const
     pth._orient = T.block<3,3>(0,0) * iT.block<3,3>(0,0) * _orient;
     pth._orient.normalize();
 
-    Vec3f h0, h1, hd;
-    barycentricMapSrcToDst( sfm, handle0(), dfm, h0);
-    barycentricMapSrcToDst( sfm, handle1(), dfm, h1);
-    barycentricMapSrcToDst( sfm, depthHandle(), dfm, hd);
-    pth.setHandle0( h0);
-    pth.setHandle1( h1);
-    pth.setDepthHandle( hd);
+    std::vector<Vec3f> hs = {handle0(), handle1(), depthHandle()};
+    barycentricMapSrcToDst( sfm, hs, dfm, hs);
+    pth.setHandle0( hs[0]);
+    pth.setHandle1( hs[1]);
+    pth.setDepthHandle( hs[2]);
 
     pth.updatePath( dfm);
     pth.updateMeasures( dfm->inverseTransformMatrix().block<3,3>(0,0));
@@ -90,7 +93,10 @@ Path Path::mapSrcToDst( const FM *sfm, const FM *dfm) const
 }   // end mapSrcToDst
 
 
-bool Path::updatePath( const FM* fm)
+bool Path::updatePath( const FM* fm) { return updatePath( fm->kdtree());}
+
+
+bool Path::updatePath( const r3d::KDTree &kdt)
 {
     _validPath = false;
     Vec3f v0 = _vtxs.front();
@@ -107,17 +113,17 @@ bool Path::updatePath( const FM* fm)
         switch ( s_pathType)
         {
             case CURVE_FOLLOWING_0:
-                _validPath = findPath( fm->kdtree(), v0, v1, _vtxs); // Previous
+                _validPath = findPath( kdt, v0, v1, _vtxs); // Previous
                 break;
             case CURVE_FOLLOWING_1:
-                //_validPath = findCurveFollowingPath( fm->kdtree(), v0, v1, _vtxs);   // Experimental
+                //_validPath = findCurveFollowingPath( kdt, v0, v1, _vtxs);   // Experimental
                 break;
             case STRAIGHT_CURVE:
-                //_validPath = findStraightPath( fm->kdtree(), v0, v1, _vtxs);
+                //_validPath = findStraightPath( kdt, v0, v1, _vtxs);
                 break;
             case ORIENTED_CURVE:    // Default
                 assert( u != Vec3f::Zero());
-                _validPath = findSlicedPath( fm->kdtree(), v0, v1, u, _vtxs);
+                _validPath = findSlicedPath( kdt, v0, v1, u, _vtxs);
                 break;
         };  // end switch
     }   // end if
@@ -134,6 +140,15 @@ bool Path::updatePath( const FM* fm)
 }   // end updatePath
 
 
+void Path::setStraight()
+{
+    const Vec3f v0 = handle0();
+    const Vec3f v1 = handle1();
+    _vtxs = {v0, v1};
+    _validPath = false;
+}   // end setStraight
+
+
 void Path::updateMeasures( const Mat3f &iR)
 {
     const Vec3f& h0 = handle0();    // First point in path
@@ -154,40 +169,35 @@ void Path::updateMeasures( const Mat3f &iR)
     // Find two vectors va and vb where va = a-h0, and |va| < dhd, and vb = b-h0, and |vb| >= dhd,
     // and a and b are consecutive points in the surface path.
 
-    float pd = 0.0f;
-    float po = 0.0f;
-    const Vec3f *a = &h0;
-    const Vec3f *b = nullptr;
-    for ( const Vec3f &v : _vtxs) // Always from handle0 to handle1
-    {
-        const Vec3f vh0 = v - h0;   // This vertex delta from h0
-        const float d = vh0.dot(u); // This vertex baseline delta from h0
-
-        // && !b because it's possible (though unlikely) that the projection
-        // will be shorter again after being longer (after b is set).
-        if ( d < dhd && !b)
-            a = &v;
-        else if ( !b)
-            b = &v;
-
-        const float a = std::max( 0.0f, d - pd);    // Baseline delta between this and previous vertex (always >= 0)
-        const float o = sqrtf( std::max( 0.0f, vh0.squaredNorm() - d*d)); // This vertex height from baseline
-        const float b = o - po; // Height (from baseline) delta between this and previous vertex (may be <= 0)
-        _area += a * (o + b/2);
-        _slen += sqrtf(std::max( 0.0f, a*a + b*b));
-        pd = d;
-        po = o;
-    }   // end for
-
-    if ( !b)
-        b = &h1;
-
-    float da = 0.0f;
-    if ( a != &h0)
-        da = (*a - h0).dot(u);   // Projected distance of a along u
-    float db = 0.0f;
-    if ( b != &h0)
-        db = (*b - h0).dot(u);   // Projected distance of b along u
+    // Calculate the baseline deltas (d) and heights from the baseline (o) of all path vertices at once.
+    const size_t N = _vtxs.size();  // Always from handle0 to handle1
+    const Mat3Xf vh0 = asMatrix(_vtxs).colwise() - h0;
+    const Eigen::ArrayXf d = (u.transpose() * vh0).transpose().array();
+    const Eigen::ArrayXf o = (vh0.colwise().squaredNorm().transpose().array() - d.square()).max(0.0f).sqrt();
+
+    // Baseline deltas between consecutive vertices (always >= 0) and height deltas (may be <= 0).
+    Eigen::ArrayXf pd = Eigen::ArrayXf::Zero(N);
+    Eigen::ArrayXf po = Eigen::ArrayXf::Zero(N);
+    pd.tail(N-1) = d.head(N-1);
+    po.tail(N-1) = o.head(N-1);
+    const Eigen::ArrayXf bdel = (d - pd).max(0.0f);
+    const Eigen::ArrayXf hdel = o - po;
+    _area = (bdel * (o + hdel/2)).sum();
+    _slen = (bdel.square() + hdel.square()).sqrt().sum();
+
+    // b is the first vertex with baseline delta >= dhd (or handle1 if none) and a is the vertex before it.
+    // It's possible (though unlikely) that the projection will be shorter again after being longer.
+    size_t ib = 0;
+    while ( ib < N && d[ib] < dhd)
+        ib++;
+    if ( ib == N)
+        ib = N-1;
+    const size_t ia = ib > 0 && d[ib] >= dhd ? ib-1 : ib;
+    const Vec3f *a = &_vtxs[ia];
+    const Vec3f *b = &_vtxs[ib];
+
+    const float da = d[ia];  // Projected distance of a along u
+    const float db = d[ib];  // Projected distance of b along u
 
     // dhd is in [da,db] and vertices a and b are the endpoints of a single path segment.
     // Get the exact point along this segment where depth should be measured from.
@@ -202,8 +212,8 @@ void Path::updateMeasures( const Mat3f &iR)
 
 void Path::transform( const Mat4f &t)
 {
-    for ( Vec3f &v : _vtxs)
-        v = r3d::transform( t, v);
+    Eigen::Map<Mat3Xf> m = asMatrix( _vtxs);
+    m = (t.block<3,3>(0,0) * m).colwise() + t.block<3,1>(0,3);
     _dhan = r3d::transform( t, _dhan);
     _dsurf = r3d::transform( t, _dsurf);
     _dline = r3d::transform( t, _dline);
@@ -17,12 +17,14 @@
 
 #include <PathSet.h>
 #include <FaceModel.h>
+#include <FaceTools.h>
 #include <cassert>
 using FaceTools::PathSet;
 using FaceTools::Path;
 using FaceTools::FM;
 using FaceTools::Vec3f;
 using FaceTools::Mat4f;
+using FaceTools::Mat3f;
 
 
 PathSet::PathSet() : _sid(0) {}
@@ -32,11 +34,21 @@ PathSet::~PathSet(){}
 
 void PathSet::update( const FM* fm)
 {
+    // Paths are independent of one another so are updated in parallel
+    std::vector<Path*> paths;
+    paths.reserve( _paths.size());
     for ( auto& p : _paths)
+        paths.push_back( &p.second);
+
+    const Mat3f iR = fm->inverseTransformMatrix().block<3,3>(0,0);
+    parallelFor( paths.size(), [&]( size_t i0, size_t i1)
     {
-        p.second.updatePath( fm);
-        p.second.updateMeasures( fm->inverseTransformMatrix().block<3,3>(0,0));
-    }   // end for
+        for ( size_t i = i0; i < i1; ++i)
+        {
+            paths[i]->updatePath( fm);
+            paths[i]->updateMeasures( iR);
+        }   // end for
+    });
 }   // end update
 
 
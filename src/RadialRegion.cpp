@@ -0,0 +1,149 @@
+/************************************************************************
+ * Copyright (C) 2021 SIS Research Ltd & Richard Palmer
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ ************************************************************************/
+
+#include <RadialRegion.h>
+#include <algorithm>
+#include <cassert>
+using FaceTools::RadialRegion;
+using FaceTools::Vec3f;
+
+
+RadialRegion::Ptr RadialRegion::create( const r3d::Mesh &mesh) { return Ptr( new RadialRegion( mesh));}
+
+
+RadialRegion::RadialRegion( const r3d::Mesh &mesh)
+    : _mesh(mesh), _within(nullptr), _cfid(-1), _centre(Vec3f::Zero()), _radius(0), _n(0), _nchanged(0) {}
+
+
+void RadialRegion::update( int cfid, const Vec3f &c, float r, const IntSet *fids)
+{
+    assert( cfid >= 0);
+    assert( !fids || fids->count(cfid) > 0);
+    const size_t n0 = _fids.size();
+    _nchanged = 0;
+    if ( cfid != _cfid || c != _centre || fids != _within)
+    {
+        _nchanged = n0;
+        _reset( cfid, c, fids);
+    }   // end if
+    _radius = r;
+
+    // Grow by the faces reached within the radius, reaching new faces only when all
+    // of those already reached are in the region. The centre face is always added.
+    while ( _n == _order.size() ? _reachNext() : true)
+    {
+        if ( _n > 0 && _order[_n].first > r)
+            break;
+        _add( _order[_n++].second);
+    }   // end while
+
+    // Shrink by removing the furthest faces beyond the radius.
+    while ( _n > 1 && _order[_n-1].first > r)
+        _remove( _order[--_n].second);
+}   // end update
+
+
+// private
+void RadialRegion::_reset( int cfid, const Vec3f &c, const IntSet *fids)
+{
+    _cfid = cfid;
+    _centre = c;
+    _within = fids;
+    _order.clear();
+    _front = decltype(_front)();
+    _reached.clear();
+    _n = 0;
+    _fids.clear();
+    _ecounts.clear();
+    _bedges.clear();
+    _front.push( Item( 0.0f, cfid));
+}   // end _reset
+
+
+// private
+float RadialRegion::_distance( int fid) const
+{
+    const int *fvidxs = _mesh.fvidxs(fid);
+    float d = 0.0f;
+    for ( int i = 0; i < 3; ++i)
+        d = std::max( d, (_mesh.vtx(fvidxs[i]) - _centre).squaredNorm());
+    return sqrtf(d);
+}   // end _distance
+
+
+// private
+bool RadialRegion::_reachNext()
+{
+    while ( !_front.empty())
+    {
+        const Item item = _front.top();
+        _front.pop();
+        if ( _reached.count( item.second) > 0)
+            continue;
+        _reached.insert( item.second);
+        _order.push_back( item);
+
+        // A face's distance is the furthest vertex distance on the way to it
+        const int *fvidxs = _mesh.fvidxs( item.second);
+        for ( int i = 0; i < 3; ++i)
+        {
+            for ( int fid : _mesh.sfaces( fvidxs[i], fvidxs[(i+1)%3]))
+                if ( _reached.count(fid) == 0 && (!_within || _within->count(fid) > 0))
+                    _front.push( Item( std::max( item.first, _distance(fid)), fid));
+        }   // end for
+        return true;
+    }   // end while
+    return false;
+}   // end _reachNext
+
+
+// private
+void RadialRegion::_add( int fid)
+{
+    _fids.insert(fid);
+    _countEdges( fid, +1);
+    _nchanged++;
+}   // end _add
+
+
+// private
+void RadialRegion::_remove( int fid)
+{
+    _fids.erase(fid);
+    _countEdges( fid, -1);
+    _nchanged++;
+}   // end _remove
+
+
+// private
+void RadialRegion::_countEdges( int fid, int d)
+{
+    // An edge is on the boundary if exactly one of its faces is in the region
+    const int *fvidxs = _mesh.fvidxs(fid);
+    for ( int i = 0; i < 3; ++i)
+    {
+        const int eid = _mesh.edgeId( fvidxs[i], fvidxs[(i+1)%3]);
+        int &cnt = _ecounts[eid];
+        cnt += d;
+        if ( cnt == 1)
+            _bedges.insert(eid);
+        else
+            _bedges.erase(eid);
+        if ( cnt == 0)
+            _ecounts.erase(eid);
+    }   // end for
+}   // end _countEdges
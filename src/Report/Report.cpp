@@ -29,7 +29,10 @@
 #include <FaceTools.h>
 #include <U3DCache.h>
 #include <rlib/MathUtil.h>
+#include <QTemporaryDir>
+#include <QMutex>
 #include <QFile>
+#include <atomic>
 #include <boost/filesystem.hpp>
 using FaceTools::Metric::GrowthData;
 using FaceTools::Metric::MetricValue;
@@ -96,6 +99,26 @@ std::string metricCurrentSource( const FM *fm, int mid)
 }   // end metricCurrentSource
 
 
+// Assets identical between reports are made once (keyed by the given key) into a
+// cache directory with their paths returned for copying into report directories.
+QString cachedAsset( const QString &key, const QString &suffix, const std::function<bool( const QString&)> &make)
+{
+    static QTemporaryDir cacheDir;
+    static QMutex mutex;
+    static std::unordered_map<QString, QString> assets;
+
+    QMutexLocker locker( &mutex);
+    const auto it = assets.find(key);
+    if ( it != assets.end())
+        return it->second;
+    const QString path = cacheDir.filePath( QString("asset%1%2").arg(assets.size()).arg(suffix));
+    if ( !cacheDir.isValid() || !make( path))
+        return "";
+    assets[key] = path;
+    return path;
+}   // end cachedAsset
+
+
 std::unordered_map<int, int> footnoteIndices( const FM *fm, const sol::table& mids)
 {
     std::unordered_map<std::string, int> refs;
@@ -224,14 +247,7 @@ Report::Report() : _ltxw(nullptr)
 }   // end ctor
 
 
-Report::~Report()
-{
-    if ( _ltxw)
-    {
-        delete _ltxw;
-        _ltxw = nullptr;
-    }   // end if
-}   // end dtor
+Report::~Report() {}
 
 
 // Convert the box with values in [0,1] to actual
@@ -399,13 +415,16 @@ bool Report::isAvailable() const
 }   // end isAvailable
 
 
-bool Report::setContent()
+bool Report::setContent() { return setContent( MS::selectedModel(), MS::nonSelectedModel());}
+
+
+bool Report::setContent( const FM *fm0, const FM *fm1)
 {
     _errMsg = "";
-    if ( _ltxw)
-        delete _ltxw;
-    _ltxw = new LatexWriter( _pageDims.width(), _pageDims.height());
-    _validContent = _writeLatex();
+    _content = std::make_shared<Content>();
+    _content->_ltxw.reset( new LatexWriter( _pageDims.width(), _pageDims.height()));
+    _ltxw = _content->_ltxw.get();
+    _validContent = _writeLatex( fm0, fm1);
     if ( !_validContent)
         _errMsg = tr( "Failed to set report contents!");
     return _validContent;
@@ -415,11 +434,76 @@ bool Report::setContent()
 bool Report::generate()
 {
     _errMsg = "";
-    if ( !_ltxw)
+    if ( !_content)
     {
         _errMsg = tr( "Must set report content before generating!");
         return false;
     }   // end if
+    _content->generate();
+    _errMsg = _content->errorMsg();
+    _pdffile = _content->pdffile();
+    return _errMsg.isEmpty();
+}   // end generate
+
+
+bool Report::Content::writeImages( const std::vector<Content*> &contents)
+{
+    std::vector<Action::ActionUpdateThumbnail::ImageRequest> reqs;
+    for ( const Content *c : contents)
+        for ( const Image &im : c->_images)
+            reqs.push_back( {im.fm, im.mesh.get(), im.size});
+    if ( reqs.empty())
+        return true;
+
+    std::vector<QImage> imgs;
+    try
+    {
+        imgs = Action::ActionUpdateThumbnail::generateImages( reqs, 30, 0.8f);
+    }   // end try
+    catch ( const std::exception &e)
+    {
+        std::cerr << "[ERROR] FaceTools::Report::Content::writeImages: " << e.what() << std::endl;
+    }   // end catch
+
+    bool allOk = true;
+    size_t j = 0;
+    for ( Content *c : contents)
+    {
+        for ( const Image &im : c->_images)
+        {
+            if ( imgs.empty() || !imgs[j++].save( im.path))
+            {
+                std::cerr << "[ERROR] FaceTools::Report::Content::writeImages: Unable to save image!" << std::endl;
+                c->_imagesOk = false;
+                allOk = false;
+            }   // end if
+        }   // end for
+        c->_images.clear();    // Only need writing once
+    }   // end for
+    return allOk;
+}   // end writeImages
+
+
+bool Report::Content::generate()
+{
+    _errMsg = "";
+    writeImages( {this});   // Unless already written in a batch with other contents
+    std::atomic<bool> assetsOk( _imagesOk);
+    parallelFor( _assets.size(), [this, &assetsOk]( size_t i0, size_t i1)
+    {
+        for ( size_t i = i0; i < i1; ++i)
+            if ( !_assets[i]())
+                assetsOk = false;
+    });
+    _assets.clear();    // Only need writing once
+
+    if ( !assetsOk)
+    {
+        _errMsg = tr("Failed to write the report assets!");
+        std::cerr << _errMsg.toStdString() << std::endl;
+        return false;
+    }   // end if
+
     const std::string outpdf = _ltxw->makePDF();
     if ( outpdf.empty())
     {
@@ -433,7 +517,7 @@ bool Report::generate()
 }   // end generate
 
 
-bool Report::_writeLatex()
+bool Report::_writeLatex( const FM *fm0, const FM *fm1)
 {
     assert(_ltxw);
     LatexWriter &ltxw = *_ltxw;
@@ -453,7 +537,8 @@ bool Report::_writeLatex()
     // Note that this is a resource so need to use Qt's file copy.
     const std::string logopdf = "logo.pdf";
     const QString logopath = QString::fromStdString( (workdir / logopdf).string());
-    if ( !QFile( s_logoPath).copy( logopath))
+    const QString logocache = cachedAsset( s_logoPath, ".pdf", []( const QString &p){ return QFile( s_logoPath).copy(p);});
+    if ( logocache.isEmpty() || !QFile::copy( logocache, logopath))
         return false;
 
     ltxw << "\\usepackage{footnote}\n"
@@ -472,9 +557,7 @@ bool Report::_writeLatex()
     _validContent = true;
     try
     {
-        const FM *fm0 = MS::selectedModel();
         assert( fm0);
-        const FM *fm1 = MS::nonSelectedModel();
         if (_twoModels && fm1)
             _setContent( fm0, fm1);   // Lua call to add report elements
         else
@@ -490,29 +573,26 @@ bool Report::_writeLatex()
 }   // end _writeLatex
 
 
-std::string Report::_writeModelBGImage( const QRectF &box, const FM *fm, const r3d::Mesh &mesh)
+std::string Report::_writeModelBGImage( const QRectF &box, const FM *fm, std::shared_ptr<const r3d::Mesh> mesh)
 {
     const float pw = _pageDims.width(); 
     const float ph = _pageDims.height();
     // Background image for model until user enables 3D content to replace this.
     const float RES = 72.0f/25.4f;  // Pixels per mm
     const QSize bimSz( box.width() * pw * RES, box.height() * ph * RES);
-    const QImage img = Action::ActionUpdateThumbnail::generateImage( fm, mesh, bimSz, 30, 0.8f);
-    BFS::path imgFile = BFS::unique_path( "%%%%-%%%%-%%%%-%%%%.jpg");
+    const BFS::path imgFile = BFS::unique_path( "%%%%-%%%%-%%%%-%%%%.jpg");
     const BFS::path workDir = _ltxw->workingDirectory();
-    // Save the image into the working directory
-    if ( !img.save( QString::fromStdString( (workDir/imgFile).string())))
-    {
-        std::cerr << "[ERROR] FaceTools::Report::_writeModelBGImage: Unable to save image!" << std::endl;
-        imgFile = "";
-    }   // end if
+    const QString imgPath = QString::fromStdString( (workDir/imgFile).string());
+    // Render and save the image into the working directory when the content is generated
+    _content->_images.push_back( {fm, mesh, bimSz, imgPath});
     return imgFile.string();
 }   // end _writeModelBGImage
 
 
 std::string Report::_writeModelBGImage( const QRectF &box, const FM *fm)
 {
-    return _writeModelBGImage( box, fm, fm->mesh());
+    // The model's mesh isn't owned since the model must outlive generation of the content
+    return _writeModelBGImage( box, fm, std::shared_ptr<const r3d::Mesh>( &fm->mesh(), []( const r3d::Mesh*){}));
 }   // end _writeModelBGImage
 
 
@@ -522,14 +602,14 @@ void Report::_addLatexFigure( const QRectF &box, const FM *fm, const std::string
     if ( !_validContent)
         return;
 
-    // Copy the cached U3D model to the Latex working directory
-    // to allow timely release of the U3D cache lock.
+    // Copy the cached U3D model to the Latex working directory (when the content
+    // is generated) to allow timely release of the U3D cache lock.
     const std::string u3dfile = BFS::unique_path( "%%%%-%%%%-%%%%-%%%%.u3d").string();
-    if ( !_ltxw->copyInFile( U3DCache::u3dfilepath(*fm)->toStdString(), u3dfile))
+    LatexWriter *ltxw = _ltxw;
+    _content->_assets.push_back( [ltxw, fm, u3dfile]()
     {
-        _validContent = false;
-        return;
-    }   // end if
+        return ltxw->copyInFile( U3DCache::u3dfilepath(*fm)->toStdString(), u3dfile);
+    });
 
     const std::string imgfile = _writeModelBGImage( box, fm);
     if ( imgfile.empty())
@@ -562,7 +642,7 @@ void Report::_addLatexSelectedColourMapFigure( const QRectF &box, const std::str
         return;
     }   // end if
 
-    const std::string imgfile = _writeModelBGImage( box, fm, *mesh);
+    const std::string imgfile = _writeModelBGImage( box, fm, mesh);
     if ( imgfile.empty())
     {
         _validContent = false;
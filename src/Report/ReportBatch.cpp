@@ -0,0 +1,80 @@
+/************************************************************************
+ * Copyright (C) 2021 SIS Research Ltd & Richard Palmer
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ ************************************************************************/
+
+#include <Report/ReportBatch.h>
+#include <QFile>
+#include <thread>
+#include <atomic>
+using FaceTools::Report::ReportBatch;
+using FaceTools::Report::Report;
+
+
+ReportBatch::ReportBatch( int maxJobs)
+    : _maxJobs( maxJobs > 0 ? size_t(maxJobs) : std::max<size_t>( std::thread::hardware_concurrency(), 1))
+{}   // end ctor
+
+
+bool ReportBatch::add( Report::Ptr report, const QString &pdffile, const FM *fm0, const FM *fm1)
+{
+    if ( !report->setContent( fm0, fm1))
+        return false;
+    Job job;
+    job.content = report->content();
+    job.pdffile = pdffile;
+    _jobs.push_back( job);
+    return true;
+}   // end add
+
+
+size_t ReportBatch::generate()
+{
+    // Render the model images of all the reports as a single batch
+    std::vector<Report::Content*> contents;
+    for ( Job &job : _jobs)
+        contents.push_back( job.content.get());
+    Report::Content::writeImages( contents);
+
+    std::atomic<size_t> next(0);
+    std::atomic<size_t> nsaved(0);
+    const auto worker = [&]()
+    {
+        for ( size_t i = next++; i < _jobs.size(); i = next++)
+        {
+            Job &job = _jobs[i];
+            if ( !job.content->generate())
+                job.errMsg = job.content->errorMsg();
+            else
+            {
+                QFile::remove( job.pdffile);
+                if ( !QFile::copy( job.content->pdffile(), job.pdffile))
+                    job.errMsg = Report::tr("Unable to save the report PDF to %1!").arg(job.pdffile);
+                else
+                    nsaved++;
+            }   // end else
+        }   // end for
+    };  // end worker
+
+    const size_t nthreads = std::min( _maxJobs, _jobs.size());
+    std::vector<std::thread> threads;
+    for ( size_t i = 1; i < nthreads; ++i)
+        threads.emplace_back( worker);
+    worker();   // This thread is a worker too
+    for ( std::thread &t : threads)
+        t.join();
+
+    return nsaved;
+}   // end generate
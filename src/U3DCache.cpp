@@ -19,7 +19,13 @@
 #include <Vis/FaceView.h>
 #include <r3dio/U3DExporter.h>
 #include <r3dvis/VtkTools.h>
-#include <QTemporaryFile>
+#include <QCryptographicHash>
+#include <QStandardPaths>
+#include <QTemporaryDir>
+#include <QDateTime>
+#include <QMutex>
+#include <QSet>
+#include <QDir>
 #include <QTools/QImageTools.h>
 #include <cassert>
 #include <boost/filesystem.hpp>
@@ -29,32 +35,122 @@ using FaceTools::Vis::FV;
 namespace BFS = boost::filesystem;
 
 // static definitions
-QTemporaryDir U3DCache::_tmpdir;
-QReadWriteLock U3DCache::_rwLock;
-std::unordered_map<const FM*, QString> U3DCache::_cache;
+FaceTools::ModelCache<QString> U3DCache::_cache;
 
+namespace {
 
-U3DCache::Filepath U3DCache::u3dfilepath( const FM &fm)
+struct ModelExport
 {
-    QString fname;
-    if ( !_rwLock.tryLockForRead())
-        return nullptr;
-    if ( _cache.count(&fm) > 0)
-        fname = _cache.at(&fm);
-    return Filepath( new QString( fname), []( QString* s){ delete s; _rwLock.unlock();});
-}   // end u3dfilepath
+    std::weak_ptr<const r3d::Mesh> mesh;    // The model's mesh when last exported
+    Mat4f tmat;                             // and its transform at the time
+    QString path;
+};  // end struct
+
+QMutex _lock;   // Guards the below
+std::unordered_map<const FM*, ModelExport> _exports;
+QString _cacheDir;
+qint64 _maxBytes = qint64(1) << 30;
 
 
-bool U3DCache::isAvailable()
+// Hash of everything that affects the exported U3D.
+QString contentKey( const r3d::Mesh &mesh, const QColor &ems)
 {
-    bool avail = false;
-    if ( _rwLock.tryLockForRead())
+    QCryptographicHash hash( QCryptographicHash::Sha1);
+    const int nv = int(mesh.numVtxs());
+    for ( int i = 0; i < nv; ++i)
+        hash.addData( reinterpret_cast<const char*>( mesh.uvtx(i).data()), 3*sizeof(float));
+
+    std::vector<int> fids( mesh.faces().begin(), mesh.faces().end());
+    std::sort( fids.begin(), fids.end());
+    for ( int fid : fids)
     {
-        avail = r3dio::U3DExporter::isAvailable();
-        _rwLock.unlock();
+        hash.addData( reinterpret_cast<const char*>( mesh.fvidxs(fid)), 3*sizeof(int));
+        const int mid = mesh.faceMaterialId(fid);
+        hash.addData( reinterpret_cast<const char*>( &mid), sizeof(int));
+        if ( mid >= 0)
+            for ( int k = 0; k < 3; ++k)
+                hash.addData( reinterpret_cast<const char*>( mesh.faceUV( fid, k).data()), 2*sizeof(float));
+    }   // end for
+
+    std::vector<int> mids( mesh.materialIds().begin(), mesh.materialIds().end());
+    std::sort( mids.begin(), mids.end());
+    for ( int mid : mids)
+    {
+        const cv::Mat tx = mesh.texture(mid);
+        const int dims[3] = {tx.rows, tx.cols, tx.type()};
+        hash.addData( reinterpret_cast<const char*>( dims), sizeof(dims));
+        for ( int r = 0; r < tx.rows; ++r)
+            hash.addData( tx.ptr<char>(r), int(tx.cols * tx.elemSize()));
+    }   // end for
+
+    const Mat4f tmat = mesh.transformMatrix();
+    hash.addData( reinterpret_cast<const char*>( tmat.data()), 16*sizeof(float));
+    const QRgb rgb = ems.rgb();
+    hash.addData( reinterpret_cast<const char*>( &rgb), sizeof(QRgb));
+    return QString::fromLatin1( hash.result().toHex());
+}   // end contentKey
+
+
+rimg::Colour toColour( const QColor &c) { return rimg::Colour( c.red(), c.green(), c.blue());}
+
+
+QColor emissiveColour( const r3d::Mesh &mesh)
+{
+    return mesh.hasMaterials() ? QColor(Qt::white) : FV::BASECOL;
+}   // end emissiveColour
+
+}   // end namespace
+
+
+void U3DCache::setCacheDir( const QString &dir)
+{
+    QMutexLocker lock( &_lock);
+    _cacheDir = dir;
+}   // end setCacheDir
+
+
+QString U3DCache::cacheDir()
+{
+    QMutexLocker lock( &_lock);
+    if ( _cacheDir.isEmpty())
+    {
+        QString cdir = QStandardPaths::writableLocation( QStandardPaths::CacheLocation);
+        if ( cdir.isEmpty() || !QDir().mkpath( cdir + "/u3d"))
+        {
+            static QTemporaryDir tmpdir;
+            cdir = tmpdir.path();
+        }   // end if
+        _cacheDir = cdir + "/u3d";
     }   // end if
-    return avail;
-}   // end isAvailable
+    QDir().mkpath( _cacheDir);
+    return _cacheDir;
+}   // end cacheDir
+
+
+void U3DCache::setMaxBytes( qint64 nbytes)
+{
+    QMutexLocker lock( &_lock);
+    _maxBytes = std::max<qint64>( 0, nbytes);
+}   // end setMaxBytes
+
+
+qint64 U3DCache::maxBytes()
+{
+    QMutexLocker lock( &_lock);
+    return _maxBytes;
+}   // end maxBytes
+
+
+U3DCache::Filepath U3DCache::u3dfilepath( const FM &fm)
+{
+    Filepath fpath = _cache.waitRead(&fm);  // Only blocks while the filepath is being swapped
+    if ( !fpath)
+        fpath = std::make_shared<const QString>();
+    return fpath;
+}   // end u3dfilepath
+
+
+bool U3DCache::isAvailable() { return r3dio::U3DExporter::isAvailable();}
 
 
 bool U3DCache::_exportU3D( const r3d::Mesh &mesh, const QString &savepath, const rimg::Colour &ems)
@@ -70,47 +166,110 @@ bool U3DCache::_exportU3D( const r3d::Mesh &mesh, const QString &savepath, const
 }   // end _exportU3D
 
 
+QString U3DCache::_stored( const QString &key)
+{
+    const QString path = QDir( cacheDir()).filePath( key + ".u3d");
+    QMutexLocker lock( &_lock);
+    QFile file( path);
+    if ( !file.exists())
+        return "";
+    // Mark as recently used so it's among the last to be trimmed
+    if ( file.open( QIODevice::ReadWrite))
+        file.setFileTime( QDateTime::currentDateTime(), QFileDevice::FileModificationTime);
+    return path;
+}   // end _stored
+
+
+QString U3DCache::_store( const QString &key, const r3d::Mesh &mesh, const QColor &ems)
+{
+    const QDir dir( cacheDir());
+    const QString path = dir.filePath( key + ".u3d");
+    // Export to a uniquely named file first so that concurrent exports of the same content don't clash
+    const std::string upath = BFS::unique_path( "%%%%-%%%%-%%%%-%%%%").string();
+    const QString savepath = dir.filePath( QString("%1_%2.u3d.part").arg(key).arg( QString::fromStdString(upath)));
+    if ( !_exportU3D( mesh, savepath, toColour(ems)))
+    {
+        QFile::remove( savepath);
+        return "";
+    }   // end if
+
+    QMutexLocker lock( &_lock);
+    if ( !QFile::rename( savepath, path))   // Same content was stored in the meantime
+        QFile::remove( savepath);
+    return path;
+}   // end _store
+
+
+void U3DCache::_trim()
+{
+    const QFileInfoList finfos = QDir( cacheDir()).entryInfoList( {"*.u3d"}, QDir::Files, QDir::Time | QDir::Reversed);
+    qint64 nbytes = 0;
+    for ( const QFileInfo &finfo : finfos)
+        nbytes += finfo.size();
+
+    QMutexLocker lock( &_lock);
+    QSet<QString> inuse;
+    for ( const auto &p : _exports)
+        inuse.insert( p.second.path);
+
+    // Least recently used first
+    for ( const QFileInfo &finfo : finfos)
+    {
+        if ( nbytes <= _maxBytes)
+            break;
+        const QString path = finfo.absoluteFilePath();
+        if ( !inuse.contains( path) && QFile::remove( path))
+            nbytes -= finfo.size();
+    }   // end for
+}   // end _trim
+
+
 bool U3DCache::refresh( const FM &fm)
 {
     fm.lockForRead();
-    r3d::Mesh::Ptr mesh = fm.mesh().deepCopy();
-    fm.unlock();
-    assert( mesh->hasSequentialVertexIds());
+    const std::shared_ptr<const r3d::Mesh> cmesh = fm.meshPtr();
+    assert( cmesh->hasSequentialVertexIds());
+    const Mat4f tmat = cmesh->transformMatrix();
 
-    rimg::Colour ems = rimg::Colour::white();
-    if ( !mesh->hasMaterials())
+    bool unchanged = false;
+    _lock.lock();
+    const auto it = _exports.find(&fm);
+    if ( it != _exports.end())
+        unchanged = it->second.mesh.lock() == cmesh && it->second.tmat == tmat && QFile::exists( it->second.path);
+    _lock.unlock();
+
+    if ( unchanged)
     {
-        const QColor bc = FV::BASECOL;
-        ems = rimg::Colour( bc.red(), bc.green(), bc.blue());
-        /*
-        // Add a flat texture since none present
-        static const QImage timg(":/textures/BASE_BLUE");
-        if ( timg.isNull())
-            std::cerr << "timg is null! Cannot add pseudo texture!" << std::endl;
-        else
-        {
-            const cv::Mat mat = QTools::copyQImage2OpenCV( timg);
-            const int mid = mesh->addMaterial( mat);
-            static const Vec2f uvs[3] = {Vec2f(1,0), Vec2f(1,1), Vec2f(0,0)};
-            for ( int fid : mesh->faces())
-                mesh->setOrderedFaceUVs( mid, fid, uvs);
-        }   // end else
-        */
+        fm.unlock();
+        return true;
     }   // end if
 
-    const std::string upath = BFS::unique_path( "%%%%-%%%%-%%%%-%%%%.u3d").string();
-    const QString fname = QString("%1_%2").arg(fm.subjectId()).arg( QString::fromStdString(upath));
-    const QString savepath = _tmpdir.filePath( fname);
-    const bool okay = _exportU3D( *mesh, savepath, ems);
+    // Only copy the mesh if there's no existing export of the same content
+    const QColor ems = emissiveColour( *cmesh);
+    const QString key = contentKey( *cmesh, ems);
+    QString savepath = _stored( key);
+    r3d::Mesh::Ptr mesh;
+    if ( savepath.isEmpty())
+        mesh = cmesh->deepCopy();
+    fm.unlock();
+
+    if ( mesh)
+        savepath = _store( key, *mesh, ems);
+    const bool okay = !savepath.isEmpty();
 
-    // Update the reference to the newly cached U3D and remove the old U3D.
+    // Update the reference to the cached U3D. The old U3D remains stored
+    // since it may be the export of other models (or be reused later).
     if ( okay)
     {
-        _rwLock.lockForWrite();
-        if ( _cache.count(&fm) > 0)
-            QFile::remove( _cache.at(&fm));
-        _cache[&fm] = savepath;
-        _rwLock.unlock();
+        if ( std::shared_ptr<QString> fpath = _cache.write(&fm))
+            *fpath = savepath;
+        else
+            _cache.set( &fm, std::make_shared<QString>( savepath));
+
+        _lock.lock();
+        _exports[&fm] = {cmesh, tmat, savepath};
+        _lock.unlock();
+        _trim();
     }   // end if
 
     return okay;
@@ -125,21 +284,31 @@ r3d::Mesh::Ptr U3DCache::makeColourMappedU3D( const FV *fv, const QString &u3dfi
     fm->unlock();
     mesh->removeAllMaterials();
     r3dvis::mapActiveScalarsToMesh( fv->actor(), *mesh);
-    const rimg::Colour ems = rimg::Colour::white();
-    if ( !_exportU3D( *mesh, u3dfile, ems))
-        mesh = nullptr;
+
+    const QColor ems = Qt::white;
+    const QString key = contentKey( *mesh, ems);
+    QString savepath = _stored( key);
+    if ( savepath.isEmpty())
+    {
+        savepath = _store( key, *mesh, ems);
+        _trim();
+    }   // end if
+
+    QFile::remove( u3dfile);
+    // Export directly if not stored (or was trimmed before it could be copied)
+    if ( savepath.isEmpty() || !QFile::copy( savepath, u3dfile))
+    {
+        if ( !_exportU3D( *mesh, u3dfile, toColour(ems)))
+            mesh = nullptr;
+    }   // end if
     return mesh;
 }   // end makeColourMappedU3D
 
 
 void U3DCache::purge( const FM &fm)
 {
-    _rwLock.lockForWrite();
-    if ( _cache.count(&fm) > 0)
-    {
-        QFile::remove( _cache.at(&fm));
-        _cache.erase(&fm);
-    }   // end if
-    _rwLock.unlock();
+    _cache.purge(&fm);
+    _lock.lock();
+    _exports.erase(&fm);
+    _lock.unlock();
 }   // end purge
-
@@ -19,22 +19,32 @@
 #include <Vis/BaseVisualisation.h>
 #include <Vis/MetricVisualiser.h>
 #include <Vis/ColourVisualisation.h>
+#include <Vis/ModelGeometry.h>
+#include <Vis/PickBuffer.h>
 #include <FaceModelCurvatureStore.h>
 #include <FaceModelViewer.h>
 #include <FaceModel.h>
 #include <FaceTools.h>
+#include <WorkerPool.h>
 #include <vtkPointData.h>
+#include <vtkPolyDataMapper.h>
+#include <vtkNew.h>
 #include <vtkProperty.h>
 #include <r3dvis/VtkTools.h>
 #include <QColor>
+#include <QMutex>
 #include <iostream>
 #include <cassert>
 using FaceTools::Vis::FaceView;
 using FaceTools::FMV;
 using FaceTools::FM;
 using FaceTools::Vec3f;
+using FaceTools::Mat4f;
 using BV = FaceTools::Vis::BaseVisualisation;
 using CV = FaceTools::Vis::ColourVisualisation;
+using FaceTools::Vis::ModelGeometry;
+using FaceTools::Vis::PickBuffer;
+using FaceTools::WorkerPool;
 
 
 // static definitions
@@ -50,9 +60,19 @@ void FaceView::setInterpolatedShading( bool v) { s_interpolateShading = v;}
 bool FaceView::interpolatedShading() { return s_interpolateShading;}
 
 
+struct FaceView::PickState
+{
+    PickState() : pending(false) {}
+    QMutex lock;
+    PickBuffer::Ptr buffer;
+    bool pending;   // True while a buffer is being made
+};  // end struct
+
+
 FaceView::FaceView( FM* fm, FMV* viewer)
-    : _data(fm), _actor(nullptr), _texture(nullptr), _nrms(nullptr), _viewer(nullptr), _pviewer(nullptr),
-      _cv(nullptr), _baseCol(FaceView::BASECOL), _minAllowedOpacity(0.0f), _maxAllowedOpacity(1.0f)
+    : _data(fm), _rebuilding(false), _actor(nullptr), _lodActor(nullptr), _lowDetail(false), _texture(nullptr), _nrms(nullptr), _viewer(nullptr), _pviewer(nullptr),
+      _cv(nullptr), _baseCol(FaceView::BASECOL), _minAllowedOpacity(0.0f), _maxAllowedOpacity(1.0f),
+      _pick( std::make_shared<PickState>())
 {
     assert(viewer);
     assert(fm);
@@ -64,11 +84,15 @@ FaceView::FaceView( FM* fm, FMV* viewer)
 
 void FaceView::resetNormals()
 {
+    // The actor is for the old mesh if rebuilding (normals reset once rebuilt)
+    if ( _rebuilding)
+        return;
     const auto &rptr = FaceModelCurvatureStore::rvals( *_data);
-    if ( rptr)
+    vtkPolyData *pdata = r3dvis::getPolyData( _actor);
+    if ( rptr && rptr->normals()->GetNumberOfTuples() == pdata->GetNumberOfPoints())
     {
         _nrms = rptr->normals();
-        r3dvis::getPolyData( _actor)->GetPointData()->SetNormals( _nrms);
+        pdata->GetPointData()->SetNormals( _nrms);
     }   // end if
 }   // end resetNormals
 
@@ -92,6 +116,7 @@ void FaceView::copyFrom( const FaceView *fv)
 
 FaceView::~FaceView()
 {
+    ModelGeometry::cancel(this);
     while ( !_vlayers.empty())
         purge( *_vlayers.begin());
     setViewer(nullptr);
@@ -121,6 +146,7 @@ void FaceView::setViewer( FMV* nviewer)
         // ones that are also available on the new viewer.
         while ( !_vlayers.empty())
             purge( *_vlayers.begin());
+        setLowDetail( false);   // The new viewer sets this as needed on attaching
         _viewer->remove(_actor);
         _viewer->detach(this);
     }   // end if
@@ -149,6 +175,25 @@ void FaceView::setViewer( FMV* nviewer)
 void FaceView::rebuild()
 {
     assert(_viewer);
+    if ( !_actor)   // Nothing to show until there's an actor so build synchronously the first time
+        _setGeometry( ModelGeometry::get( _data));
+    else
+    {
+        // Keep showing the current actor until the new geometry is ready
+        _rebuilding = true;
+        ModelGeometry::prepare( _data, this, [this]( ModelGeometry::Ptr geom)
+        {
+            _setGeometry( geom);
+            _viewer->updateRender();
+        });
+    }   // end else
+}   // end rebuild
+
+
+void FaceView::_setGeometry( ModelGeometry::Ptr geom)
+{
+    assert(_viewer);
+    _rebuilding = false;
 
     // Collect the old visible layers to reapply afterwards
     VisualisationLayers oldVisLayers;
@@ -162,6 +207,12 @@ void FaceView::rebuild()
     const float op = opacity();
     const QColor cl = colour();
 
+    if ( _lodActor)
+    {
+        _viewer->remove(_lodActor); // Proxy recreated (if available) for the new geometry
+        _lodActor = nullptr;
+    }   // end if
+
     if ( _actor)
     {
         _viewer->remove(_actor);    // Remove the actor
@@ -169,8 +220,10 @@ void FaceView::rebuild()
         _texture = nullptr;
     }   // end if
 
-    // Create the new actor from the data
-    _actor = r3dvis::VtkActorCreator::generateActor( _data->mesh());
+    // Create the new actor over the model's geometry (shared with the model's other views)
+    _geom = geom;
+    _actor = _geom->createActor();
+    _actor->PokeMatrix( r3dvis::toVTK( _data->transformMatrix()));  // In case changed while preparing
     _texture = _actor->GetTexture();
 
     resetNormals();
@@ -189,7 +242,53 @@ void FaceView::rebuild()
 
     for ( BV* vis : oldVisLayers)
         apply(vis);
-}   // end reset
+}   // end _setGeometry
+
+
+void FaceView::setLowDetail( bool v)
+{
+    _lowDetail = v;
+    _syncLowDetail();
+}   // end setLowDetail
+
+
+void FaceView::_syncLowDetail()
+{
+    if ( !_lowDetail && !_lodActor)
+        return;
+
+    vtkSmartPointer<vtkPolyData> pdata;
+    if ( _lowDetail && _geom)
+        pdata = _geom->createProxy( r3dvis::getPolyData( _actor));
+
+    if ( !pdata)
+    {
+        if ( _lodActor)
+        {
+            _viewer->remove(_lodActor);
+            _lodActor = nullptr;
+            _actor->SetVisibility( true);
+        }   // end if
+        return;
+    }   // end if
+
+    if ( !_lodActor)
+    {
+        _lodActor = vtkSmartPointer<vtkActor>::New();
+        _lodActor->SetPickable( false);
+        _viewer->add(_lodActor);
+    }   // end if
+
+    // Copy the scalar mapping (visibility, mode, range and lookup table) from the face actor.
+    vtkNew<vtkPolyDataMapper> mapper;
+    mapper->ShallowCopy( _actor->GetMapper());
+    mapper->SetInputData( pdata);
+    _lodActor->SetMapper( mapper);
+    _lodActor->SetProperty( _actor->GetProperty()); // Shared so opacity and colour stay in step
+    _lodActor->SetTexture( _actor->GetTexture());
+    _lodActor->PokeMatrix( _actor->GetMatrix());
+    _actor->SetVisibility( false);
+}   // end _syncLowDetail
 
 
 void FaceView::purge( BV* vis)
@@ -235,6 +334,8 @@ BV* FaceView::_layer( const vtkProp* prop) const
 void FaceView::pokeTransform( const vtkMatrix4x4 *t)
 {
     _actor->PokeMatrix( const_cast<vtkMatrix4x4*>(t));
+    if ( _lodActor)
+        _lodActor->PokeMatrix( const_cast<vtkMatrix4x4*>(t));
     for ( BV* vis : _vlayers)
         vis->syncTransform( this);
 }   // end pokeTransform
@@ -250,10 +351,52 @@ bool FaceView::isPointOnFace( const QPoint& p) const
 bool FaceView::projectToSurface( const QPoint& p, Vec3f& pos) const
 {
     assert(_viewer);
+    const PickBuffer::Ptr pbuff = _pickBuffer();
+    if ( pbuff)
+        return pbuff->surfacePosition( p, pos);
     return _viewer->calcSurfacePosition( _actor, p, pos);
 }   // end projectToSurface
 
 
+// private
+PickBuffer::Ptr FaceView::_pickBuffer() const
+{
+    // The proxy is shown in place of the actor while the camera moves so don't make buffers then
+    if ( !_geom || lowDetail())
+        return nullptr;
+    std::shared_ptr<const r3d::Mesh> mesh = _geom->mesh();  // Of the actor (not the model if rebuilding)
+    if ( !mesh)
+        return nullptr;
+
+    // The viewer's dimensions are in device pixels while the points projected are logical
+    const int w = int(_viewer->getWidth());
+    const int h = int(_viewer->getHeight());
+    const float dpr = float(_viewer->devicePixelRatioF());
+    const Mat4f tmat = r3dvis::toEigen( _actor->GetMatrix());
+    const Mat4f ndc = PickBuffer::deviceMatrix( _viewer->getRenderer()) * tmat;
+
+    _pick->lock.lock();
+    PickBuffer::Ptr pbuff = _pick->buffer;
+    if ( pbuff && !pbuff->isFor( mesh.get(), ndc, w, h, dpr))
+        pbuff = nullptr;
+    if ( !pbuff && !_pick->pending && w > 0 && h > 0)
+    {
+        _pick->pending = true;
+        std::shared_ptr<PickState> pick = _pick;
+        WorkerPool::run( [pick, mesh, ndc, tmat, w, h, dpr]( const WorkerPool::Token&)
+        {
+            PickBuffer::Ptr nbuff = PickBuffer::create( mesh, ndc, tmat, w, h, dpr);
+            pick->lock.lock();
+            pick->buffer = nbuff;
+            pick->pending = false;
+            pick->lock.unlock();
+        }, WorkerPool::BACKGROUND);
+    }   // end if
+    _pick->lock.unlock();
+    return pbuff;
+}   // end _pickBuffer
+
+
 bool FaceView::overlaps() const
 {
     assert(_viewer);
@@ -389,12 +532,15 @@ void FaceView::setActiveColours( CV* cv)
 }   // end setActiveColours
 
 
-void FaceView::addCellsArray( vtkFloatArray *arr) { CV::addCellsArray(_actor, arr);}
-void FaceView::addPointsArray( vtkFloatArray *arr) { CV::addPointsArray(_actor, arr);}
-void FaceView::setActiveCellScalars( const char *n) { CV::setActiveCellScalars(_actor, n);}
-void FaceView::setActiveCellVectors( const char *n) { CV::setActiveCellVectors(_actor, n);}
-void FaceView::setActivePointScalars( const char *n) { CV::setActivePointScalars(_actor, n);}
-void FaceView::setActivePointVectors( const char *n) { CV::setActivePointScalars(_actor, n);}
+// Arrays are sized for the new mesh so aren't added to the old actor while rebuilding
+// (they're added to the new actor when the visualisation layers are reapplied).
+// The proxy's arrays are resampled from the face actor's so are synchronised after changing.
+void FaceView::addCellsArray( vtkFloatArray *arr) { if ( !_rebuilding) CV::addCellsArray(_actor, arr); _syncLowDetail();}
+void FaceView::addPointsArray( vtkFloatArray *arr) { if ( !_rebuilding) CV::addPointsArray(_actor, arr); _syncLowDetail();}
+void FaceView::setActiveCellScalars( const char *n) { CV::setActiveCellScalars(_actor, n); _syncLowDetail();}
+void FaceView::setActiveCellVectors( const char *n) { CV::setActiveCellVectors(_actor, n); _syncLowDetail();}
+void FaceView::setActivePointScalars( const char *n) { CV::setActivePointScalars(_actor, n); _syncLowDetail();}
+void FaceView::setActivePointVectors( const char *n) { CV::setActivePointScalars(_actor, n); _syncLowDetail();}
 
 
 void FaceView::_updateSurfaceProperties()
@@ -421,4 +567,6 @@ void FaceView::_updateSurfaceProperties()
     _actor->GetMapper()->SetInterpolateScalarsBeforeMapping(false);
     if ( s_interpolateShading)
         _actor->GetMapper()->SetInterpolateScalarsBeforeMapping(true);
+
+    _syncLowDetail();
 }   // end _updateSurfaceProperties
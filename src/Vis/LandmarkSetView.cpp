@@ -22,11 +22,9 @@
 #include <iostream>
 #include <cassert>
 using FaceTools::Vis::LandmarkSetView;
-using FaceTools::Vis::SphereView;
 using FaceTools::ModelViewer;
 using FaceTools::FaceSide;
 using FaceTools::Landmark::LandmarkSet;
-using ViewPair = std::pair<int, SphereView*>;
 using FaceTools::Vec3f;
 using LMAN = FaceTools::Landmark::LandmarksManager;
 
@@ -39,108 +37,93 @@ const Vec3f MOVG_COL( 1.0f, 0.0f, 0.7f);
 }   // end namespace
 
 
-LandmarkSetView::LandmarkSetView() : _lmrad(1.0), _viewer(nullptr), _visible(false) {}
+LandmarkSetView::LandmarkSetView()
+    : _lmrad(1.0), _viewer(nullptr), _visible(false), _glyphs( 1.0, 13/*resolution*/, true/*fixed scale*/)
+{
+    _glyphs.setColour( CURR_COL[0], CURR_COL[1], CURR_COL[2]);
+    _glyphs.setOpacity( ALPHA);
+}   // end ctor
 
 
 LandmarkSetView::~LandmarkSetView()
 {
     setVisible( false, nullptr);
-    for ( auto& p : _lviews) delete p.second;
-    for ( auto& p : _mviews) delete p.second;
-    for ( auto& p : _rviews) delete p.second;
 }   // end dtor
 
 
-void LandmarkSetView::set( int lm, FaceSide lat, const Vec3f& pos)
+LandmarkSetView::InstanceMap &LandmarkSetView::_instances( FaceSide lat)
 {
-    SphereMap *views = nullptr;
-    PropMap *props = nullptr;
+    InstanceMap *insts = &_minsts;
     if ( lat == LEFT)
-    {
-        views = &_lviews;
-        props = &_lprops;
-    }   // end if
+        insts = &_linsts;
     else if ( lat == RIGHT)
-    {
-        views = &_rviews;
-        props = &_rprops;
-    }   // end else if
-    else
-    {
-        views = &_mviews;
-        props = &_mprops;
-    }   // end else
+        insts = &_rinsts;
+    return *insts;
+}   // end _instances
+
 
-    if ( views->count(lm) == 0)
+int LandmarkSetView::_instance( int lm, FaceSide lat) const
+{
+    int i = -1;
+    if ( (lat & LEFT) && _linsts.count(lm) > 0)
+        i = _linsts.at(lm);
+    else if ( (lat & MID) && _minsts.count(lm) > 0)
+        i = _minsts.at(lm);
+    else if ( (lat & RIGHT) && _rinsts.count(lm) > 0)
+        i = _rinsts.at(lm);
+    return i;
+}   // end _instance
+
+
+void LandmarkSetView::set( int lm, FaceSide lat, const Vec3f& pos)
+{
+    InstanceMap &insts = _instances( lat);
+    if ( insts.count(lm) == 0)
     {
-        SphereView *sv = new SphereView( pos, _lmrad, true/*pickable*/, true/*fixed scale*/);
-        sv->setColour( CURR_COL[0], CURR_COL[1], CURR_COL[2], ALPHA);
-        sv->setResolution(13);
         QString lmstr = LMAN::makeLandmarkString( lm, lat);
         // Put Inferius/Superius on line beneath to make it easier to see
         lmstr.replace(" Inferius", "\nInferius");
         lmstr.replace(" Superius", "\nSuperius");
-        sv->setCaption( lmstr.toStdString());
-        (*props)[sv->prop()] = lm;
-        (*views)[lm] = sv;
+        const int i = _glyphs.add( pos, lmstr.toStdString());
+        _glyphs.setColour( i, CURR_COL[0], CURR_COL[1], CURR_COL[2]);
+        _glyphs.setInstanceVisible( i, LMAN::landmark(lm)->isVisible());
+        insts[lm] = i;
+        _lmks[i] = std::pair<int, FaceSide>( lm, lat == LEFT || lat == RIGHT ? lat : MID);
     }   // end if
-    views->at(lm)->setCentre( pos);
+    else
+        _glyphs.setCentre( insts.at(lm), pos);
 }   // end set
 
 
 void LandmarkSetView::setSelectedColour( bool isSelected)
 {
-    double r = BASE_COL[0];
-    double g = BASE_COL[1];
-    double b = BASE_COL[2];
-    const double a = ALPHA;
-    if ( isSelected)
-    {
-        r = CURR_COL[0];
-        g = CURR_COL[1];
-        b = CURR_COL[2];
-    }   // end if
-
-    for ( auto& p : _lviews) p.second->setColour( r, g, b, a);
-    for ( auto& p : _mviews) p.second->setColour( r, g, b, a);
-    for ( auto& p : _rviews) p.second->setColour( r, g, b, a);
+    const Vec3f &col = isSelected ? CURR_COL : BASE_COL;
+    _glyphs.setColour( col[0], col[1], col[2]);
+    _glyphs.setOpacity( ALPHA);
 
     if (_viewer)
     {
         const QColor bg = _viewer->backgroundColour();
         const QColor fg = chooseContrasting( bg);
-        for ( auto& p : _lviews) p.second->setCaptionColour( fg, bg);
-        for ( auto& p : _mviews) p.second->setCaptionColour( fg, bg);
-        for ( auto& p : _rviews) p.second->setCaptionColour( fg, bg);
+        _glyphs.setCaptionColour( fg, bg);
     }   // end if
 }   // end setSelectedColour
 
 
-void LandmarkSetView::setPickable( bool v)
-{
-    for ( auto& p : _lviews) p.second->setPickable( v);
-    for ( auto& p : _mviews) p.second->setPickable( v);
-    for ( auto& p : _rviews) p.second->setPickable( v);
-}   // end setPickable
+void LandmarkSetView::setPickable( bool v) { _glyphs.setPickable( v);}
 
 
 void LandmarkSetView::setVisible( bool enable, ModelViewer* viewer)
 {
-    if ( _viewer)
-    {
-        for ( auto& p : _lviews) p.second->setVisible( false, _viewer);
-        for ( auto& p : _mviews) p.second->setVisible( false, _viewer);
-        for ( auto& p : _rviews) p.second->setVisible( false, _viewer);
-    }   // end if
-
+    _glyphs.setVisible( false, _viewer);
     _viewer = viewer;
     _visible = false;
 
     if ( _viewer && enable)
     {
-        for ( auto& p : _lviews) p.second->setVisible( LMAN::landmark(p.first)->isVisible(), _viewer);
-        for ( auto& p : _mviews) p.second->setVisible( LMAN::landmark(p.first)->isVisible(), _viewer);
-        for ( auto& p : _rviews) p.second->setVisible( LMAN::landmark(p.first)->isVisible(), _viewer);
+        for ( const auto& p : _lmks)
+            _glyphs.setInstanceVisible( p.first, LMAN::landmark(p.second.first)->isVisible());
+        _glyphs.setVisible( true, _viewer);
         _visible = true;
     }   // end if
 }   // end setVisible
@@ -149,17 +132,17 @@ void LandmarkSetView::setVisible( bool enable, ModelViewer* viewer)
 void LandmarkSetView::showLandmark( bool enable, int lm)
 {
     enable = enable && _visible && LMAN::landmark(lm)->isVisible();
-    if ( _lviews.count(lm) > 0)
+    if ( _linsts.count(lm) > 0)
     {
-        assert( _rviews.count(lm) > 0);
+        assert( _rinsts.count(lm) > 0);
         assert( _viewer);
-        _lviews.at(lm)->setVisible( enable, _viewer);
-        _rviews.at(lm)->setVisible( enable, _viewer);
+        _glyphs.setInstanceVisible( _linsts.at(lm), enable);
+        _glyphs.setInstanceVisible( _rinsts.at(lm), enable);
     }   // end if
-    else if ( _mviews.count(lm) > 0)
+    else if ( _minsts.count(lm) > 0)
     {
         assert( _viewer);
-        _mviews.at(lm)->setVisible( enable, _viewer);
+        _glyphs.setInstanceVisible( _minsts.at(lm), enable);
     }   // end else if
 }   // end showLandmark
 
@@ -167,28 +150,17 @@ void LandmarkSetView::showLandmark( bool enable, int lm)
 void LandmarkSetView::setLabelVisible( bool enable, int lm, FaceSide lat)
 {
     enable = enable && LMAN::landmark(lm)->isVisible();
-    if ( (lat & LEFT) && _lviews.count(lm) > 0)
-        _lviews.at(lm)->showCaption( enable);
-    else if ( (lat & MID) && _mviews.count(lm) > 0)
-        _mviews.at(lm)->showCaption( enable);
-    else if ( (lat & RIGHT) && _rviews.count(lm) > 0)
-        _rviews.at(lm)->showCaption( enable);
+    const int i = _instance( lm, lat);
+    if ( i >= 0)
+        _glyphs.showCaption( i, enable);
 }   // end setLabelVisible
 
 
 void LandmarkSetView::_setLandmarkColour( const Vec3f &col, int lm, FaceSide lat)
 {
-    const double r = col[0];
-    const double g = col[1];
-    const double b = col[2];
-    const double a = ALPHA;
-
-    if ( (lat & LEFT) && _lviews.count(lm) > 0)
-        _lviews.at(lm)->setColour( r, g, b, a);
-    else if ( (lat & MID) && _mviews.count(lm) > 0)
-        _mviews.at(lm)->setColour( r, g, b, a);
-    else if ( (lat & RIGHT) && _rviews.count(lm) > 0)
-        _rviews.at(lm)->setColour( r, g, b, a);
+    const int i = _instance( lm, lat);
+    if ( i >= 0)
+        _glyphs.setColour( i, col[0], col[1], col[2]);
 }   // end _setLandmarkColour
 
 
@@ -201,55 +173,46 @@ void LandmarkSetView::setHighlighted( bool enable, int lm, FaceSide lat)
 }   // end setHighlighted
 
 
-void LandmarkSetView::pokeTransform( const vtkMatrix4x4* vd)
-{
-    for ( auto& p : _lviews) p.second->pokeTransform( vd);
-    for ( auto& p : _mviews) p.second->pokeTransform( vd);
-    for ( auto& p : _rviews) p.second->pokeTransform( vd);
-}   // end pokeTransform
+void LandmarkSetView::pokeTransform( const vtkMatrix4x4* vd) { _glyphs.pokeTransform( vd);}
+
+
+bool LandmarkSetView::belongs( const vtkProp *prop) const { return _glyphs.belongs( prop);}
 
 
 int LandmarkSetView::landmarkId( const vtkProp* prop, FaceSide& lat) const
 {
-    if ( _lprops.count(prop) > 0)
-    {
-        lat = LEFT;
-        return _lprops.at(prop);
-    }   // end if
-
-    if ( _mprops.count(prop) > 0)
-    {
-        lat = MID;
-        return _mprops.at(prop);
-    }   // end if
+    return _viewer ? landmarkId( prop, _viewer->mouseCoords(), lat) : -1;
+}   // end landmarkId
 
-    if ( _rprops.count(prop) > 0)
-    {
-        lat = RIGHT;
-        return _rprops.at(prop);
-    }   // end if
 
-    return -1;
+int LandmarkSetView::landmarkId( const vtkProp* prop, const QPoint &p, FaceSide& lat) const
+{
+    if ( !_viewer || !_glyphs.belongs( prop))
+        return -1;
+    const int i = _glyphs.instance( _viewer, p);
+    if ( i < 0)
+        return -1;
+    lat = _lmks.at(i).second;
+    return _lmks.at(i).first;
 }   // end landmarkId
 
 
 void LandmarkSetView::remove( int lm)
 {
     assert(lm >= 0);
-    _remove( lm, _lviews, _lprops);
-    _remove( lm, _mviews, _mprops);
-    _remove( lm, _rviews, _rprops);
+    _remove( lm, _linsts);
+    _remove( lm, _minsts);
+    _remove( lm, _rinsts);
 }   // end remove
 
 
-void LandmarkSetView::_remove( int lm, SphereMap& views, PropMap& props)
+void LandmarkSetView::_remove( int lm, InstanceMap& insts)
 {
-    if ( views.count(lm) > 0)
+    if ( insts.count(lm) > 0)
     {
-        showLandmark( false, lm);
-        SphereView *sv = views.at(lm);
-        views.erase(lm);
-        props.erase(sv->prop());
-        delete sv;
+        const int i = insts.at(lm);
+        insts.erase(lm);
+        _lmks.erase(i);
+        _glyphs.remove(i);
     }   // end if
 }   // end _remove
@@ -127,15 +127,15 @@ int LandmarksVisualisation::landmarkId( const FV* fv, const vtkProp* prop, FaceS
 }   // end landmarkId
 
 
+int LandmarksVisualisation::landmarkId( const FV* fv, const vtkProp* prop, const QPoint &p, FaceSide &lat) const
+{
+    return _hasView(fv) ? _views.at(fv).landmarkId( prop, p, lat) : -1;
+}   // end landmarkId
+
+
 bool LandmarksVisualisation::belongs( const vtkProp* p, const FV* fv) const
 {
-    bool b = false;
-    if ( _hasView(fv))
-    {
-        FaceSide ignored;
-        b = _views.at(fv).landmarkId(p, ignored) >= 0;
-    }   // end if
-    return b;
+    return _hasView(fv) && _views.at(fv).belongs(p);
 }   // end belongs
 
 
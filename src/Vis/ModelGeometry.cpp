@@ -0,0 +1,381 @@
+/************************************************************************
+ * Copyright (C) 2022 SIS Research Ltd & Richard Palmer
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ ************************************************************************/
+
+#include <Vis/ModelGeometry.h>
+#include <FaceModel.h>
+#include <r3dvis/VtkActorCreator.h>
+#include <r3dvis/VtkTools.h>
+#include <vtkPolyDataMapper.h>
+#include <vtkProperty.h>
+#include <vtkImageData.h>
+#include <vtkPointData.h>
+#include <vtkCellData.h>
+#include <vtkDecimatePro.h>
+#include <vtkIdTypeArray.h>
+#include <vtkCellCenters.h>
+#include <vtkStaticCellLocator.h>
+#include <vtkGenericCell.h>
+#include <vtkIdList.h>
+#include <vtkNew.h>
+#include <FaceTools.h>
+#include <WorkerPool.h>
+#include <QCoreApplication>
+#include <QTimer>
+#include <QMutex>
+#include <unordered_map>
+#include <algorithm>
+#include <cassert>
+using FaceTools::Vis::ModelGeometry;
+using FaceTools::Vis::FV;
+using FaceTools::FM;
+using FaceTools::Mat4f;
+using FaceTools::WorkerPool;
+
+namespace {
+
+std::unordered_map<const FM*, std::weak_ptr<const ModelGeometry> > _geoms;
+
+
+// The model as referenced by workers. Workers only use the model while holding the lock
+// and the model is set null (under the lock) when it's forgotten before being deleted.
+struct ModelRef
+{
+    explicit ModelRef( const FM *m) : fm(m) {}
+    QMutex lock;
+    const FM *fm;
+};  // end struct
+
+std::unordered_map<const FM*, std::shared_ptr<ModelRef> > _refs;
+
+
+struct Pending
+{
+    std::shared_ptr<ModelRef> ref;
+    r3d::Mesh::Ptr mesh;
+    Mat4f tmat;
+    ModelGeometry::Ptr geom;
+    std::unordered_map<const FV*, std::function<void( ModelGeometry::Ptr)> > waiting;
+};  // end struct
+
+std::unordered_map<const FM*, std::shared_ptr<Pending> > _pending;
+
+
+// Returns true iff the prepared geometry was given to the waiting views.
+bool _finish( const FM *fm, const std::shared_ptr<Pending> &pending)
+{
+    const auto it = _pending.find(fm);
+    if ( it == _pending.end() || it->second != pending) // Superseded by a newer mesh
+        return false;
+    _pending.erase(it);
+
+    // If no views are waiting, the model may no longer exist
+    if ( pending->waiting.empty())
+        return false;
+
+    _geoms[fm] = pending->geom;
+    for ( const auto &p : pending->waiting)
+        p.second( pending->geom);
+    return true;
+}   // end _finish
+
+
+// Set the arrays of out to be the arrays of in sampled at the given ids.
+void _resample( vtkDataSetAttributes *in, vtkIdList *ids, vtkDataSetAttributes *out)
+{
+    for ( int i = 0; i < in->GetNumberOfArrays(); ++i)
+    {
+        vtkAbstractArray *a = in->GetAbstractArray(i);
+        vtkSmartPointer<vtkAbstractArray> b = vtkSmartPointer<vtkAbstractArray>::Take( a->NewInstance());
+        b->SetName( a->GetName());
+        b->SetNumberOfComponents( a->GetNumberOfComponents());
+        b->SetNumberOfTuples( ids->GetNumberOfIds());
+        a->GetTuples( ids, b);
+        const int j = out->AddArray( b);
+        const int attrib = in->IsArrayAnAttribute(i);
+        if ( attrib >= 0)
+            out->SetActiveAttribute( j, attrib);
+    }   // end for
+}   // end _resample
+
+}   // end namespace
+
+
+struct ModelGeometry::Proxy
+{
+    vtkSmartPointer<vtkPolyData> pdata; // Decimated points and polygons
+    vtkSmartPointer<vtkIdList> pids;    // Full geometry point each proxy point was kept from
+    vtkSmartPointer<vtkIdList> cids;    // Nearest full geometry cell to each proxy cell centre
+};  // end struct
+
+
+int ModelGeometry::s_proxyTriangles( 50000);
+void ModelGeometry::setProxyTriangles( int n) { s_proxyTriangles = std::max( 0, n);}
+int ModelGeometry::proxyTriangles() { return s_proxyTriangles;}
+
+
+ModelGeometry::Ptr ModelGeometry::_held( const FM *fm, const r3d::Mesh::Ptr &mesh, const Mat4f &tmat)
+{
+    Ptr geom = _geoms.count(fm) > 0 ? _geoms.at(fm).lock() : nullptr;
+    if ( geom && (geom->_mesh.lock() != mesh || !geom->_tmat.isApprox( tmat)))
+        geom = nullptr;
+    return geom;
+}   // end _held
+
+
+ModelGeometry::Ptr ModelGeometry::get( FM *fm)
+{
+    assert(fm);
+    r3d::Mesh::Ptr mesh = fm->meshPtr();
+    const Mat4f tmat = mesh->transformMatrix();
+    Ptr geom = _held( fm, mesh, tmat);
+    if ( !geom)
+    {
+        // Forget the geometry of models no longer having any views
+        for ( auto it = _geoms.begin(); it != _geoms.end();)
+            it = it->second.expired() ? _geoms.erase(it) : std::next(it);
+        geom = Ptr( new ModelGeometry( mesh, tmat, *mesh), []( const ModelGeometry *x){ delete x;});
+        _geoms[fm] = geom;
+        _prepareProxy( geom);
+    }   // end if
+    return geom;
+}   // end get
+
+
+void ModelGeometry::prepare( FM *fm, const FV *fv, const std::function<void( Ptr)> &fn)
+{
+    assert(fm);
+    r3d::Mesh::Ptr mesh = fm->meshPtr();
+    const Mat4f tmat = mesh->transformMatrix();
+    Ptr geom = _held( fm, mesh, tmat);
+    if ( geom)
+    {
+        fn( geom);
+        return;
+    }   // end if
+
+    std::shared_ptr<Pending> &pending = _pending[fm];
+    if ( !pending || pending->mesh != mesh || !pending->tmat.isApprox( tmat))
+    {
+        std::shared_ptr<ModelRef> &ref = _refs[fm];
+        if ( !ref)
+            ref = std::make_shared<ModelRef>( fm);
+
+        std::shared_ptr<Pending> npending = std::make_shared<Pending>();
+        npending->ref = ref;
+        npending->mesh = mesh;
+        npending->tmat = tmat;
+        if ( pending)
+            npending->waiting = pending->waiting;
+        pending = npending;
+
+        WorkerPool::run( [npending]( const WorkerPool::Token&)
+        {
+            // Transforming the model changes its mesh in place so convert from a copy taken
+            // under the model's read lock. Nothing is copied if the model has been forgotten.
+            r3d::Mesh::Ptr cmesh;
+            ModelRef &ref = *npending->ref;
+            ref.lock.lock();
+            if ( ref.fm)
+            {
+                ref.fm->lockForRead();
+                cmesh = npending->mesh->deepCopy();
+                ref.fm->unlock();
+            }   // end if
+            ref.lock.unlock();
+
+            if ( cmesh)
+                npending->geom = Ptr( new ModelGeometry( npending->mesh, npending->tmat, *cmesh), []( const ModelGeometry *x){ delete x;});
+
+            // Context object lives in the GUI thread so the lambda is called on the GUI thread
+            QTimer::singleShot( 0, QCoreApplication::instance(), [npending]()
+            {
+                const FM *fm = npending->ref->fm;
+                if ( fm && npending->geom && _finish( fm, npending))
+                    _prepareProxy( npending->geom);
+            });
+        }, WorkerPool::USER);
+    }   // end if
+
+    pending->waiting[fv] = fn;
+}   // end prepare
+
+
+void ModelGeometry::cancel( const FV *fv)
+{
+    for ( auto &p : _pending)
+        p.second->waiting.erase(fv);
+}   // end cancel
+
+
+void ModelGeometry::purge( const FM *fm) { _geoms.erase(fm);}
+
+
+void ModelGeometry::forget( const FM *fm)
+{
+    _geoms.erase(fm);
+    _pending.erase(fm);
+    const auto it = _refs.find(fm);
+    if ( it != _refs.end())
+    {
+        it->second->lock.lock();    // Wait for any worker copying the mesh
+        it->second->fm = nullptr;
+        it->second->lock.unlock();
+        _refs.erase(it);
+    }   // end if
+}   // end forget
+
+
+void ModelGeometry::_prepareProxy( const Ptr &geom)
+{
+    const int ntris = s_proxyTriangles;
+    if ( ntris <= 0 || geom->_pdata->GetNumberOfPolys() < 2*ntris)
+        return;
+
+    // Give the worker just the points and polygons since the views' arrays may change meanwhile
+    vtkSmartPointer<vtkPolyData> src = vtkSmartPointer<vtkPolyData>::New();
+    src->CopyStructure( geom->_pdata);
+
+    std::weak_ptr<const ModelGeometry> wgeom = geom;    // Don't keep the geometry alive just for its proxy
+    WorkerPool::run( [src, ntris, wgeom]( const WorkerPool::Token&)
+    {
+        std::shared_ptr<const Proxy> proxy = _createProxy( src, ntris);
+        QTimer::singleShot( 0, QCoreApplication::instance(), [wgeom, proxy]()
+        {
+            Ptr g = wgeom.lock();
+            if ( g)
+                g->_proxy = proxy;
+        });
+    }, WorkerPool::BACKGROUND);
+}   // end _prepareProxy
+
+
+std::shared_ptr<const ModelGeometry::Proxy> ModelGeometry::_createProxy( vtkPolyData *src, int ntris)
+{
+    // Tag the points with their ids which the decimator passes through to the points it keeps
+    const vtkIdType nsp = src->GetNumberOfPoints();
+    vtkNew<vtkIdTypeArray> sids;
+    sids->SetName( "SourceIds");
+    sids->SetNumberOfTuples( nsp);
+    for ( vtkIdType i = 0; i < nsp; ++i)
+        sids->SetValue( i, i);
+    vtkNew<vtkPolyData> tsrc;
+    tsrc->CopyStructure( src);
+    tsrc->GetPointData()->AddArray( sids);
+
+    // Points duplicated along texture seams aren't merged and boundary vertices aren't deleted
+    // so the seams remain split and the proxy keeps the texture coordinates either side of them.
+    vtkNew<vtkDecimatePro> decimator;
+    decimator->SetInputData( tsrc);
+    decimator->SetTargetReduction( 1.0 - double(ntris) / src->GetNumberOfPolys());
+    decimator->PreserveTopologyOn();
+    decimator->SplittingOff();
+    decimator->BoundaryVertexDeletionOff();
+    decimator->Update();
+
+    std::shared_ptr<Proxy> proxy = std::make_shared<Proxy>();
+    proxy->pdata = vtkSmartPointer<vtkPolyData>::New();
+    proxy->pdata->CopyStructure( decimator->GetOutput());
+
+    const vtkIdType np = proxy->pdata->GetNumberOfPoints();
+    vtkIdTypeArray *pids = vtkIdTypeArray::SafeDownCast( decimator->GetOutput()->GetPointData()->GetArray( "SourceIds"));
+    assert( pids && pids->GetNumberOfTuples() == np);
+    proxy->pids = vtkSmartPointer<vtkIdList>::New();
+    proxy->pids->SetNumberOfIds( np);
+    for ( vtkIdType i = 0; i < np; ++i)
+        proxy->pids->SetId( i, pids->GetValue(i));
+
+    vtkNew<vtkCellCenters> centres;
+    centres->SetInputData( proxy->pdata);
+    centres->Update();
+    vtkPolyData *cpdata = centres->GetOutput();
+    const vtkIdType nc = cpdata->GetNumberOfPoints();
+    proxy->cids = vtkSmartPointer<vtkIdList>::New();
+    proxy->cids->SetNumberOfIds( nc);
+    vtkNew<vtkStaticCellLocator> clocator;
+    clocator->SetDataSet( src);
+    clocator->BuildLocator();
+    parallelFor( size_t(nc), [&]( size_t i0, size_t i1)
+    {
+        vtkNew<vtkGenericCell> cell;    // Per thread
+        double x[3], cp[3], d2;
+        vtkIdType cid;
+        int subId;
+        for ( size_t i = i0; i < i1; ++i)
+        {
+            cpdata->GetPoint( vtkIdType(i), x);
+            clocator->FindClosestPoint( x, cp, cell, cid, subId, d2);
+            proxy->cids->SetId( vtkIdType(i), cid);
+        }   // end for
+    }, 1024);
+
+    return proxy;
+}   // end _createProxy
+
+
+vtkSmartPointer<vtkPolyData> ModelGeometry::createProxy( vtkPolyData *pd) const
+{
+    if ( !_proxy)
+        return nullptr;
+    vtkSmartPointer<vtkPolyData> pdata = vtkSmartPointer<vtkPolyData>::New();
+    pdata->CopyStructure( _proxy->pdata);
+    _resample( pd->GetPointData(), _proxy->pids, pdata->GetPointData());
+    _resample( pd->GetCellData(), _proxy->cids, pdata->GetCellData());
+    return pdata;
+}   // end createProxy
+
+
+// The geometry is converted from cmesh which is either mesh or a copy of it.
+ModelGeometry::ModelGeometry( r3d::Mesh::Ptr mesh, const Mat4f &tmat, const r3d::Mesh &cmesh) : _mesh( mesh), _tmat( tmat)
+{
+    _proto = r3dvis::VtkActorCreator::generateActor( cmesh);
+    _pdata = r3dvis::getPolyData( _proto);
+}   // end ctor
+
+
+vtkSmartPointer<vtkActor> ModelGeometry::createActor() const
+{
+    // Point and cell data are shallow copied so adding arrays or setting
+    // active attributes on the new actor's data doesn't affect other actors.
+    vtkNew<vtkPolyData> pdata;
+    pdata->ShallowCopy( _pdata);
+
+    vtkNew<vtkPolyDataMapper> mapper;
+    mapper->ShallowCopy( _proto->GetMapper());
+    mapper->SetInputData( pdata);
+
+    vtkSmartPointer<vtkActor> actor = vtkSmartPointer<vtkActor>::New();
+    actor->SetMapper( mapper);
+    actor->GetProperty()->DeepCopy( _proto->GetProperty());
+
+    actor->PokeMatrix( r3dvis::toVTK( _tmat));
+
+    // Textures are per actor since a texture object is bound to a single render window's
+    // context, but the texture image itself is shared.
+    vtkTexture *ptex = _proto->GetTexture();
+    if ( ptex)
+    {
+        vtkNew<vtkTexture> tex;
+        tex->SetInputData( ptex->GetInput());
+        tex->SetInterpolate( ptex->GetInterpolate());
+        tex->SetRepeat( ptex->GetRepeat());
+        tex->SetEdgeClamp( ptex->GetEdgeClamp());
+        tex->SetMipmap( ptex->GetMipmap());
+        actor->SetTexture( tex);
+    }   // end if
+
+    return actor;
+}   // end createActor
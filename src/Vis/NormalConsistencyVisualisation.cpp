@@ -0,0 +1,48 @@
+/************************************************************************
+ * Copyright (C) 2021 SIS Research Ltd & Richard Palmer
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ ************************************************************************/
+
+#include <Vis/NormalConsistencyVisualisation.h>
+#include <NormalConsistency.h>
+#include <FaceModel.h>
+using FaceTools::Vis::NormalConsistencyVisualisation;
+using FaceTools::NormalConsistency;
+using FaceTools::Vis::FV;
+using FaceTools::FM;
+
+
+NormalConsistencyVisualisation::NormalConsistencyVisualisation()
+    : ColourVisualisation( "Normal Consistency", NormalConsistency::CONSISTENT, NormalConsistency::TWISTED, 1.0f)
+{
+    setNumColours(3);
+    setMinColour( Qt::white);
+    setMaxColour( Qt::red);
+    rebuildColourMapping();
+}   // end ctor
+
+
+void NormalConsistencyVisualisation::refresh( FV *fv)
+{
+    FM::RPtr fm = fv->rdata();
+    fv->addCellsArray( NormalConsistency( fm->mesh(), fm->manifolds()).cellsArray());
+}   // end refresh
+
+
+void NormalConsistencyVisualisation::show( FV *fv)
+{
+    refresh( fv);
+    fv->setActiveCellScalars( NormalConsistency::ARRAY_NAME);
+}   // end show
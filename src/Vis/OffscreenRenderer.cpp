@@ -0,0 +1,185 @@
+/************************************************************************
+ * Copyright (C) 2021 SIS Research Ltd & Richard Palmer
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ ************************************************************************/
+
+#include <Vis/OffscreenRenderer.h>
+#include <Vis/FaceView.h>
+#include <r3dvis/OffscreenMeshViewer.h>
+#include <r3dvis/VtkTools.h>
+#include <QTools/QImageTools.h>
+#include <vtkPointData.h>
+#include <vtkProperty.h>
+#include <QWaitCondition>
+#include <QThread>
+#include <QMutex>
+#include <unordered_map>
+#include <future>
+#include <deque>
+using FaceTools::Vis::OffscreenRenderer;
+using Request = OffscreenRenderer::Request;
+
+
+namespace {
+
+struct Job
+{
+    const Request *request;
+    std::promise<QImage> image;
+};  // end struct
+
+
+class RenderThread : public QThread
+{
+public:
+    RenderThread() : _stop(false) { start();}
+
+    ~RenderThread() override
+    {
+        _mutex.lock();
+        _stop = true;
+        _cond.wakeOne();
+        _mutex.unlock();
+        wait();
+    }   // end dtor
+
+    void submit( std::vector<Job> &jobs)
+    {
+        _mutex.lock();
+        for ( Job &job : jobs)
+            _queue.push_back( &job);
+        _cond.wakeOne();
+        _mutex.unlock();
+    }   // end submit
+
+protected:
+    void run() override
+    {
+        for (;;)
+        {
+            _mutex.lock();
+            while ( _queue.empty() && !_stop)
+                _cond.wait( &_mutex);
+            std::deque<Job*> batch;
+            batch.swap( _queue);
+            const bool stopping = _stop;
+            _mutex.unlock();
+
+            // Failures are passed to the caller so it isn't left waiting forever
+            for ( Job *job : batch)
+            {
+                try
+                {
+                    job->image.set_value( _render( *job->request));
+                }   // end try
+                catch ( ...)
+                {
+                    job->image.set_exception( std::current_exception());
+                }   // end catch
+            }   // end for
+
+            if ( stopping)
+                break;
+        }   // end for
+        _viewers.clear();   // Destroy the viewers on the thread that created them
+    }   // end run
+
+private:
+    static const size_t MAX_VIEWERS = 4;
+    QMutex _mutex;
+    QWaitCondition _cond;
+    std::deque<Job*> _queue;
+    bool _stop;
+    // Only accessed from the render thread
+    std::unordered_map<qint64, std::unique_ptr<r3dvis::OffscreenMeshViewer> > _viewers;
+
+    r3dvis::OffscreenMeshViewer &_viewer( const QSize &sz)
+    {
+        const qint64 key = (qint64(sz.width()) << 32) | qint64(sz.height());
+        std::unique_ptr<r3dvis::OffscreenMeshViewer> &omv = _viewers[key];
+        if ( !omv)
+        {
+            // Images of many different sizes are rare (thumbnails are all one size)
+            if ( _viewers.size() > MAX_VIEWERS)
+            {
+                _viewers.clear();
+                return _viewer( sz);
+            }   // end if
+            omv.reset( new r3dvis::OffscreenMeshViewer( cv::Size( sz.width(), sz.height())));
+            omv->setBackgroundColour( 1.0f, 1.0f, 1.0f);
+        }   // end if
+        return *omv;
+    }   // end _viewer
+
+    QImage _render( const Request &req)
+    {
+        r3dvis::OffscreenMeshViewer &omv = _viewer( req.size);
+        vtkActor *actor = omv.setModel( *req.mesh);  // Replaces the previous actor
+        // Add normals for smooth lighting interpolation
+        if ( req.normals)
+            r3dvis::getPolyData( actor)->GetPointData()->SetNormals( const_cast<vtkFloatArray*>( req.normals));
+
+        vtkProperty *prop = actor->GetProperty();
+        prop->SetInterpolationToPhong();
+        if ( !req.mesh->hasMaterials())
+        {
+            static const QColor COL = FaceTools::Vis::FV::BASECOL;
+            prop->SetColor( COL.redF(), COL.greenF(), COL.blueF());
+        }   // end if
+
+        omv.setCamera( req.camera);
+        return QTools::copyOpenCV2QImage( omv.snapshot());
+    }   // end _render
+};  // end class
+
+
+RenderThread &renderThread()
+{
+    static RenderThread rthread;
+    return rthread;
+}   // end renderThread
+
+}   // end namespace
+
+
+QImage OffscreenRenderer::render( const Request &req)
+{
+    return render( std::vector<Request>( 1, req)).front();
+}   // end render
+
+
+std::vector<QImage> OffscreenRenderer::render( const std::vector<Request> &reqs)
+{
+    std::vector<Job> jobs( reqs.size());
+    for ( size_t i = 0; i < reqs.size(); ++i)
+        jobs[i].request = &reqs[i];
+    std::vector<std::future<QImage> > images;
+    images.reserve( jobs.size());
+    for ( Job &job : jobs)
+        images.push_back( job.image.get_future());
+
+    renderThread().submit( jobs);
+
+    // The render thread references the jobs until all are done so wait for every
+    // image before any failure is rethrown.
+    for ( std::future<QImage> &img : images)
+        img.wait();
+
+    std::vector<QImage> imgs;
+    imgs.reserve( images.size());
+    for ( std::future<QImage> &img : images)
+        imgs.push_back( img.get());
+    return imgs;
+}   // end render
@@ -139,7 +139,8 @@ void PathView::update( const Path &path)
         _removeLineProps();
 
     // Create the surface path actor
-    _sprop = r3dvis::VtkActorCreator::generateLineActor( path.pathVertices(), false);
+    const std::vector<Vec3f> &pvtxs = path.pathVertices();
+    _sprop = r3dvis::VtkActorCreator::generateLineActor( std::list<Vec3f>( pvtxs.begin(), pvtxs.end()), false);
 
     // Create the direct line between the handles
     const std::list<Vec3f> hends = { h0, h1};
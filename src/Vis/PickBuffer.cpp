@@ -0,0 +1,234 @@
+/************************************************************************
+ * Copyright (C) 2021 SIS Research Ltd & Richard Palmer
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ ************************************************************************/
+
+#include <Vis/PickBuffer.h>
+#include <FaceTools.h>
+#include <r3dvis/VtkTools.h>
+#include <vtkRenderer.h>
+#include <vtkCamera.h>
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cassert>
+using FaceTools::Vis::PickBuffer;
+using FaceTools::Vec2f;
+using FaceTools::Vec3f;
+using FaceTools::Vec4f;
+using FaceTools::Mat4f;
+
+namespace {
+
+// Twice the signed area of the screen space triangle a,b,p.
+float edge( const Vec3f &a, const Vec3f &b, float px, float py)
+{
+    return (b[0] - a[0]) * (py - a[1]) - (b[1] - a[1]) * (px - a[0]);
+}   // end edge
+
+}   // end namespace
+
+
+PickBuffer::Ptr PickBuffer::create( std::shared_ptr<const r3d::Mesh> mesh, const Mat4f &ndc, const Mat4f &toWorld,
+                                    int w, int h, float dpr)
+{
+    assert( mesh);
+    assert( dpr > 0.0f);
+    PickBuffer *pb = new PickBuffer( mesh, ndc, toWorld, std::max( w, 0), std::max( h, 0), dpr);
+    pb->_rasterise();
+    return Ptr( pb, []( const PickBuffer *x){ delete x;});
+}   // end create
+
+
+PickBuffer::PickBuffer( std::shared_ptr<const r3d::Mesh> mesh, const Mat4f &ndc, const Mat4f &toWorld, int w, int h, float dpr)
+    : _mesh(mesh), _ndc(ndc), _indc(ndc.inverse()), _toWorld(toWorld), _w(w), _h(h), _dpr(dpr) {}
+
+
+Mat4f PickBuffer::deviceMatrix( vtkRenderer *ren)
+{
+    vtkCamera *cam = ren->GetActiveCamera();
+    return r3dvis::toEigen( cam->GetCompositeProjectionTransformMatrix( ren->GetTiledAspectRatio(), -1, 1));
+}   // end deviceMatrix
+
+
+bool PickBuffer::isFor( const r3d::Mesh *mesh, const Mat4f &ndc, int w, int h, float dpr) const
+{
+    return mesh == _mesh.get() && w == _w && h == _h && dpr == _dpr && ndc == _ndc;
+}   // end isFor
+
+
+void PickBuffer::_rasterise()
+{
+    const r3d::Mesh &mesh = *_mesh;
+    assert( mesh.hasSequentialIds());
+    _fids.assign( size_t(_w) * size_t(_h), -1);
+
+    // Vertices to screen space (pixels from top left) keeping NDC depth. Vertices
+    // behind the camera are flagged so that their faces can be skipped.
+    const size_t nv = mesh.numVtxs();
+    std::vector<Vec3f> svs( nv);
+    std::vector<char> infront( nv);
+    FaceTools::parallelFor( nv, [&]( size_t i0, size_t i1)
+    {
+        for ( size_t i = i0; i < i1; ++i)
+        {
+            const Vec4f c = _ndc * mesh.uvtx(int(i)).homogeneous();
+            infront[i] = c[3] > 0;
+            if ( infront[i])
+                svs[i] = Vec3f( (c[0]/c[3] + 1) * 0.5f * _w, (1 - c[1]/c[3]) * 0.5f * _h, c[2]/c[3]);
+        }   // end for
+    }, 4096);
+
+    // Each block of rows keeps its own depth buffer and tests every face against its rows
+    // so no synchronisation is needed. Pixels are sampled at their centres.
+    const int nf = int(mesh.numFaces());
+    FaceTools::parallelFor( size_t(_h), [&]( size_t r0, size_t r1)
+    {
+        const int y0 = int(r0);
+        const int y1 = int(r1) - 1;
+        std::vector<float> depth( (r1 - r0) * size_t(_w), FLT_MAX);
+
+        for ( int fid = 0; fid < nf; ++fid)
+        {
+            const int *vidxs = mesh.fvidxs(fid);
+            if ( !infront[vidxs[0]] || !infront[vidxs[1]] || !infront[vidxs[2]])
+                continue;
+
+            const Vec3f &a = svs[vidxs[0]];
+            const Vec3f &b = svs[vidxs[1]];
+            const Vec3f &c = svs[vidxs[2]];
+            const int ymin = std::max( y0, int(std::ceil( std::min( {a[1], b[1], c[1]}) - 0.5f)));
+            const int ymax = std::min( y1, int(std::floor( std::max( {a[1], b[1], c[1]}) - 0.5f)));
+            const int xmin = std::max( 0, int(std::ceil( std::min( {a[0], b[0], c[0]}) - 0.5f)));
+            const int xmax = std::min( _w-1, int(std::floor( std::max( {a[0], b[0], c[0]}) - 0.5f)));
+            if ( ymin > ymax || xmin > xmax)
+                continue;
+
+            const float area = edge( a, b, c[0], c[1]);
+            if ( area == 0.0f)
+                continue;
+            const float iarea = 1.0f / area;
+
+            for ( int y = ymin; y <= ymax; ++y)
+            {
+                const float py = y + 0.5f;
+                for ( int x = xmin; x <= xmax; ++x)
+                {
+                    const float px = x + 0.5f;
+                    const float wa = edge( b, c, px, py) * iarea;
+                    const float wb = edge( c, a, px, py) * iarea;
+                    const float wc = 1.0f - wa - wb;
+                    if ( wa < 0.0f || wb < 0.0f || wc < 0.0f)
+                        continue;
+                    const float z = wa*a[2] + wb*b[2] + wc*c[2];    // NDC depth is affine in screen space
+                    if ( z < -1.0f || z > 1.0f)
+                        continue;
+                    float &d = depth[size_t(y - y0) * _w + x];
+                    if ( z < d)
+                    {
+                        d = z;
+                        _fids[size_t(y) * _w + x] = fid;
+                    }   // end if
+                }   // end for
+            }   // end for
+        }   // end for
+    }, 16);
+}   // end _rasterise
+
+
+Vec2f PickBuffer::_toDevice( const QPoint &p) const
+{
+    return Vec2f( (p.x() + 0.5f) * _dpr, (p.y() + 0.5f) * _dpr);
+}   // end _toDevice
+
+
+int PickBuffer::faceId( const QPoint &p) const
+{
+    const Vec2f d = _toDevice(p);
+    const int x = int(std::floor( d[0]));
+    const int y = int(std::floor( d[1]));
+    if ( x < 0 || y < 0 || x >= _w || y >= _h)
+        return -1;
+    return _fids[size_t(y) * _w + x];
+}   // end faceId
+
+
+bool PickBuffer::_project( const QPoint &p, int &fid, Vec3f &x) const
+{
+    fid = faceId(p);
+    if ( fid < 0)
+        return false;
+
+    // Unproject the ray through the (logical) pixel's centre to untransformed mesh coordinates
+    const Vec2f d = _toDevice(p);
+    const float nx = 2.0f * d[0] / _w - 1.0f;
+    const float ny = 1.0f - 2.0f * d[1] / _h;
+    const Vec3f p0 = (_indc * Vec4f( nx, ny, -1, 1)).hnormalized();
+    const Vec3f dv = (_indc * Vec4f( nx, ny, 1, 1)).hnormalized() - p0;
+
+    const int *vidxs = _mesh->fvidxs(fid);
+    const Vec3f &v0 = _mesh->uvtx(vidxs[0]);
+    const Vec3f &v1 = _mesh->uvtx(vidxs[1]);
+    const Vec3f &v2 = _mesh->uvtx(vidxs[2]);
+    const Vec3f n = (v1 - v0).cross(v2 - v0);
+    const float nd = n.dot(dv);
+    if ( nd != 0.0f)
+        x = p0 + (n.dot(v0 - p0) / nd) * dv;
+    else
+        x = (v0 + v1 + v2) / 3;
+    return true;
+}   // end _project
+
+
+bool PickBuffer::barycentric( const QPoint &p, int &fid, Vec3f &bary) const
+{
+    Vec3f x;
+    if ( !_project( p, fid, x))
+        return false;
+
+    const int *vidxs = _mesh->fvidxs(fid);
+    const Vec3f &v0 = _mesh->uvtx(vidxs[0]);
+    const Vec3f &v1 = _mesh->uvtx(vidxs[1]);
+    const Vec3f &v2 = _mesh->uvtx(vidxs[2]);
+    const Vec3f n = (v1 - v0).cross(v2 - v0);
+    const float nn = n.squaredNorm();
+    if ( nn == 0.0f)
+    {
+        bary = Vec3f::Constant( 1.0f/3);
+        return true;
+    }   // end if
+
+    bary[1] = n.dot( (x - v0).cross(v2 - v0)) / nn;
+    bary[2] = n.dot( (v1 - v0).cross(x - v0)) / nn;
+    bary[0] = 1.0f - bary[1] - bary[2];
+
+    // Pixel centres on a face's boundary can project fractionally outside it
+    bary = bary.cwiseMax(0.0f);
+    bary /= bary.sum();
+    return true;
+}   // end barycentric
+
+
+bool PickBuffer::surfacePosition( const QPoint &p, Vec3f &pos) const
+{
+    int fid;
+    Vec3f bary;
+    if ( !barycentric( p, fid, bary))
+        return false;
+    const int *vidxs = _mesh->fvidxs(fid);
+    const Vec3f x = bary[0] * _mesh->uvtx(vidxs[0]) + bary[1] * _mesh->uvtx(vidxs[1]) + bary[2] * _mesh->uvtx(vidxs[2]);
+    pos = (_toWorld * x.homogeneous()).head<3>();
+    return true;
+}   // end surfacePosition
@@ -0,0 +1,382 @@
+/************************************************************************
+ * Copyright (C) 2022 SIS Research Ltd & Richard Palmer
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ ************************************************************************/
+
+#include <Vis/SphereGlyphView.h>
+#include <r3dvis/VtkTools.h>
+#include <vtkGlyph3DMapper.h>
+#include <vtkLabeledDataMapper.h>
+#include <vtkTextProperty.h>
+#include <vtkPointData.h>
+#include <vtkCamera.h>
+#include <vtkPoints.h>
+#include <vtkCommand.h>
+#include <vtkNew.h>
+#include <algorithm>
+#include <climits>
+#include <cassert>
+using FaceTools::Vis::SphereGlyphView;
+using FaceTools::ModelViewer;
+using FaceTools::Vec3f;
+using FaceTools::Mat4f;
+
+namespace {
+// Camera distance at which fixed scale spheres are shown at their given radius
+// (the default camera range of ModelViewer).
+const double REF_DIST = 650.0;
+
+// Proportion of a sphere's radius its front may be behind the picked surface and still be
+// counted as visible (allows for the imprecision of the picked depth).
+const float OCCLUSION_TOLERANCE = 0.25f;
+}   // end namespace
+
+
+SphereGlyphView::SphereGlyphView( double r, int res, bool fixed)
+    : _vwr(nullptr), _visible(false), _radius(r), _fixedScale(fixed), _tmat( Mat4f::Identity()),
+      _ren(nullptr), _obsId(0), _alpha(255)
+{
+    _source = vtkSmartPointer<vtkSphereSource>::New();
+    _source->SetRadius(r);
+    res = std::max<int>( res, 8);
+    _source->SetPhiResolution( res);
+    _source->SetThetaResolution( int(float(res+1)/2));
+
+    _cols = vtkSmartPointer<vtkUnsignedCharArray>::New();
+    _cols->SetName("Colours");
+    _cols->SetNumberOfComponents(4);
+    _mask = vtkSmartPointer<vtkBitArray>::New();
+    _mask->SetName("Mask");
+    _scales = vtkSmartPointer<vtkFloatArray>::New();
+    _scales->SetName("Scales");
+
+    _pdata = vtkSmartPointer<vtkPolyData>::New();
+    _pdata->SetPoints( vtkSmartPointer<vtkPoints>::New());
+    _pdata->GetPointData()->AddArray( _cols);
+    _pdata->GetPointData()->AddArray( _mask);
+    _pdata->GetPointData()->AddArray( _scales);
+
+    vtkNew<vtkGlyph3DMapper> mapper;
+    mapper->SetInputData( _pdata);
+    mapper->SetSourceConnection( _source->GetOutputPort());
+    mapper->OrientOff();
+    mapper->SetScalarModeToUsePointFieldData();
+    mapper->SelectColorArray( "Colours");
+    mapper->SetColorModeToDirectScalars();
+    mapper->ScalarVisibilityOn();
+    mapper->SetMasking( true);
+    mapper->SetMaskArray( "Mask");
+    mapper->SetScaling( true);
+    mapper->SetScaleModeToScaleByMagnitude();
+    mapper->SetScaleArray( "Scales");
+
+    _actor = vtkSmartPointer<vtkActor>::New();
+    _actor->SetMapper( mapper);
+
+    _ltext = vtkSmartPointer<vtkStringArray>::New();
+    _ltext->SetName("Labels");
+    _lpdata = vtkSmartPointer<vtkPolyData>::New();
+    _lpdata->SetPoints( vtkSmartPointer<vtkPoints>::New());
+    _lpdata->GetPointData()->AddArray( _ltext);
+
+    vtkNew<vtkLabeledDataMapper> lmapper;
+    lmapper->SetInputData( _lpdata);
+    lmapper->SetLabelModeToLabelFieldData();
+    lmapper->SetFieldDataName( "Labels");
+    vtkTextProperty *tprop = lmapper->GetLabelTextProperty();
+    tprop->BoldOn();
+    tprop->ItalicOff();
+    tprop->ShadowOff();
+    tprop->SetFontFamilyToCourier();
+    tprop->SetFontSize(15);
+    tprop->SetBackgroundOpacity(0.5);
+    tprop->SetJustificationToLeft();
+    tprop->SetVerticalJustificationToCentered();
+
+    _labels = vtkSmartPointer<vtkActor2D>::New();
+    _labels->SetMapper( lmapper);
+    _labels->SetPickable( false);
+    setCaptionColour( Qt::white, Qt::black);
+
+    _scaler = vtkSmartPointer<vtkCallbackCommand>::New();
+    _scaler->SetClientData( this);
+    _scaler->SetCallback( _onStartRender);
+}   // end ctor
+
+
+SphereGlyphView::~SphereGlyphView()
+{
+    setVisible( false, nullptr);
+    setRenderer( nullptr);
+}   // end dtor
+
+
+int SphereGlyphView::add( const Vec3f &c, const std::string &caption)
+{
+    int i;
+    if ( !_free.empty())
+    {
+        i = _free.back();
+        _free.pop_back();
+        _pdata->GetPoints()->SetPoint( i, c[0], c[1], c[2]);
+        _cols->SetTuple4( i, 255, 255, 255, _alpha);
+        _mask->SetValue( i, 1);
+        _scales->SetValue( i, 1.0f);
+    }   // end if
+    else
+    {
+        i = int( _pdata->GetPoints()->InsertNextPoint( c[0], c[1], c[2]));
+        _cols->InsertNextTuple4( 255, 255, 255, _alpha);
+        _mask->InsertNextValue( 1);
+        _scales->InsertNextValue( 1.0f);
+        _captions.resize( i+1);
+        _showCaption.resize( i+1);
+    }   // end else
+
+    _captions[i] = "  " + caption;  // Offset from the sphere
+    _showCaption[i] = false;
+    _pdata->GetPoints()->Modified();
+    _mask->Modified();
+    _updateScales();
+    return i;
+}   // end add
+
+
+void SphereGlyphView::remove( int i)
+{
+    assert( i >= 0 && size_t(i) < size());
+    setInstanceVisible( i, false);
+    _showCaption[i] = false;
+    _updateLabels();
+    _free.push_back(i);
+}   // end remove
+
+
+size_t SphereGlyphView::size() const { return size_t(_pdata->GetNumberOfPoints());}
+
+
+void SphereGlyphView::setCentre( int i, const Vec3f &c)
+{
+    _pdata->GetPoints()->SetPoint( i, c[0], c[1], c[2]);
+    _pdata->GetPoints()->Modified();
+    if ( _showCaption[i])
+        _updateLabels();
+    _updateScales();
+}   // end setCentre
+
+
+Vec3f SphereGlyphView::centre( int i) const
+{
+    double p[3];
+    _pdata->GetPoints()->GetPoint( i, p);
+    return Vec3f( float(p[0]), float(p[1]), float(p[2]));
+}   // end centre
+
+
+void SphereGlyphView::setInstanceVisible( int i, bool v)
+{
+    _mask->SetValue( i, v ? 1 : 0);
+    _mask->Modified();
+    if ( _showCaption[i])
+        _updateLabels();
+}   // end setInstanceVisible
+
+
+bool SphereGlyphView::isInstanceVisible( int i) const { return _mask->GetValue(i) != 0;}
+
+
+void SphereGlyphView::setColour( int i, double r, double g, double b)
+{
+    _cols->SetTuple4( i, 255*r, 255*g, 255*b, _alpha);
+    _cols->Modified();
+}   // end setColour
+
+
+void SphereGlyphView::setColour( double r, double g, double b)
+{
+    const vtkIdType n = _cols->GetNumberOfTuples();
+    for ( vtkIdType i = 0; i < n; ++i)
+        _cols->SetTuple4( i, 255*r, 255*g, 255*b, _alpha);
+    _cols->Modified();
+}   // end setColour
+
+
+void SphereGlyphView::setOpacity( double a)
+{
+    _alpha = static_cast<unsigned char>( 255 * std::min( 1.0, std::max( 0.0, a)));
+    const vtkIdType n = _cols->GetNumberOfTuples();
+    for ( vtkIdType i = 0; i < n; ++i)
+        _cols->SetComponent( i, 3, _alpha);
+    _cols->Modified();
+}   // end setOpacity
+
+
+void SphereGlyphView::showCaption( int i, bool v)
+{
+    if ( _showCaption[i] != v)
+    {
+        _showCaption[i] = v;
+        _updateLabels();
+    }   // end if
+}   // end showCaption
+
+
+void SphereGlyphView::setCaptionColour( const QColor &fg, const QColor &bg)
+{
+    vtkLabeledDataMapper *lmapper = static_cast<vtkLabeledDataMapper*>( _labels->GetMapper());
+    vtkTextProperty *tprop = lmapper->GetLabelTextProperty();
+    tprop->SetColor( fg.redF(), fg.greenF(), fg.blueF());
+    tprop->SetBackgroundColor( bg.redF(), bg.greenF(), bg.blueF());
+}   // end setCaptionColour
+
+
+void SphereGlyphView::setPickable( bool v) { _actor->SetPickable(v);}
+bool SphereGlyphView::pickable() const { return _actor->GetPickable() != 0;}
+
+
+void SphereGlyphView::setRenderer( vtkRenderer *ren)
+{
+    if ( _ren)
+        _ren->RemoveObserver( _obsId);
+    _ren = ren;
+    if ( _ren && _fixedScale)
+        _obsId = _ren->AddObserver( vtkCommand::StartEvent, _scaler);
+    _updateScales();
+}   // end setRenderer
+
+
+int SphereGlyphView::instance( const ModelViewer *vwr, const QPoint &p) const
+{
+    // Instances are all drawn by the one actor so a prop pick can't tell which is at p.
+    // Candidates are rejected if their nearest point to the camera is behind the surface
+    // rendered at p (so landmarks hidden by the face or by other spheres aren't chosen).
+    const r3d::CameraParams cam = vwr->camera();
+    const Vec3f vdir = (cam.focus() - cam.pos()).normalized();
+    const float sdepth = (vwr->project( p) - cam.pos()).dot( vdir);
+
+    int ci = -1;
+    int cd = INT_MAX;
+    const int n = int(size());
+    for ( int i = 0; i < n; ++i)
+    {
+        if ( !isInstanceVisible(i))
+            continue;
+
+        const Vec3f c = r3d::transform( _tmat, centre(i));
+        const float r = float(_radius) * _scales->GetValue(i);
+        if ( (c - cam.pos()).dot( vdir) - r > sdepth + OCCLUSION_TOLERANCE * r)
+            continue;
+
+        const QPoint d = vwr->project( c) - p;
+        const int sd = d.x()*d.x() + d.y()*d.y();
+        if ( sd < cd)
+        {
+            cd = sd;
+            ci = i;
+        }   // end if
+    }   // end for
+    return ci;
+}   // end instance
+
+
+void SphereGlyphView::setVisible( bool v, ModelViewer *vwr)
+{
+    if ( _vwr)
+    {
+        _vwr->remove( _actor);
+        _vwr->remove( _labels);
+    }   // end if
+    setRenderer( nullptr);
+
+    _vwr = vwr;
+    _visible = false;
+
+    if ( v && _vwr)
+    {
+        setRenderer( _vwr->getRenderer());
+        _vwr->add( _actor);
+        _vwr->add( _labels);
+        _visible = true;
+    }   // end if
+}   // end setVisible
+
+
+bool SphereGlyphView::belongs( const vtkProp *prop) const { return prop == _actor;}
+
+
+void SphereGlyphView::pokeTransform( const vtkMatrix4x4 *m)
+{
+    _actor->PokeMatrix( const_cast<vtkMatrix4x4*>(m));
+    _tmat = r3dvis::toEigen( m);
+    _updateLabels();
+}   // end pokeTransform
+
+
+void SphereGlyphView::_updateScales()
+{
+    const vtkIdType n = _scales->GetNumberOfTuples();
+    if ( !_fixedScale || !_ren)
+    {
+        for ( vtkIdType i = 0; i < n; ++i)
+            _scales->SetValue( i, 1.0f);
+    }   // end if
+    else
+    {
+        // Scale each instance by its distance from the camera to keep its size on screen fixed
+        vtkCamera *cam = _ren->GetActiveCamera();
+        if ( cam->GetParallelProjection())
+        {
+            const double s = cam->GetParallelScale() / (REF_DIST * tan( 0.5 * cam->GetViewAngle() * EIGEN_PI / 180));
+            for ( vtkIdType i = 0; i < n; ++i)
+                _scales->SetValue( i, float(s));
+        }   // end if
+        else
+        {
+            double cp[3];
+            cam->GetPosition( cp);
+            const Vec3f cpos( float(cp[0]), float(cp[1]), float(cp[2]));
+            for ( vtkIdType i = 0; i < n; ++i)
+                _scales->SetValue( i, float((r3d::transform( _tmat, centre(int(i))) - cpos).norm() / REF_DIST));
+        }   // end else
+    }   // end else
+    _scales->Modified();
+}   // end _updateScales
+
+
+void SphereGlyphView::_updateLabels()
+{
+    vtkPoints *pts = _lpdata->GetPoints();
+    pts->Reset();
+    _ltext->Reset();
+    const int n = int(size());
+    for ( int i = 0; i < n; ++i)
+    {
+        if ( _showCaption[i] && isInstanceVisible(i))
+        {
+            const Vec3f p = r3d::transform( _tmat, centre(i));
+            pts->InsertNextPoint( p[0], p[1], p[2]);
+            _ltext->InsertNextValue( _captions[i]);
+        }   // end if
+    }   // end for
+    pts->Modified();
+    _ltext->Modified();
+    _lpdata->Modified();
+}   // end _updateLabels
+
+
+void SphereGlyphView::_onStartRender( vtkObject*, unsigned long, void *clientData, void*)
+{
+    static_cast<SphereGlyphView*>(clientData)->_updateScales();
+}   // end _onStartRender
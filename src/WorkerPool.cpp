@@ -0,0 +1,117 @@
+/************************************************************************
+ * Copyright (C) 2021 SIS Research Ltd & Richard Palmer
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ ************************************************************************/
+
+#include <WorkerPool.h>
+#include <QElapsedTimer>
+#include <QRunnable>
+#include <QMutex>
+#include <algorithm>
+using FaceTools::WorkerPool;
+
+
+namespace {
+
+struct QueueWaits
+{
+    size_t count = 0;
+    double total = 0;
+    double max = 0;
+};  // end struct
+
+QMutex _waitsLock;
+QueueWaits _waits[2];
+
+
+class Work : public QRunnable
+{
+public:
+    Work( const std::function<void( const WorkerPool::Token&)> &fn, WorkerPool::Token::Ptr tok, WorkerPool::Priority p)
+        : _fn(fn), _tok(tok), _prio(p)
+    {
+        _queued.start();
+    }   // end ctor
+
+    void run() override
+    {
+        const double msecs = 1e-6 * _queued.nsecsElapsed();
+        _waitsLock.lock();
+        QueueWaits &w = _waits[_prio];
+        w.count++;
+        w.total += msecs;
+        w.max = std::max( w.max, msecs);
+        _waitsLock.unlock();
+        _fn( *_tok);
+    }   // end run
+
+private:
+    const std::function<void( const WorkerPool::Token&)> _fn;
+    const WorkerPool::Token::Ptr _tok;
+    const WorkerPool::Priority _prio;
+    QElapsedTimer _queued;
+};  // end class
+
+}   // end namespace
+
+
+QThreadPool& WorkerPool::_pool()
+{
+    static QThreadPool pool;
+    return pool;
+}   // end _pool
+
+
+WorkerPool::Token::Ptr WorkerPool::run( const std::function<void( const Token&)> &fn, Priority p, Token::Ptr tok)
+{
+    if ( !tok)
+        tok = std::make_shared<Token>();
+    _pool().start( new Work( fn, tok, p), int(p));   // Work is auto deleted
+    return tok;
+}   // end run
+
+
+void WorkerPool::setMaxThreadCount( int n) { _pool().setMaxThreadCount( std::max( 1, n));}
+
+
+int WorkerPool::maxThreadCount() { return _pool().maxThreadCount();}
+
+
+size_t WorkerPool::numStarted( Priority p)
+{
+    QMutexLocker lock( &_waitsLock);
+    return _waits[p].count;
+}   // end numStarted
+
+
+double WorkerPool::meanQueueWait( Priority p)
+{
+    QMutexLocker lock( &_waitsLock);
+    return _waits[p].count > 0 ? _waits[p].total / _waits[p].count : 0.0;
+}   // end meanQueueWait
+
+
+double WorkerPool::maxQueueWait( Priority p)
+{
+    QMutexLocker lock( &_waitsLock);
+    return _waits[p].max;
+}   // end maxQueueWait
+
+
+void WorkerPool::resetQueueWaits()
+{
+    QMutexLocker lock( &_waitsLock);
+    _waits[BACKGROUND] = _waits[USER] = QueueWaits();
+}   // end resetQueueWaits
@@ -0,0 +1,61 @@
+#include <Vis/SphereGlyphView.h>
+#include <vtkRenderWindow.h>
+#include <vtkRenderer.h>
+#include <vtkCamera.h>
+#include <vtkNew.h>
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <random>
+#include <cstdlib>
+
+using FaceTools::Vis::SphereGlyphView;
+using FaceTools::Vec3f;
+
+// Returns the mean frame time in milliseconds rendering n captioned landmark instances.
+double timeFrames( int n, int nframes)
+{
+    vtkNew<vtkRenderWindow> rwin;
+    rwin->SetOffScreenRendering( true);
+    rwin->SetSize( 800, 800);
+    vtkNew<vtkRenderer> ren;
+    rwin->AddRenderer( ren);
+
+    SphereGlyphView glyphs( 1.0, 13, true);
+    std::mt19937 rng(n);
+    std::uniform_real_distribution<float> dist( -80.0f, 80.0f);
+    for ( int i = 0; i < n; ++i)
+    {
+        const int id = glyphs.add( Vec3f( dist(rng), dist(rng), dist(rng)), "L" + std::to_string(i));
+        glyphs.setColour( id, 0.7, 0.2, 0.9);
+        glyphs.showCaption( id, true);
+    }   // end for
+
+    glyphs.setRenderer( ren);
+    ren->AddActor( glyphs.actor());
+    ren->AddActor2D( glyphs.labelsActor());
+    ren->ResetCamera();
+    rwin->Render();    // Warm up
+
+    vtkCamera *cam = ren->GetActiveCamera();
+    const auto t0 = std::chrono::steady_clock::now();
+    for ( int i = 0; i < nframes; ++i)
+    {
+        cam->Azimuth( 2.0);
+        rwin->Render();
+    }   // end for
+    const auto t1 = std::chrono::steady_clock::now();
+
+    glyphs.setRenderer( nullptr);
+    return std::chrono::duration<double, std::milli>( t1 - t0).count() / nframes;
+}   // end timeFrames
+
+
+int main( int argc, char **argv)
+{
+    const int nframes = argc > 1 ? atoi( argv[1]) : 100;
+    std::cout << std::setw(10) << "landmarks" << std::setw(14) << "ms/frame" << std::endl;
+    for ( int n : {10, 30, 100, 300, 1000, 3000})
+        std::cout << std::setw(10) << n << std::setw(14) << std::fixed << std::setprecision(3) << timeFrames( n, nframes) << std::endl;
+    return EXIT_SUCCESS;
+}   // end main
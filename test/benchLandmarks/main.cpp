@@ -0,0 +1,178 @@
+#include <LndMrk/LandmarkSet.h>
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <cmath>
+#include <cstdlib>
+
+using FaceTools::Landmark::LandmarkSet;
+using FaceTools::FaceSide;
+using FaceTools::Vec3f;
+using FaceTools::Mat4f;
+using LMAN = FaceTools::Landmark::LandmarksManager;
+
+static const FaceSide LATS[3] = {FaceTools::LEFT, FaceTools::MID, FaceTools::RIGHT};
+
+// The previous LandmarkSet layout (one hash map per lateral) for comparison.
+struct MapLandmarkSet
+{
+    std::unordered_map<int, Vec3f> lmksL, lmksM, lmksR;
+
+    std::unordered_map<int, Vec3f> &lateral( FaceSide lat)
+    {
+        return lat == FaceTools::LEFT ? lmksL : lat == FaceTools::RIGHT ? lmksR : lmksM;
+    }   // end lateral
+
+    const std::unordered_map<int, Vec3f> &lateral( FaceSide lat) const
+    {
+        return lat == FaceTools::LEFT ? lmksL : lat == FaceTools::RIGHT ? lmksR : lmksM;
+    }   // end lateral
+
+    void set( int id, const Vec3f &v, FaceSide lat)
+    {
+        if ( !LMAN::landmark(id)->isBilateral())
+            lat = FaceTools::MID;
+        lateral(lat)[id] = v;
+    }   // end set
+
+    const Vec3f &pos( int id, FaceSide lat) const
+    {
+        if ( !LMAN::landmark(id)->isBilateral())
+            lat = FaceTools::MID;
+        return lateral(lat).at(id);
+    }   // end pos
+
+    void transform( const Mat4f &t)
+    {
+        for ( FaceSide lat : LATS)
+            for ( auto &p : lateral(lat))
+                p.second = r3d::transform( t, p.second);
+    }   // end transform
+
+    float sqRadius() const
+    {
+        int cnt = 0;
+        Vec3f mean = Vec3f::Zero();
+        for ( int lid : LMAN::medialAlignmentSet())
+        {
+            if ( lmksM.count(lid) > 0)
+            {
+                mean += lmksM.at(lid);
+                cnt++;
+            }   // end if
+        }   // end for
+        if ( cnt > 0)
+            mean /= cnt;
+        float sqDist = 0.0f;
+        for ( FaceSide lat : LATS)
+            for ( const auto &p : lateral(lat))
+                sqDist = std::max( (p.second - mean).squaredNorm(), sqDist);
+        return sqDist;
+    }   // end sqRadius
+};  // end struct
+
+
+using Clock = std::chrono::steady_clock;
+double msecs( const Clock::time_point &t0) { return std::chrono::duration<double, std::milli>( Clock::now() - t0).count();}
+
+
+// Times the same landmark operations over both layouts. Lookups visit every landmark of every
+// model several times as measuring all metrics does, and the sums are compared between layouts.
+template <typename LS>
+void timeOps( std::vector<LS> &sets, const Mat4f &T, double *ms, double *sums)
+{
+    const std::vector<int> ids( LMAN::ids().begin(), LMAN::ids().end());
+
+    Clock::time_point t0 = Clock::now();
+    double sum = 0.0;
+    for ( int k = 0; k < 10; ++k)
+        for ( const LS &lmks : sets)
+            for ( int id : ids)
+                for ( FaceSide lat : LATS)
+                    if ( lat == FaceTools::MID || LMAN::isBilateral(id))
+                        sum += lmks.pos( id, lat)[0];
+    ms[0] = msecs(t0);
+    sums[0] = sum;
+
+    t0 = Clock::now();
+    for ( LS &lmks : sets)
+        lmks.transform(T);
+    ms[1] = msecs(t0);
+
+    t0 = Clock::now();
+    sum = 0.0;
+    for ( const LS &lmks : sets)
+        sum += lmks.sqRadius();
+    ms[2] = msecs(t0);
+    sums[1] = sum;
+}   // end timeOps
+
+
+int main( int argc, char *argv[])
+{
+    if ( argc == 1)
+    {
+        std::cerr << "Pass in landmarks file (and optionally the number of models)" << std::endl;
+        return EXIT_FAILURE;
+    }   // end if
+
+    if ( LMAN::load( argv[1]) <= 0)
+    {
+        std::cerr << "Unable to load landmarks from " << argv[1] << std::endl;
+        return EXIT_FAILURE;
+    }   // end if
+    const int nmodels = argc > 2 ? atoi( argv[2]) : 10000;
+
+    // Make the same random landmarks for each model in both layouts
+    std::mt19937 rng(nmodels);
+    std::uniform_real_distribution<float> dist( -80.0f, 80.0f);
+    std::vector<LandmarkSet> sets( size_t(nmodels));
+    std::vector<MapLandmarkSet> msets( size_t(nmodels));
+    for ( int i = 0; i < nmodels; ++i)
+    {
+        for ( int id : LMAN::ids())
+        {
+            for ( FaceSide lat : LATS)
+            {
+                if ( (lat == FaceTools::MID) == LMAN::isBilateral(id))   // Bilateral landmarks are left and right only
+                    continue;
+                const Vec3f v( dist(rng), dist(rng), dist(rng));
+                sets[size_t(i)].set( id, v, lat);
+                msets[size_t(i)].set( id, v, lat);
+            }   // end for
+        }   // end for
+    }   // end for
+
+    Mat4f T = Mat4f::Identity();
+    T.block<3,3>(0,0) = Eigen::AngleAxisf( 0.3f, Vec3f(0.2f, 1.0f, 0.1f).normalized()).toRotationMatrix();
+    T.block<3,1>(0,3) = Vec3f( 5, -3, 12);
+
+    double ms[3], mms[3], sums[2], msums[2];
+    timeOps( sets, T, ms, sums);
+    timeOps( msets, T, mms, msums);
+
+    // Mean landmarks over all models (only available for the dense layout)
+    Clock::time_point t0 = Clock::now();
+    std::unordered_set<const LandmarkSet*> setPtrs;
+    for ( const LandmarkSet &lmks : sets)
+        setPtrs.insert( &lmks);
+    const LandmarkSet mean( setPtrs);
+    const double meanms = msecs(t0);
+
+    if ( fabs( sums[0] - msums[0]) > 1e-6 * fabs(msums[0]) || fabs( sums[1] - msums[1]) > 1e-4 * fabs(msums[1]))
+    {
+        std::cerr << "Dense and map layouts give different results!" << std::endl;
+        return EXIT_FAILURE;
+    }   // end if
+
+    std::cout << nmodels << " models with " << LMAN::count() << " landmarks (" << mean.size() << " in mean set)" << std::endl;
+    std::cout << std::setw(12) << "op" << std::setw(14) << "dense ms" << std::setw(14) << "map ms" << std::setw(10) << "speedup" << std::endl;
+    const char *names[3] = {"lookups", "transform", "sqRadius"};
+    for ( int i = 0; i < 3; ++i)
+        std::cout << std::setw(12) << names[i] << std::fixed << std::setprecision(2)
+                  << std::setw(14) << ms[i] << std::setw(14) << mms[i] << std::setw(10) << mms[i] / ms[i] << std::endl;
+    std::cout << std::setw(12) << "mean set" << std::setw(14) << meanms << std::endl;
+    return EXIT_SUCCESS;
+}   // end main
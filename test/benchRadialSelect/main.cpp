@@ -0,0 +1,100 @@
+#include <RadialRegion.h>
+#include <r3dio/IOHelpers.h>
+#include <r3d/RegionSelector.h>
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <cstdlib>
+
+using FaceTools::RadialRegion;
+using FaceTools::Vec3f;
+
+// Update the region to the given radius returning the time taken (msecs).
+double timeUpdate( RadialRegion &reg, int cfid, const Vec3f &c, float r)
+{
+    const auto t0 = std::chrono::steady_clock::now();
+    reg.update( cfid, c, r);
+    const auto t1 = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>( t1 - t0).count();
+}   // end timeUpdate
+
+
+// Update the selector to the given radius setting its selected faces in fids and returning the time taken (msecs).
+double timeSelect( r3d::RegionSelector &rsel, int cfid, const Vec3f &c, float r, FaceTools::IntSet &fids)
+{
+    const auto t0 = std::chrono::steady_clock::now();
+    rsel.update( cfid, c, r);
+    fids.clear();
+    rsel.selectedFaces( fids);
+    const auto t1 = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>( t1 - t0).count();
+}   // end timeSelect
+
+
+int main( int argc, char *argv[])
+{
+    if ( argc == 1)
+    {
+        std::cerr << "Pass in model filename" << std::endl;
+        return EXIT_FAILURE;
+    }   // end if
+
+    r3d::Mesh::Ptr mesh = r3dio::loadMesh( argv[1]);
+    if ( !mesh)
+    {
+        std::cerr << "Unable to load " << argv[1] << std::endl;
+        return EXIT_FAILURE;
+    }   // end if
+
+    // Centre on the vertex closest to the mean vertex position
+    Vec3f mean = Vec3f::Zero();
+    for ( int vid : mesh->vtxIds())
+        mean += mesh->vtx(vid);
+    mean /= float(mesh->numVtxs());
+    int cvid = *mesh->vtxIds().begin();
+    for ( int vid : mesh->vtxIds())
+        if ( (mesh->vtx(vid) - mean).squaredNorm() < (mesh->vtx(cvid) - mean).squaredNorm())
+            cvid = vid;
+    const int cfid = *mesh->faces(cvid).begin();
+    const Vec3f c = mesh->vtx(cvid);
+
+    std::cout << argv[1] << ": " << mesh->numFaces() << " faces" << std::endl;
+    std::cout << std::setw(8) << "radius" << std::setw(12) << "faces" << std::setw(10) << "changed"
+              << std::setw(12) << "incr ms" << std::setw(12) << "fresh ms" << std::setw(12) << "r3d ms" << std::endl;
+
+    // Grow then shrink the radius in steps like turning the mouse wheel, comparing
+    // each incremental update against finding the region afresh at that radius and
+    // against the faces selected by r3d::RegionSelector (which RadialRegion replaced).
+    RadialRegion::Ptr reg = RadialRegion::create( *mesh);
+    r3d::RegionSelector::Ptr rsel = r3d::RegionSelector::create( *mesh);
+    FaceTools::IntSet sfids;
+    std::vector<float> radii;
+    for ( float r = 5; r <= 100; r += 5)
+        radii.push_back(r);
+    for ( float r = 95; r >= 5; r -= 5)
+        radii.push_back(r);
+
+    for ( float r : radii)
+    {
+        const double imsecs = timeUpdate( *reg, cfid, c, r);
+        RadialRegion::Ptr freg = RadialRegion::create( *mesh);
+        const double fmsecs = timeUpdate( *freg, cfid, c, r);
+        if ( freg->faces() != reg->faces() || freg->boundaryEdges() != reg->boundaryEdges())
+        {
+            std::cerr << "Incremental and fresh regions differ at radius " << r << "!" << std::endl;
+            return EXIT_FAILURE;
+        }   // end if
+        const double smsecs = timeSelect( *rsel, cfid, c, r, sfids);
+        if ( sfids != reg->faces())
+        {
+            std::cerr << "Region differs from r3d::RegionSelector's at radius " << r << " ("
+                      << reg->faces().size() << " vs " << sfids.size() << " faces)!" << std::endl;
+            return EXIT_FAILURE;
+        }   // end if
+        std::cout << std::setw(8) << r << std::setw(12) << reg->faces().size() << std::setw(10) << reg->numChanged()
+                  << std::setw(12) << std::fixed << std::setprecision(3) << imsecs
+                  << std::setw(12) << fmsecs << std::setw(12) << smsecs << std::endl;
+        std::cout.unsetf( std::ios_base::floatfield);
+    }   // end for
+    return EXIT_SUCCESS;
+}   // end main
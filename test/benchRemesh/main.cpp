@@ -0,0 +1,56 @@
+#include <Action/ActionRemesh.h>
+#include <r3dio/IOHelpers.h>
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <cstdlib>
+
+using FaceTools::Action::ActionRemesh;
+
+// Remesh to the given maximum triangle area returning the number of output faces and setting the time taken (secs).
+size_t timeRemesh( const r3d::Mesh &mesh, float area, bool parallel, double &secs)
+{
+    const auto t0 = std::chrono::steady_clock::now();
+    const r3d::Mesh::Ptr rmesh = ActionRemesh::remesh( mesh, area, parallel);
+    const auto t1 = std::chrono::steady_clock::now();
+    secs = std::chrono::duration<double>( t1 - t0).count();
+    return rmesh->numFaces();
+}   // end timeRemesh
+
+
+int main( int argc, char *argv[])
+{
+    if ( argc == 1)
+    {
+        std::cerr << "Pass in model filename" << std::endl;
+        return EXIT_FAILURE;
+    }   // end if
+
+    r3d::Mesh::Ptr mesh = r3dio::loadMesh( argv[1]);
+    if ( !mesh)
+    {
+        std::cerr << "Unable to load " << argv[1] << std::endl;
+        return EXIT_FAILURE;
+    }   // end if
+
+    std::cout << argv[1] << ": " << mesh->numFaces() << " faces" << std::endl;
+    std::cout << std::setw(8) << "area" << std::setw(12) << "faces"
+              << std::setw(16) << "serial f/s" << std::setw(16) << "parallel f/s" << std::setw(10) << "speedup" << std::endl;
+    for ( float area : {4.0f, 2.0f, 1.0f, 0.5f, 0.25f})
+    {
+        double ssecs, psecs;
+        const size_t snf = timeRemesh( *mesh, area, false, ssecs);
+        const size_t pnf = timeRemesh( *mesh, area, true, psecs);
+        if ( snf != pnf)
+        {
+            std::cerr << "Serial and parallel face counts differ (" << snf << " vs " << pnf << ")!" << std::endl;
+            return EXIT_FAILURE;
+        }   // end if
+        std::cout << std::setw(8) << area << std::setw(12) << pnf
+                  << std::setw(16) << std::fixed << std::setprecision(0) << pnf / ssecs
+                  << std::setw(16) << pnf / psecs
+                  << std::setw(10) << std::setprecision(2) << ssecs / psecs << std::endl;
+        std::cout.unsetf( std::ios_base::floatfield);
+    }   // end for
+    return EXIT_SUCCESS;
+}   // end main
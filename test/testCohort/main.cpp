@@ -0,0 +1,74 @@
+#include <CohortDeviation.h>
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+
+using FaceTools::CohortDeviation;
+
+// Accumulate the cohort from the given 3DF files setting the time taken (secs).
+CohortDeviation::Ptr makeCohort( const QStringList &fnames, bool parallel, double &secs)
+{
+    const auto t0 = std::chrono::steady_clock::now();
+    CohortDeviation::Ptr cd = CohortDeviation::create();
+    cd->addFiles( fnames, parallel);
+    cd->finish();
+    const auto t1 = std::chrono::steady_clock::now();
+    secs = std::chrono::duration<double>( t1 - t0).count();
+    return cd;
+}   // end makeCohort
+
+
+// Accumulates the mean mask and per vertex deviations over the given 3DF files
+// serially and concurrently, checking that both give the same statistics.
+int main( int argc, char *argv[])
+{
+    if ( argc < 3)
+    {
+        std::cerr << "Pass in at least two 3DF filenames" << std::endl;
+        return EXIT_FAILURE;
+    }   // end if
+
+    QStringList fnames;
+    for ( int i = 1; i < argc; ++i)
+        fnames << argv[i];
+
+    double ssecs, psecs;
+    const CohortDeviation::Ptr scd = makeCohort( fnames, false, ssecs);
+    const CohortDeviation::Ptr pcd = makeCohort( fnames, true, psecs);
+    if ( pcd->count() < 2)
+    {
+        std::cerr << "Fewer than two models with matching masks!" << std::endl;
+        return EXIT_FAILURE;
+    }   // end if
+    if ( scd->count() != pcd->count())
+    {
+        std::cerr << "Serial and parallel counts differ (" << scd->count() << " vs " << pcd->count() << ")!" << std::endl;
+        return EXIT_FAILURE;
+    }   // end if
+
+    // Accumulation order differs between threads so allow for rounding
+    const std::vector<float> &ssds = scd->stddevs();
+    const std::vector<float> &psds = pcd->stddevs();
+    float maxsd = 0.0f;
+    double sumsd = 0.0;
+    for ( size_t i = 0; i < psds.size(); ++i)
+    {
+        const float md = (scd->meanMask().uvtx(int(i)) - pcd->meanMask().uvtx(int(i))).norm();
+        if ( md > 1e-3f || fabsf( ssds[i] - psds[i]) > 1e-3f)
+        {
+            std::cerr << "Serial and parallel statistics differ at mask vertex " << i << "!" << std::endl;
+            return EXIT_FAILURE;
+        }   // end if
+        maxsd = std::max( maxsd, psds[i]);
+        sumsd += psds[i];
+    }   // end for
+
+    std::cout << pcd->count() << " of " << fnames.size() << " models over " << psds.size() << " mask vertices" << std::endl;
+    std::cout << std::fixed << std::setprecision(3)
+              << "Mean SD: " << sumsd / psds.size() << "  Max SD: " << maxsd << std::endl
+              << "Serial: " << ssecs << " secs  Parallel: " << psecs << " secs" << std::endl;
+    return EXIT_SUCCESS;
+}   // end main
@@ -0,0 +1,85 @@
+#include <Action/ActionFillHoles.h>
+#include <r3dio/IOHelpers.h>
+#include <r3d/Manifolds.h>
+#include <algorithm>
+#include <iostream>
+#include <array>
+#include <cstdlib>
+
+using FaceTools::Action::ActionFillHoles;
+using Tri = std::array<float,9>;
+
+// Returns the mesh's triangles as vertex positions starting from the least vertex (keeping the winding).
+std::vector<Tri> triangles( const r3d::Mesh &mesh)
+{
+    std::vector<Tri> tris;
+    for ( int fid : mesh.faces())
+    {
+        const int *fvidxs = mesh.fvidxs(fid);
+        std::array<std::array<float,3>,3> vs;
+        for ( int k = 0; k < 3; ++k)
+        {
+            const r3d::Vec3f &v = mesh.uvtx(fvidxs[k]);
+            vs[k] = {v[0], v[1], v[2]};
+        }   // end for
+        std::rotate( vs.begin(), std::min_element( vs.begin(), vs.end()), vs.end());
+        Tri t;
+        for ( int k = 0; k < 9; ++k)
+            t[k] = vs[k/3][k%3];
+        tris.push_back(t);
+    }   // end for
+    std::sort( tris.begin(), tris.end());
+    return tris;
+}   // end triangles
+
+
+// Returns the number of boundaries over all manifolds.
+size_t numBoundaries( const r3d::Manifolds &manfs)
+{
+    size_t n = 0;
+    for ( int i = 0; i < int(manfs.count()); ++i)
+        n += manfs.at(i).boundaries().count();
+    return n;
+}   // end numBoundaries
+
+
+int main( int argc, char *argv[])
+{
+    if ( argc == 1)
+    {
+        std::cerr << "Pass in model filename(s)" << std::endl;
+        return EXIT_FAILURE;
+    }   // end if
+
+    int nfailed = 0;
+    for ( int i = 1; i < argc; ++i)
+    {
+        r3d::Mesh::Ptr mesh = r3dio::loadMesh( argv[i]);
+        if ( !mesh)
+        {
+            std::cerr << "Unable to load " << argv[i] << std::endl;
+            return EXIT_FAILURE;
+        }   // end if
+
+        const r3d::Manifolds::Ptr manfs = r3d::Manifolds::create( *mesh);
+        numBoundaries( *manfs); // Calculate boundaries before filling concurrently
+        const r3d::Mesh::Ptr smesh = ActionFillHoles::fillHoles( *mesh, *manfs, false);
+        const r3d::Mesh::Ptr pmesh = ActionFillHoles::fillHoles( *mesh, *manfs, true);
+
+        const r3d::Manifolds::Ptr smanfs = r3d::Manifolds::create( *smesh);
+        const r3d::Manifolds::Ptr pmanfs = r3d::Manifolds::create( *pmesh);
+        const bool same = smesh->numVtxs() == pmesh->numVtxs()
+                       && smesh->numFaces() == pmesh->numFaces()
+                       && smanfs->count() == pmanfs->count()
+                       && numBoundaries( *smanfs) == numBoundaries( *pmanfs)
+                       && triangles( *smesh) == triangles( *pmesh);
+
+        std::cout << argv[i] << ": " << numBoundaries( *manfs) << " boundaries before filling; "
+                  << numBoundaries( *smanfs) << " serial, " << numBoundaries( *pmanfs) << " parallel; "
+                  << (same ? "SAME" : "DIFFERENT") << std::endl;
+        if ( !same)
+            nfailed++;
+    }   // end for
+
+    return nfailed == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}   // end main
@@ -0,0 +1,78 @@
+#include <Vis/SphereGlyphView.h>
+#include <ModelViewer.h>
+#include <vtkRenderWindow.h>
+#include <QApplication>
+#include <iostream>
+#include <vector>
+#include <cstdlib>
+
+using FaceTools::Vis::SphereGlyphView;
+using FaceTools::ModelViewer;
+using FaceTools::Vec3f;
+
+static const double RADIUS = 10.0;
+static const Vec3f NEAR_CENTRE( 4, 0, 40);  // Overlaps FAR_CENTRE on screen
+static const Vec3f FAR_CENTRE( 0, 0, -40);
+
+
+// Add spheres at the given centres (in order) to a new glyph view in the given viewer
+// and return the instance picked at the projected centre of the sphere at index at.
+int pick( ModelViewer &vwr, const std::vector<Vec3f> &cs, size_t at)
+{
+    SphereGlyphView glyphs( RADIUS, 16);
+    for ( const Vec3f &c : cs)
+        glyphs.add( c);
+    glyphs.setVisible( true, &vwr);
+    vwr.refreshClippingPlanes();
+    vwr.updateRender();
+    qApp->processEvents();
+
+    const QPoint p = vwr.project( cs[at]);
+    int i = -2;
+    if ( vwr.getPointedAt( p) != glyphs.actor())
+        std::cerr << "Glyph actor not pointed at (" << p.x() << "," << p.y() << ")!" << std::endl;
+    else
+        i = glyphs.instance( &vwr, p);
+    glyphs.setVisible( false, &vwr);
+    return i;
+}   // end pick
+
+
+// Check that the instance picked at the given sphere is the expected one.
+bool check( ModelViewer &vwr, const std::vector<Vec3f> &cs, size_t at, int expected, const char *desc)
+{
+    const int i = pick( vwr, cs, at);
+    std::cout << desc << ": picked " << i << " (expected " << expected << ")" << std::endl;
+    return i == expected;
+}   // end check
+
+
+// Renders two overlapping spheres at different depths as glyph instances offscreen and checks
+// that picking at the projected centre of the further (partly hidden) sphere returns the
+// nearer sphere drawn there, whichever order the spheres were added in.
+int main( int argc, char *argv[])
+{
+    if ( qEnvironmentVariableIsEmpty( "QT_QPA_PLATFORM"))
+        qputenv( "QT_QPA_PLATFORM", "offscreen");
+    QApplication app( argc, argv);
+
+    ModelViewer viewer;
+    viewer.getRenderWindow()->SetOffScreenRendering( 1);
+    viewer.setSize( cv::Size( 640, 480));
+    viewer.show();
+    viewer.setCamera( r3d::CameraParams( Vec3f( 0, 0, 300), Vec3f::Zero(), Vec3f( 0, 1, 0), 30.0f));
+
+    bool ok = true;
+    ok &= check( viewer, {FAR_CENTRE}, 0, 0, "Far sphere alone");
+    ok &= check( viewer, {FAR_CENTRE, NEAR_CENTRE}, 0, 1, "At far sphere added first");
+    ok &= check( viewer, {NEAR_CENTRE, FAR_CENTRE}, 1, 0, "At far sphere added last");
+    ok &= check( viewer, {FAR_CENTRE, NEAR_CENTRE}, 1, 1, "At near sphere");
+
+    if ( !ok)
+    {
+        std::cerr << "Picked a sphere hidden behind another!" << std::endl;
+        return EXIT_FAILURE;
+    }   // end if
+
+    return EXIT_SUCCESS;
+}   // end main
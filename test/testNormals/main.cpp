@@ -0,0 +1,61 @@
+#include <NormalConsistency.h>
+#include <r3dio/IOHelpers.h>
+#include <r3d/Manifolds.h>
+#include <iostream>
+#include <cstdlib>
+
+using FaceTools::NormalConsistency;
+
+// Screens the given models for inconsistent normals, checking that the serial and
+// parallel checks agree and that fixing leaves no inconsistencies (unless twisted).
+// Exits with failure if any model has inconsistent normals.
+int main( int argc, char *argv[])
+{
+    if ( argc == 1)
+    {
+        std::cerr << "Pass in model filename(s)" << std::endl;
+        return EXIT_FAILURE;
+    }   // end if
+
+    int nbad = 0;
+    for ( int i = 1; i < argc; ++i)
+    {
+        r3d::Mesh::Ptr mesh = r3dio::loadMesh( argv[i]);
+        if ( !mesh)
+        {
+            std::cerr << "Unable to load " << argv[i] << std::endl;
+            return EXIT_FAILURE;
+        }   // end if
+        if ( !mesh->hasSequentialIds())
+            mesh = mesh->repackedCopy();
+
+        const r3d::Manifolds::Ptr manfs = r3d::Manifolds::create( *mesh);
+        for ( int j = 0; j < int(manfs->count()); ++j)
+            manfs->at(j).boundaries();  // Calculate boundaries before checking concurrently
+        const NormalConsistency snc( *mesh, *manfs, false);
+        const NormalConsistency pnc( *mesh, *manfs, true);
+        if ( snc.inconsistent() != pnc.inconsistent() || snc.twistedFaces() != pnc.twistedFaces())
+        {
+            std::cerr << argv[i] << ": serial and parallel checks differ!" << std::endl;
+            return EXIT_FAILURE;
+        }   // end if
+
+        std::cout << argv[i] << ": " << manfs->count() << " manifolds; "
+                  << pnc.inconsistent().size() << " inconsistent faces; "
+                  << pnc.twisted().size() << " twisted manifolds (" << pnc.twistedFaces().size() << " faces)" << std::endl;
+
+        if ( !pnc.isConsistent())
+        {
+            nbad++;
+            const r3d::Mesh::Ptr fmesh = pnc.fixed();
+            const r3d::Manifolds::Ptr fmanfs = r3d::Manifolds::create( *fmesh);
+            if ( !NormalConsistency( *fmesh, *fmanfs, false).inconsistent().empty())
+            {
+                std::cerr << argv[i] << ": inconsistencies remain after fixing!" << std::endl;
+                return EXIT_FAILURE;
+            }   // end if
+        }   // end if
+    }   // end for
+
+    return nbad > 0 ? EXIT_FAILURE : EXIT_SUCCESS;
+}   // end main
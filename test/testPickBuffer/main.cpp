@@ -0,0 +1,178 @@
+#include <Vis/PickBuffer.h>
+#include <ModelViewer.h>
+#include <r3dio/IOHelpers.h>
+#include <r3dvis/VtkActorCreator.h>
+#include <vtkRenderWindow.h>
+#include <vtkSmartPointer.h>
+#include <vtkActor.h>
+#include <QApplication>
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <cstdlib>
+#include <cmath>
+
+using FaceTools::Vis::PickBuffer;
+using FaceTools::ModelViewer;
+using FaceTools::Vec3f;
+using FaceTools::Mat4f;
+
+// Viewport size in logical (device independent) pixels and the grid spacing to compare at.
+static const int VIEW_W = 640;
+static const int VIEW_H = 480;
+static const int GRID_STEP = 4;
+
+
+// Set the centre and radius of the given mesh's vertices.
+void bounds( const r3d::Mesh &mesh, Vec3f &c, float &r)
+{
+    c = Vec3f::Zero();
+    for ( int vid : mesh.vtxIds())
+        c += mesh.vtx(vid);
+    c /= float(mesh.numVtxs());
+    r = 0.0f;
+    for ( int vid : mesh.vtxIds())
+        r = std::max( r, (mesh.vtx(vid) - c).norm());
+}   // end bounds
+
+
+// Renders the given mesh offscreen in a ModelViewer and checks that the surface positions
+// found from a PickBuffer agree with those from ModelViewer::calcSurfacePosition over a grid
+// of pixels, that the buffer's rows run top to bottom with +Y up the viewport, and that the
+// buffer has the viewport's dimensions in device pixels when the display is scaled (HiDPI).
+// Points are given in logical pixels as the interactors do with mouse coordinates.
+int main( int argc, char *argv[])
+{
+    if ( argc < 2)
+    {
+        std::cerr << "Pass in a mesh filename and optionally the display scale factor (default 2)" << std::endl;
+        return EXIT_FAILURE;
+    }   // end if
+
+    const QByteArray scale = argc > 2 ? QByteArray( argv[2]) : QByteArray( "2");
+    qputenv( "QT_SCALE_FACTOR", scale);
+    if ( qEnvironmentVariableIsEmpty( "QT_QPA_PLATFORM"))
+        qputenv( "QT_QPA_PLATFORM", "offscreen");
+    QApplication app( argc, argv);
+
+    r3d::Mesh::Ptr mesh = r3dio::loadMesh( argv[1]);
+    if ( !mesh)
+    {
+        std::cerr << "Unable to load mesh from " << argv[1] << std::endl;
+        return EXIT_FAILURE;
+    }   // end if
+    if ( !mesh->hasSequentialIds())
+        mesh = mesh->repackedCopy();
+
+    Vec3f c;
+    float rad;
+    bounds( *mesh, c, rad);
+
+    ModelViewer viewer;
+    viewer.getRenderWindow()->SetOffScreenRendering( 1);
+    viewer.setSize( cv::Size( VIEW_W, VIEW_H));
+    viewer.show();
+    vtkSmartPointer<vtkActor> actor = r3dvis::VtkActorCreator::generateActor( *mesh);
+    viewer.add( actor);
+
+    // Look at the mesh from along +Z with +Y up the viewport
+    const float fov = 30.0f;
+    const float dist = 1.2f * rad / tanf( fov * EIGEN_PI/360.0f);
+    viewer.setCamera( r3d::CameraParams( c + Vec3f( 0, 0, dist), c, Vec3f( 0, 1, 0), fov));
+    viewer.updateRender();
+    app.processEvents();
+
+    const int w = int(viewer.getWidth());
+    const int h = int(viewer.getHeight());
+    const int *rsz = viewer.getRenderWindow()->GetSize();
+    const double dpr = viewer.devicePixelRatioF();
+    std::cout << "Scale " << dpr << ": viewport " << w << " x " << h << " pixels, render window "
+              << rsz[0] << " x " << rsz[1] << " pixels" << std::endl;
+
+    const Mat4f ndc = PickBuffer::deviceMatrix( viewer.getRenderer());
+    const PickBuffer::Ptr pbuff = PickBuffer::create( mesh, ndc, Mat4f::Identity(), w, h, float(dpr));
+
+    // The buffer must cover the pixels picked within (device pixels when scaled)
+    if ( pbuff->width() != rsz[0] || pbuff->height() != rsz[1])
+    {
+        std::cerr << "Pick buffer is " << pbuff->width() << " x " << pbuff->height()
+                  << " but the render window is " << rsz[0] << " x " << rsz[1] << "!" << std::endl;
+        return EXIT_FAILURE;
+    }   // end if
+
+    // The viewport's dimensions in logical pixels
+    const int lw = int(std::lround( w / dpr));
+    const int lh = int(std::lround( h / dpr));
+
+    size_t npts = 0;    // Grid points compared
+    size_t nboth = 0;   // Grid points both found to be on the surface
+    size_t ndiff = 0;   // Grid points only one found to be on the surface (expected only at silhouettes)
+    double sumd = 0.0;
+    float maxd = 0.0f;
+    for ( int y = GRID_STEP/2; y < lh; y += GRID_STEP)
+    {
+        for ( int x = GRID_STEP/2; x < lw; x += GRID_STEP)
+        {
+            const QPoint p( x, y);
+            Vec3f bpos, vpos;
+            const bool bhit = pbuff->surfacePosition( p, bpos);
+            const bool vhit = viewer.calcSurfacePosition( actor, p, vpos);
+            npts++;
+            if ( bhit && vhit)
+            {
+                const float d = (bpos - vpos).norm();
+                sumd += d;
+                maxd = std::max( maxd, d);
+                nboth++;
+            }   // end if
+            else if ( bhit != vhit)
+                ndiff++;
+        }   // end for
+    }   // end for
+
+    const double meand = nboth > 0 ? sumd / nboth : 0.0;
+    std::cout << std::fixed << std::setprecision(4)
+              << nboth << " of " << npts << " grid pixels on the surface (" << ndiff << " differ in whether on it)" << std::endl
+              << "Mean distance " << meand << ", max distance " << maxd << " (mesh radius " << rad << ")" << std::endl;
+
+    if ( nboth == 0)
+    {
+        std::cerr << "Mesh not visible!" << std::endl;
+        return EXIT_FAILURE;
+    }   // end if
+
+    if ( ndiff > npts / 50 || meand > 0.005 * rad)
+    {
+        std::cerr << "Pick buffer positions disagree with the viewer's!" << std::endl;
+        return EXIT_FAILURE;
+    }   // end if
+
+    // Pixels above the centre of the viewport must map to positions higher up the mesh,
+    // and the positions must project back to the pixels they were picked at.
+    Vec3f upos, dpos;
+    const QPoint up( lw/2, lh/2 - lh/8);
+    const QPoint dp( lw/2, lh/2 + lh/8);
+    if ( !pbuff->surfacePosition( up, upos) || !pbuff->surfacePosition( dp, dpos))
+    {
+        std::cerr << "Viewport centre column not on the surface!" << std::endl;
+        return EXIT_FAILURE;
+    }   // end if
+
+    if ( upos[1] <= dpos[1])
+    {
+        std::cerr << "Pick buffer is upside down (y=" << up.y() << " maps to " << upos[1]
+                  << " but y=" << dp.y() << " maps to " << dpos[1] << ")!" << std::endl;
+        return EXIT_FAILURE;
+    }   // end if
+
+    const QPoint uq = viewer.project( upos);
+    const QPoint dq = viewer.project( dpos);
+    if ( (uq - up).manhattanLength() > 2 || (dq - dp).manhattanLength() > 2)
+    {
+        std::cerr << "Picked positions don't project back to their pixels ((" << uq.x() << "," << uq.y()
+                  << ") and (" << dq.x() << "," << dq.y() << "))!" << std::endl;
+        return EXIT_FAILURE;
+    }   // end if
+
+    return EXIT_SUCCESS;
+}   // end main
@@ -0,0 +1,178 @@
+#include <Report/ReportBatch.h>
+#include <FaceModel.h>
+#include <r3dio/IOHelpers.h>
+#include <r3dio/PDFGenerator.h>
+#include <QTemporaryDir>
+#include <QTextStream>
+#include <QFile>
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+
+using FaceTools::Report::ReportBatch;
+using FaceTools::Report::Report;
+using FaceTools::FM;
+
+// Seconds each stub pdflatex run takes so overlapping runs are easily seen.
+static const int STUB_SECS = 1;
+
+
+// Write the given text to the given file returning true on success.
+bool writeFile( const QString &fname, const QString &text)
+{
+    QFile file( fname);
+    if ( !file.open( QIODevice::WriteOnly | QIODevice::Text))
+        return false;
+    QTextStream out( &file);
+    out << text;
+    return true;
+}   // end writeFile
+
+
+// Write a stub pdflatex script that logs its start and end times to the given log file
+// and writes a placeholder PDF next to the .tex file it was given (and into the cwd).
+bool writeStubLatex( const QString &fname, const QString &logfile)
+{
+    const QString script = QString(
+            "#!/bin/sh\n"
+            "for a in \"$@\"; do tex=\"$a\"; done\n"
+            "echo \"S $(date +%s%N)\" >> \"%1\"\n"
+            "sleep %2\n"
+            "pdf=\"${tex%.tex}.pdf\"\n"
+            "echo '%PDF-1.4' > \"$pdf\"\n"
+            "echo '%PDF-1.4' > \"$(basename \"$pdf\")\"\n"
+            "echo \"E $(date +%s%N)\" >> \"%1\"\n").arg( logfile).arg( STUB_SECS);
+    if ( !writeFile( fname, script))
+        return false;
+    return QFile::setPermissions( fname, QFile::permissions(fname) | QFile::ExeOwner | QFile::ExeUser);
+}   // end writeStubLatex
+
+
+// Return the most stub runs in progress at once according to the given log file.
+int maxConcurrent( const QString &logfile)
+{
+    QFile file( logfile);
+    if ( !file.open( QIODevice::ReadOnly | QIODevice::Text))
+        return 0;
+
+    std::vector<std::pair<qint64, int> > events;
+    QTextStream in( &file);
+    while ( !in.atEnd())
+    {
+        const QStringList toks = in.readLine().split(' ', Qt::SkipEmptyParts);
+        if ( toks.size() == 2)
+            events.push_back( std::make_pair( toks[1].toLongLong(), toks[0] == "S" ? 1 : -1));
+    }   // end while
+
+    std::sort( events.begin(), events.end());   // Ends sort before starts at equal times
+    int n = 0;
+    int maxn = 0;
+    for ( const auto &e : events)
+    {
+        n += e.second;
+        maxn = std::max( maxn, n);
+    }   // end for
+    return maxn;
+}   // end maxConcurrent
+
+
+// Generates a number of stub reports through ReportBatch with pdflatex replaced by a
+// script that just waits, checking that every PDF is saved and that the PDFs were
+// made concurrently.
+int main( int argc, char *argv[])
+{
+    if ( argc < 2)
+    {
+        std::cerr << "Pass in a mesh filename and optionally the number of reports (default 8)" << std::endl;
+        return EXIT_FAILURE;
+    }   // end if
+
+    const int nreports = argc > 2 ? std::max( atoi(argv[2]), 2) : 8;
+
+    r3d::Mesh::Ptr mesh = r3dio::loadMesh( argv[1]);
+    if ( !mesh)
+    {
+        std::cerr << "Unable to load mesh from " << argv[1] << std::endl;
+        return EXIT_FAILURE;
+    }   // end if
+
+    QTemporaryDir tdir;
+    if ( !tdir.isValid())
+    {
+        std::cerr << "Unable to create temporary directory!" << std::endl;
+        return EXIT_FAILURE;
+    }   // end if
+
+    const QString logfile = tdir.filePath( "latex.log");
+    const QString stubfile = tdir.filePath( "pdflatex");
+    const QString logofile = tdir.filePath( "logo.pdf");
+    const QString luafile = tdir.filePath( "stub.lua");
+    const bool filesOk = writeStubLatex( stubfile, logfile)
+                      && writeFile( logofile, "%PDF-1.4\n")
+                      && writeFile( luafile,
+                            "report = {\n"
+                            "    name = \"Stub\",\n"
+                            "    title = \"Stub Report\",\n"
+                            "    isAvailable = function( fm) return true end,\n"
+                            "    setContent = function( fm)\n"
+                            "        addText( Box( 0.1, 0.1, 0.8, 0.1), \"Stub report content\", true)\n"
+                            "    end\n"
+                            "}\n");
+    if ( !filesOk)
+    {
+        std::cerr << "Unable to write the stub files!" << std::endl;
+        return EXIT_FAILURE;
+    }   // end if
+
+    r3dio::PDFGenerator::pdflatex = stubfile.toStdString();
+    Report::setLogoPath( logofile);
+
+    FM fm( mesh);
+    ReportBatch batch( nreports);
+    for ( int i = 0; i < nreports; ++i)
+    {
+        Report::Ptr report = Report::load( luafile);
+        if ( !report || !batch.add( report, tdir.filePath( QString("report%1.pdf").arg(i)), &fm))
+        {
+            std::cerr << "Unable to set the content of report " << i << "!" << std::endl;
+            return EXIT_FAILURE;
+        }   // end if
+    }   // end for
+
+    const auto t0 = std::chrono::steady_clock::now();
+    const size_t nsaved = batch.generate();
+    const auto t1 = std::chrono::steady_clock::now();
+    const double secs = std::chrono::duration<double>( t1 - t0).count();
+
+    for ( int i = 0; i < nreports; ++i)
+    {
+        if ( !batch.errorMsg(size_t(i)).isEmpty())
+            std::cerr << "Report " << i << ": " << batch.errorMsg(size_t(i)).toStdString() << std::endl;
+        else if ( !QFile::exists( tdir.filePath( QString("report%1.pdf").arg(i))))
+        {
+            std::cerr << "Report " << i << " PDF is missing!" << std::endl;
+            return EXIT_FAILURE;
+        }   // end else if
+    }   // end for
+
+    const int maxc = maxConcurrent( logfile);
+    std::cout << nsaved << " of " << nreports << " reports saved in "
+              << std::fixed << std::setprecision(3) << secs << " secs with at most "
+              << maxc << " generated at once" << std::endl;
+
+    if ( nsaved != size_t(nreports))
+    {
+        std::cerr << "Not all reports were saved!" << std::endl;
+        return EXIT_FAILURE;
+    }   // end if
+
+    if ( maxc < 2)
+    {
+        std::cerr << "Reports were not generated concurrently!" << std::endl;
+        return EXIT_FAILURE;
+    }   // end if
+
+    return EXIT_SUCCESS;
+}   // end main
@@ -0,0 +1,131 @@
+#include <Action/ActionSmooth.h>
+#include <r3dio/IOHelpers.h>
+#include <r3d/Curvature.h>
+#include <r3d/Smoother.h>
+#include <algorithm>
+#include <iostream>
+#include <iomanip>
+#include <cstdlib>
+#include <cmath>
+
+using FaceTools::Action::ActionSmooth;
+using FaceTools::Vec3f;
+
+
+// Returns the mean over all vertices of the distance of each vertex from the
+// centroid of its neighbours along its normal (a measure of surface roughness).
+double roughness( const r3d::Mesh &mesh)
+{
+    double sum = 0.0;
+    size_t n = 0;
+    for ( int vidx : mesh.vtxIds())
+    {
+        const auto &cvs = mesh.cvtxs(vidx);
+        if ( cvs.empty())
+            continue;
+        Vec3f nrm = Vec3f::Zero();
+        for ( int fid : mesh.faces(vidx))
+        {
+            const int *fvidxs = mesh.fvidxs(fid);
+            const Vec3f &v0 = mesh.uvtx(fvidxs[0]);
+            nrm += (mesh.uvtx(fvidxs[1]) - v0).cross( mesh.uvtx(fvidxs[2]) - v0);
+        }   // end for
+        if ( nrm.norm() == 0.0f)
+            continue;
+        nrm.normalize();
+        Vec3f c = Vec3f::Zero();
+        for ( int cv : cvs)
+            c += mesh.uvtx(cv);
+        c /= float(cvs.size());
+        sum += fabsf( (c - mesh.uvtx(vidx)).dot(nrm));
+        n++;
+    }   // end for
+    return n > 0 ? sum / n : 0.0;
+}   // end roughness
+
+
+// Returns the mean distance between corresponding vertices of the given meshes and sets the maximum.
+double meanDistance( const r3d::Mesh &m0, const r3d::Mesh &m1, double &maxd)
+{
+    double sum = 0.0;
+    maxd = 0.0;
+    for ( int vidx : m0.vtxIds())
+    {
+        const double d = (m0.uvtx(vidx) - m1.uvtx(vidx)).norm();
+        sum += d;
+        maxd = std::max( maxd, d);
+    }   // end for
+    return sum / m0.numVtxs();
+}   // end meanDistance
+
+
+// Smooths the given mesh with ActionSmooth::smooth and with r3d::Smoother (as ActionSmooth did
+// before it used its own curvature estimate) using the same curvature threshold and iterations,
+// and checks that both reduce the roughness of the surface by similar amounts and that the
+// vertices of the two results are close relative to how far the vertices were moved.
+int main( int argc, char *argv[])
+{
+    if ( argc < 2)
+    {
+        std::cerr << "Pass in a mesh filename and optionally the max curvature (default 1) and iterations (default 10)" << std::endl;
+        return EXIT_FAILURE;
+    }   // end if
+
+    r3d::Mesh::Ptr mesh = r3dio::loadMesh( argv[1]);
+    if ( !mesh)
+    {
+        std::cerr << "Unable to load mesh from " << argv[1] << std::endl;
+        return EXIT_FAILURE;
+    }   // end if
+    if ( !mesh->hasSequentialIds())
+        mesh = mesh->repackedCopy();
+
+    const double maxc = argc > 2 ? atof( argv[2]) : 1.0;
+    const size_t maxi = argc > 3 ? size_t( atoi( argv[3])) : 10;
+
+    r3d::Mesh::Ptr pmesh = mesh->deepCopy();
+    const size_t its = ActionSmooth::smooth( *pmesh, maxc, maxi);
+
+    r3d::Mesh::Ptr rmesh = mesh->deepCopy();
+    r3d::Curvature::Ptr cmap = r3d::Curvature::create( *mesh);
+    r3d::Smoother( maxc, maxi)( *rmesh, *cmap);
+
+    double pmaxd, rmaxd, maxd;
+    const double pmeand = meanDistance( *mesh, *pmesh, pmaxd);
+    const double rmeand = meanDistance( *mesh, *rmesh, rmaxd);
+    const double meand = meanDistance( *pmesh, *rmesh, maxd);
+    const double r0 = roughness( *mesh);
+    const double pr = roughness( *pmesh);
+    const double rr = roughness( *rmesh);
+
+    std::cout << std::fixed << std::setprecision(5)
+              << argv[1] << ": max curvature " << maxc << ", " << maxi << " iterations (" << its << " done)" << std::endl
+              << "Roughness " << r0 << " before; " << pr << " ActionSmooth; " << rr << " r3d::Smoother" << std::endl
+              << "Moved mean " << pmeand << " (max " << pmaxd << ") ActionSmooth; mean "
+              << rmeand << " (max " << rmaxd << ") r3d::Smoother" << std::endl
+              << "Distance between results mean " << meand << " (max " << maxd << ")" << std::endl;
+
+    if ( pr > r0 || rr > r0)
+    {
+        std::cerr << "Smoothing increased roughness!" << std::endl;
+        return EXIT_FAILURE;
+    }   // end if
+
+    // The reductions in roughness should be within a factor of two of each other
+    const double pdr = r0 - pr;
+    const double rdr = r0 - rr;
+    if ( pdr < 0.5 * rdr || rdr < 0.5 * pdr)
+    {
+        std::cerr << "ActionSmooth and r3d::Smoother reduce roughness by different amounts!" << std::endl;
+        return EXIT_FAILURE;
+    }   // end if
+
+    // And the results should be closer to each other than to the unsmoothed mesh
+    if ( meand > std::max( pmeand, rmeand))
+    {
+        std::cerr << "ActionSmooth and r3d::Smoother results disagree!" << std::endl;
+        return EXIT_FAILURE;
+    }   // end if
+
+    return EXIT_SUCCESS;
+}   // end main